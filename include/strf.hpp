@@ -45,9 +45,19 @@
 //
 #include <strf/detail/output_types/char_ptr.hpp>
 #include <strf/detail/output_types/std_string.hpp>
+#include <strf/detail/output_types/rope.hpp>
+#include <strf/detail/output_types/container.hpp>
+#include <strf/detail/output_types/reusable_buffer.hpp>
+#include <strf/detail/output_types/small_string.hpp>
+#include <strf/detail/output_types/arena.hpp>
 #include <strf/detail/output_types/FILE.hpp>
 #include <strf/detail/output_types/std_streambuf.hpp>
 
+#if defined(__unix__) || defined(__unix) || (defined(__APPLE__) && defined(__MACH__))
+#include <strf/detail/output_types/posix_fd.hpp>
+#include <strf/detail/output_types/mapped_file.hpp>
+#endif
+
 #if defined(_MSC_VER)
 #pragma warning ( pop )
 #endif // defined(_MSC_VER)
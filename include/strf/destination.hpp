@@ -7,9 +7,61 @@
 
 #include <strf/detail/tr_string.hpp>
 #include <strf/facets_pack.hpp>
+#ifndef __CUDA_ARCH__
+#include <atomic>
+#endif
 
 namespace strf {
 
+// Keeps a statistic of the sizes of the content previously written
+// through destination_predicted_size, in order to predict the size
+// of the next one. It is meant to be a static object of a call site.
+// On CUDA devices, it always predicts zero.
+class size_predictor
+{
+public:
+
+    constexpr STRF_HD size_predictor() noexcept = default;
+
+    size_predictor(const size_predictor&) = delete;
+    size_predictor& operator=(const size_predictor&) = delete;
+
+    STRF_HD std::size_t predict() const noexcept
+    {
+#ifndef __CUDA_ARCH__
+        return _prediction.load(std::memory_order_relaxed);
+#else
+        return 0;
+#endif
+    }
+
+    // A size larger than the prediction raises it immediately, with some
+    // margin. A smaller one only lowers it slowly, so that an occasional
+    // short content does not cause a reallocation in the next call.
+    STRF_HD void record(std::size_t size) noexcept
+    {
+#ifndef __CUDA_ARCH__
+        auto p = predict();
+        std::size_t next = ( size > p
+                           ? size + size / 8
+                           : p - (p - size) / 16 );
+        if (next != p) {
+            _prediction.store(next, std::memory_order_relaxed);
+        }
+#else
+        (void) size;
+#endif
+    }
+
+private:
+
+#ifndef __CUDA_ARCH__
+    std::atomic<std::size_t> _prediction{0};
+#else
+    std::size_t _prediction = 0;
+#endif
+};
+
 template < typename OutbufCreator
          , typename FPack = strf::facets_pack<> >
 class destination_with_given_size;
@@ -22,6 +74,10 @@ template < typename OutbufCreator
          , typename FPack = strf::facets_pack<> >
 class destination_no_reserve;
 
+template < typename OutbufCreator
+         , typename FPack = strf::facets_pack<> >
+class destination_predicted_size;
+
 namespace detail {
 
 struct destination_tag {};
@@ -122,6 +178,26 @@ public:
                , std::move(self._fpack) };
     }
 
+    constexpr STRF_HD strf::destination_predicted_size<OutbufCreator, FPack>
+    reserve_predicted(strf::size_predictor& predictor) const &
+    {
+        const auto& self = static_cast<const _destination_type&>(*this);
+        return { strf::detail::destination_tag{}
+               , predictor
+               , self._outbuf_creator
+               , self._fpack };
+    }
+
+    constexpr STRF_HD strf::destination_predicted_size<OutbufCreator, FPack>
+    reserve_predicted(strf::size_predictor& predictor) &&
+    {
+        auto& self = static_cast<_destination_type&>(*this);
+        return { strf::detail::destination_tag{}
+               , predictor
+               , std::move(self._outbuf_creator)
+               , std::move(self._fpack) };
+    }
+
     template <typename ... Args>
     decltype(auto) STRF_HD operator()(const Args& ... args) const &
     {
@@ -229,6 +305,36 @@ inline STRF_HD void finish(strf::rank<1>, OB&)
 {
 }
 
+// The size of the content, as informed by the value returned by finish()
+template <typename T>
+inline STRF_HD auto finish_result_size(strf::rank<2>, const T& r)
+    -> decltype(static_cast<std::size_t>(r.size()))
+{
+    return r.size();
+}
+
+template <typename T>
+inline STRF_HD auto finish_result_size(strf::rank<1>, const T& r)
+    -> decltype(static_cast<std::size_t>(r.count))
+{
+    return r.count;
+}
+
+template <typename T>
+class has_finish_result_size
+{
+    template <typename U>
+    static auto test(const U* r)
+        -> decltype(strf::detail::finish_result_size(strf::rank<2>(), *r), std::true_type());
+
+    template <typename U>
+    static std::false_type test(...);
+
+public:
+
+    static constexpr bool value = decltype(test<T>(nullptr))::value;
+};
+
 }// namespace detail
 
 template < typename OutbufCreator, typename FPack >
@@ -287,6 +393,7 @@ public:
     using _common::tr;
     using _common::reserve_calc;
     using _common::reserve;
+    using _common::reserve_predicted;
 
     constexpr STRF_HD destination_no_reserve& no_reserve() &
     {
@@ -408,6 +515,7 @@ public:
     using _common::tr;
     using _common::reserve_calc;
     using _common::no_reserve;
+    using _common::reserve_predicted;
 
     constexpr STRF_HD destination_with_given_size& reserve(std::size_t size) &
     {
@@ -466,6 +574,147 @@ private:
     FPack _fpack;
 };
 
+// Reserves the size predicted by a size_predictor, and then updates
+// it with the size of the content, when the value returned by the
+// outbuf's finish() function informs it ( through a size() member
+// function or a count data member ). Outbufs whose finish() returns
+// void are not supported, since the predictor would never learn.
+template < typename OutbufCreator, typename FPack >
+class destination_predicted_size
+    : public strf::detail::destination_common
+        < strf::destination_predicted_size
+        , OutbufCreator
+        , FPack
+        , strf::print_preview<false, false> >
+{
+    using _common = strf::detail::destination_common
+        < strf::destination_predicted_size
+        , OutbufCreator
+        , FPack
+        , strf::print_preview<false, false> >;
+
+    template < template <typename, typename> class, class,class, class, class>
+    friend class strf::detail::destination_common;
+
+    using _preview_type = strf::print_preview<false, false>;
+
+public:
+
+    using char_type = typename OutbufCreator::char_type;
+
+    template < typename ... Args
+             , std::enable_if_t
+                 < std::is_constructible<OutbufCreator, Args...>::value
+                 , int > = 0 >
+    constexpr STRF_HD destination_predicted_size
+        ( strf::size_predictor& predictor, Args&&... args )
+        : _predictor(&predictor)
+        , _outbuf_creator(std::forward<Args>(args)...)
+    {
+    }
+
+    template < typename T = OutbufCreator
+             , std::enable_if_t<std::is_copy_constructible<T>::value, int> = 0 >
+    constexpr STRF_HD destination_predicted_size( strf::detail::destination_tag
+                                                , strf::size_predictor& predictor
+                                                , const OutbufCreator& oc
+                                                , const FPack& fp )
+        : _predictor(&predictor)
+        , _outbuf_creator(oc)
+        , _fpack(fp)
+    {
+    }
+
+    constexpr STRF_HD destination_predicted_size( strf::detail::destination_tag
+                                                , strf::size_predictor& predictor
+                                                , OutbufCreator&& oc
+                                                , FPack&& fp )
+        : _predictor(&predictor)
+        , _outbuf_creator(std::move(oc))
+        , _fpack(std::move(fp))
+    {
+    }
+
+    using _common::with;
+    using _common::operator();
+    using _common::tr;
+    using _common::reserve_calc;
+    using _common::reserve;
+    using _common::no_reserve;
+
+    constexpr STRF_HD destination_predicted_size&
+    reserve_predicted(strf::size_predictor& predictor) &
+    {
+        _predictor = &predictor;
+        return *this;
+    }
+    constexpr STRF_HD destination_predicted_size&&
+    reserve_predicted(strf::size_predictor& predictor) &&
+    {
+        _predictor = &predictor;
+        return std::move(*this);
+    }
+
+private:
+
+    template <class, class>
+    friend class destination_predicted_size;
+
+    template < typename OtherFPack
+             , typename ... FPE
+             , typename T = OutbufCreator
+             , typename = std::enable_if_t
+                 < std::is_copy_constructible<T>::value > >
+    constexpr STRF_HD destination_predicted_size
+        ( const destination_predicted_size<OutbufCreator, OtherFPack>& other
+        , detail::destination_tag
+        , FPE&& ... fpe )
+        : _predictor(other._predictor)
+        , _outbuf_creator(other._outbuf_creator)
+        , _fpack(other._fpack, std::forward<FPE>(fpe)...)
+    {
+    }
+
+    template < typename OtherFPack, typename ... FPE >
+    constexpr STRF_HD destination_predicted_size
+        ( destination_predicted_size<OutbufCreator, OtherFPack>&& other
+        , detail::destination_tag
+        , FPE&& ... fpe )
+        : _predictor(other._predictor)
+        , _outbuf_creator(std::move(other._outbuf_creator))
+        , _fpack(std::move(other._fpack), std::forward<FPE>(fpe)...)
+    {
+    }
+
+    template <typename ... Printers>
+    decltype(auto) STRF_HD _write
+        ( const strf::print_preview<false, false>&
+        , const Printers& ... printers) const
+    {
+        decltype(auto) ob = _outbuf_creator.create(_predictor->predict());
+        using _finish_type = decltype(strf::detail::finish(strf::rank<2>(), ob));
+        static_assert( ! std::is_void<_finish_type>::value
+                     , "reserve_predicted requires an outbuf whose finish() "
+                       "returns a value" );
+        static_assert( strf::detail::has_finish_result_size
+                         < std::remove_cv_t<std::remove_reference_t<_finish_type>> >::value
+                     , "reserve_predicted requires an outbuf whose finish() "
+                       "returns a value with a size() member function "
+                       "or a count data member" );
+        strf::detail::write_args(ob, printers...);
+        decltype(auto) result = ob.finish();
+        auto size = strf::detail::finish_result_size(strf::rank<2>(), result);
+        if (size != 0) {
+            _predictor->record(size);
+        }
+        return result;
+    }
+
+    strf::size_predictor* _predictor;
+    OutbufCreator _outbuf_creator;
+    FPack _fpack;
+};
+
 template < typename OutbufCreator, typename FPack >
 class destination_calc_size
     : public strf::detail::destination_common
@@ -522,6 +771,7 @@ public:
     using _common::tr;
     using _common::no_reserve;
     using _common::reserve;
+    using _common::reserve_predicted;
 
     constexpr STRF_HD const destination_calc_size & reserve_calc() const &
     {
@@ -0,0 +1,185 @@
+#ifndef STRF_DETAIL_ASCII_RUN_HPP
+#define STRF_DETAIL_ASCII_RUN_HPP
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+// Helpers that process runs of ASCII characters in bulk: 16 characters
+// per iteration with SSE2, or 8 characters per iteration otherwise.
+// The transcoders use them to skip the per character decoding
+// and encoding while the input is ASCII, and fall back to the
+// scalar code at the first non-ASCII character.
+
+#include <strf/detail/common.hpp>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+#if ! defined(STRF_NO_SIMD) && ! defined(__CUDA_ARCH__)
+#  if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    include <emmintrin.h>
+#    define STRF_ASCII_RUN_SSE2
+#  endif
+#endif
+
+namespace strf {
+
+namespace detail {
+
+#if defined(STRF_ASCII_RUN_SSE2)
+
+inline void ascii_run_store(std::uint8_t* dest, __m128i bytes) noexcept
+{
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dest), bytes);
+}
+
+inline void ascii_run_store(char16_t* dest, __m128i bytes) noexcept
+{
+    const __m128i zero = _mm_setzero_si128();
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dest), _mm_unpacklo_epi8(bytes, zero));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + 8), _mm_unpackhi_epi8(bytes, zero));
+}
+
+inline void ascii_run_store(char32_t* dest, __m128i bytes) noexcept
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i lo = _mm_unpacklo_epi8(bytes, zero);
+    const __m128i hi = _mm_unpackhi_epi8(bytes, zero);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dest), _mm_unpacklo_epi16(lo, zero));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + 4), _mm_unpackhi_epi16(lo, zero));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + 8), _mm_unpacklo_epi16(hi, zero));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + 12), _mm_unpackhi_epi16(hi, zero));
+}
+
+#endif // defined(STRF_ASCII_RUN_SSE2)
+
+#if defined(STRF_ASCII_RUN_SSE2)
+constexpr std::size_t ascii_run_block_size = 16;
+#else
+constexpr std::size_t ascii_run_block_size = 8;
+#endif
+
+// Copies into dest the longest prefix of [src, src + len) that contains
+// only ASCII characters and that is made of whole blocks of
+// ascii_run_block_size characters, converting each byte to DestCharT.
+// Returns the length of that prefix. The remaining characters are left
+// to the caller, so that short runs cost only a single test.
+template <typename DestCharT>
+inline STRF_HD std::size_t copy_ascii_run
+    ( const std::uint8_t* src
+    , std::size_t len
+    , DestCharT* dest ) noexcept
+{
+    std::size_t i = 0;
+
+#if defined(STRF_ASCII_RUN_SSE2)
+
+    for (; i + 16 <= len; i += 16) {
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        if (_mm_movemask_epi8(bytes) != 0) {
+            break;
+        }
+        strf::detail::ascii_run_store(dest + i, bytes);
+    }
+
+#else
+
+    for (; i + 8 <= len; i += 8) {
+        std::uint64_t word;
+        std::memcpy(&word, src + i, 8);
+        if (word & 0x8080808080808080ULL) {
+            break;
+        }
+        for (std::size_t j = 0; j < 8; ++j) {
+            dest[i + j] = static_cast<DestCharT>(src[i + j]);
+        }
+    }
+
+#endif // defined(STRF_ASCII_RUN_SSE2)
+
+    return i;
+}
+
+#if defined(STRF_ASCII_RUN_SSE2)
+
+// Tests whether the 16 code units are ASCII, and if so,
+// narrows them into bytes
+inline bool narrow_ascii_block(const char16_t* src, __m128i& bytes) noexcept
+{
+    const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+    const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 8));
+    const __m128i non_ascii = _mm_and_si128(_mm_or_si128(a, b), _mm_set1_epi16(-0x80));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi16(non_ascii, _mm_setzero_si128())) != 0xFFFF) {
+        return false;
+    }
+    bytes = _mm_packus_epi16(a, b);
+    return true;
+}
+
+inline bool narrow_ascii_block(const char32_t* src, __m128i& bytes) noexcept
+{
+    const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+    const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 4));
+    const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 8));
+    const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 12));
+    const __m128i non_ascii = _mm_and_si128
+        ( _mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d))
+        , _mm_set1_epi32(-0x80) );
+    if (_mm_movemask_epi8(_mm_cmpeq_epi32(non_ascii, _mm_setzero_si128())) != 0xFFFF) {
+        return false;
+    }
+    bytes = _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d));
+    return true;
+}
+
+#endif // defined(STRF_ASCII_RUN_SSE2)
+
+// The inverse of copy_ascii_run: copies into dest the longest prefix of
+// [src, src + len) that contains only ASCII characters and that is made
+// of whole blocks of ascii_run_block_size characters, converting each
+// character to a byte. Returns the length of that prefix.
+template <typename SrcCharT>
+inline STRF_HD std::size_t narrow_ascii_run
+    ( const SrcCharT* src
+    , std::size_t len
+    , std::uint8_t* dest ) noexcept
+{
+    std::size_t i = 0;
+
+#if defined(STRF_ASCII_RUN_SSE2)
+
+    __m128i bytes;
+    for (; i + 16 <= len; i += 16) {
+        if ( ! strf::detail::narrow_ascii_block(src + i, bytes)) {
+            break;
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i), bytes);
+    }
+
+#else
+
+    for (; i + 8 <= len; i += 8) {
+        SrcCharT non_ascii = 0;
+        for (std::size_t j = 0; j < 8; ++j) {
+            non_ascii |= src[i + j];
+        }
+        if (non_ascii >= 0x80) {
+            break;
+        }
+        for (std::size_t j = 0; j < 8; ++j) {
+            dest[i + j] = static_cast<std::uint8_t>(src[i + j]);
+        }
+    }
+
+#endif // defined(STRF_ASCII_RUN_SSE2)
+
+    return i;
+}
+
+} // namespace detail
+
+} // namespace strf
+
+#endif  // STRF_DETAIL_ASCII_RUN_HPP
+
@@ -618,7 +618,10 @@ get_transcoder( strf::encoding<CharIn> src_encoding
 
 namespace detail {
 
-constexpr const std::size_t mini_buffer32_size = 16;
+// Used by decode_encode and decode_encode_size, which are only
+// needed for pairs of encodings without a direct transcoder.
+// Large enough to make the cost of each recycle() negligible
+constexpr const std::size_t mini_buffer32_size = 256;
 
 template <typename CharOut>
 class buffered_encoder: public strf::basic_outbuf<char32_t>
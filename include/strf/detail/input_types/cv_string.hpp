@@ -675,7 +675,7 @@ class cv_printer_maker_with_encoding<CharIn, CharOut, false>
 {
 public:
     template <typename FPack, typename Preview>
-    inline STRF_HD strf::detail::cv_string_printer<CharIn, CharOut> make_printer
+    static inline STRF_HD strf::detail::cv_string_printer<CharIn, CharOut> make_printer
         ( const FPack& fp
         , Preview& preview
         , strf::value_with_format< strf::detail::simple_string_view<CharIn>
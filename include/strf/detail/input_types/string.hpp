@@ -420,7 +420,12 @@ private:
 template<typename CharT>
 STRF_HD void string_printer<CharT>::print_to(strf::basic_outbuf<CharT>& ob) const
 {
-    strf::write(ob, _str, _len);
+    if (_len <= ob.size()) {
+        strf::detail::str_copy_n(ob.pos(), _str, _len);
+        ob.advance(_len);
+    } else {
+        strf::detail::outbuf_write_direct(ob, _str, _len);
+    }
 }
 
 template <typename CharT>
@@ -685,6 +685,7 @@ template <typename CharT>
 STRF_HD void write_digits_big_sep
     ( strf::basic_outbuf<CharT>& ob
     , const strf::encoding<CharT> encoding
+    , const std::uint8_t* first_grp
     , const std::uint8_t* last_grp
     , unsigned char* digits
     , unsigned num_digits
@@ -695,12 +696,30 @@ STRF_HD void write_digits_big_sep
     STRF_ASSERT(sep_size != 1);
     STRF_ASSERT(sep_size == encoding.validate(sep));
 
+    auto grp_it = last_grp;
+    auto n = *grp_it;
+    if (ob.reserve_contiguous(num_digits + (last_grp - first_grp) * sep_size)) {
+        auto pos = ob.pos();
+        while(true) {
+            *pos = *digits;
+            ++pos;
+            ++digits;
+            if (--num_digits == 0) {
+                break;
+            }
+            if (--n == 0) {
+                pos = encoding.encode_char(pos, sep);
+                n = *--grp_it;
+            }
+        }
+        ob.advance_to(pos);
+        return;
+    }
+
     ob.ensure(1);
 
     auto pos = ob.pos();
     auto end = ob.end();
-    auto grp_it = last_grp;
-    auto n = *grp_it;
 
     while(true) {
         *pos = *digits;
@@ -807,7 +826,7 @@ private:
             ( value, dig_end, lc);
 
         strf::detail::write_digits_big_sep
-            ( ob, enc, groups + num_groups - 1, digits, digcount
+            ( ob, enc, groups, groups + num_groups - 1, digits, digcount
             , sep, sep_size );
     }
 }; // class template intdigits_writer
@@ -830,9 +849,20 @@ public:
             strf::put(ob, static_cast<CharT>('0' + value));
             return;
         }
+        UIntT mask = (UIntT)1 << (digcount - 1);
+        if (ob.reserve_contiguous(digcount)) {
+            auto it = ob.pos();
+            do {
+                *it = (CharT)'0' + (0 != (value & mask));
+                ++it;
+                mask = mask >> 1;
+            }
+            while(mask != 0);
+            ob.advance_to(it);
+            return;
+        }
         auto it = ob.pos();
         auto end = ob.end();
-        UIntT mask = (UIntT)1 << (digcount - 1);
         do {
             if (it == end) {
                 ob.advance_to(it);
@@ -881,12 +911,12 @@ public:
             }
             if (sep_size != 1) {
                 write_big_sep( ob, enc, groups + num_groups -1, value, digcount
-                             , sep32, sep_size );
+                             , num_groups, sep32, sep_size );
                 return;
             }
             enc.encode_char(&sep, sep32);
         }
-        write_little_sep(ob, groups + num_groups -1, value, digcount, sep);
+        write_little_sep(ob, groups + num_groups -1, value, digcount, num_groups, sep);
     }
 
 private:
@@ -897,14 +927,33 @@ private:
         , const uint8_t* groups
         , UIntT value
         , unsigned digcount
+        , unsigned num_groups
         , CharT sep )
     {
         auto grp_it = groups;
         auto grp_size = *grp_it;
+        UIntT mask = (UIntT)1 << (digcount - 1);
+        if (ob.reserve_contiguous(digcount + num_groups - 1)) {
+            auto it = ob.pos();
+            while (true) {
+                for(;grp_size != 0; --grp_size) {
+                    *it = (CharT)'0' + (0 != (value & mask));
+                    mask = mask >> 1;
+                    ++it;
+                }
+                if (mask == 0) {
+                    break;
+                }
+                grp_size = * --grp_it;
+                *it = sep;
+                ++it;
+            }
+            ob.advance_to(it);
+            return;
+        }
         ob.ensure(grp_size);
         auto it = ob.pos();
         auto end = ob.end();
-        UIntT mask = (UIntT)1 << (digcount - 1);
 
         while (true) {
             for(;grp_size != 0; --grp_size) {
@@ -935,14 +984,32 @@ private:
         , const std::uint8_t* groups
         , UIntT value
         , unsigned digcount
+        , unsigned num_groups
         , char32_t sep
         , std::size_t sep_size )
     {
         auto grp_it = groups;
         auto grp_size = *grp_it;
+        UIntT mask = (UIntT)1 << (digcount - 1);
+        if (ob.reserve_contiguous(digcount + (num_groups - 1) * sep_size)) {
+            auto it = ob.pos();
+            while (true) {
+                for(;grp_size != 0; --grp_size) {
+                    *it = (CharT)'0' + (0 != (value & mask));
+                    mask = mask >> 1;
+                    ++it;
+                }
+                if (mask == 0) {
+                    break;
+                }
+                grp_size = * --grp_it;
+                it = encoding.encode_char(it, sep);
+            }
+            ob.advance_to(it);
+            return;
+        }
         auto it = ob.pos();
         auto end = ob.end();
-        UIntT mask = (UIntT)1 << (digcount - 1);
 
         while (true) {
             if (it + grp_size > end) {
@@ -7,6 +7,7 @@
 
 #include <cstdio>
 #include <cstring>
+#include <cwchar>
 #include <strf/destination.hpp>
 
 namespace strf {
@@ -14,6 +15,8 @@ namespace strf {
 template <typename CharT>
 class narrow_cfile_writer final: public strf::basic_outbuf_noexcept<CharT>
 {
+    using _underlying_char_t = strf::underlying_outbuf_char_type<sizeof(CharT)>;
+
 public:
 
     explicit STRF_HD narrow_cfile_writer(std::FILE* dest_)
@@ -64,6 +67,29 @@ public:
 #endif
     }
 
+    // Content that does not fit in the buffer is passed directly to
+    // std::fwrite, instead of being copied into it 64 characters at a time
+    STRF_HD void write_direct
+        ( const _underlying_char_t* ustr, std::size_t len ) override
+    {
+#ifdef __CUDA_ARCH__
+        asm("trap;");
+#else
+        auto str = reinterpret_cast<const CharT*>(ustr);
+        if (len <= this->size()) {
+            strf::detail::str_copy_n(this->pos(), str, len);
+            this->advance(len);
+        } else {
+            recycle();
+            if (this->good()) {
+                auto count_inc = std::fwrite(str, sizeof(CharT), len, _dest);
+                _count += count_inc;
+                this->set_good(len == count_inc);
+            }
+        }
+#endif
+    }
+
     struct result
     {
         std::size_t count;
@@ -101,6 +127,179 @@ private:
     CharT _buf[_buf_size];
 };
 
+namespace detail {
+
+inline void lock_cfile(std::FILE* f) noexcept
+{
+#if defined(_WIN32)
+    _lock_file(f);
+#else
+    flockfile(f);
+#endif
+}
+
+inline void unlock_cfile(std::FILE* f) noexcept
+{
+#if defined(_WIN32)
+    _unlock_file(f);
+#else
+    funlockfile(f);
+#endif
+}
+
+// Writes to a FILE whose lock is already held by the calling thread.
+inline std::size_t fwrite_locked_cfile
+    ( const void* ptr, std::size_t size, std::size_t count, std::FILE* f ) noexcept
+{
+#if defined(_WIN32)
+    return _fwrite_nolock(ptr, size, count, f);
+#elif defined(__GLIBC__) && (defined(_GNU_SOURCE) || defined(_DEFAULT_SOURCE))
+    return fwrite_unlocked(ptr, size, count, f);
+#else
+    return std::fwrite(ptr, size, count, f);
+#endif
+}
+
+} // namespace detail
+
+template <typename CharT, std::size_t BufferSize = 4096>
+class locked_cfile_writer final: public strf::basic_outbuf_noexcept<CharT>
+{
+    static_assert( BufferSize >= strf::min_size_after_recycle<CharT>()
+                 , "BufferSize must not be less than min_size_after_recycle" );
+
+    using _underlying_char_t = strf::underlying_outbuf_char_type<sizeof(CharT)>;
+
+public:
+
+    // Content passed to write_direct that does not fit in the remaining
+    // space of the buffer and that has at least this number of characters
+    // is not copied into the buffer: it is passed directly to fwrite.
+    static constexpr std::size_t direct_write_threshold = BufferSize / 4;
+
+    explicit STRF_HD locked_cfile_writer(std::FILE* dest_)
+        : strf::basic_outbuf_noexcept<CharT>(_buf, BufferSize)
+        , _dest(dest_)
+    {
+#ifdef __CUDA_ARCH__
+        // files are not accessible on CUDA devices
+        asm("trap;");
+#else
+        STRF_ASSERT(dest_ != nullptr);
+        strf::detail::lock_cfile(_dest);
+#endif
+    }
+
+    STRF_HD locked_cfile_writer() = delete;
+
+#ifdef STRF_NO_CXX17_COPY_ELISION
+
+    STRF_HD locked_cfile_writer(locked_cfile_writer&&);
+
+#else // defined(STRF_NO_CXX17_COPY_ELISION)
+
+    locked_cfile_writer(const locked_cfile_writer&) = delete;
+    locked_cfile_writer(locked_cfile_writer&&) = delete;
+
+#endif // defined(STRF_NO_CXX17_COPY_ELISION)
+
+    STRF_HD ~locked_cfile_writer()
+    {
+#ifndef __CUDA_ARCH__
+        if (_locked) {
+            strf::detail::unlock_cfile(_dest);
+        }
+#endif
+    }
+
+    STRF_HD void recycle() noexcept override
+    {
+#ifdef __CUDA_ARCH__
+        asm("trap;");
+#else
+        auto p = this->pos();
+        this->set_pos(_buf);
+        if (this->good()) {
+            std::size_t count = p - _buf;
+            auto count_inc = strf::detail::fwrite_locked_cfile
+                (_buf, sizeof(CharT), count, _dest);
+            _count += count_inc;
+            this->set_good(count == count_inc);
+        }
+#endif
+    }
+
+    STRF_HD bool do_reserve_contiguous(std::size_t s) noexcept override
+    {
+        if (s <= BufferSize) {
+            recycle();
+            return this->good();
+        }
+        return false;
+    }
+
+    STRF_HD void write_direct
+        ( const _underlying_char_t* ustr, std::size_t len ) override
+    {
+#ifdef __CUDA_ARCH__
+        asm("trap;");
+#else
+        auto str = reinterpret_cast<const CharT*>(ustr);
+        if (len <= this->size()) {
+            strf::detail::str_copy_n(this->pos(), str, len);
+            this->advance(len);
+        } else if (len < direct_write_threshold || ! this->good()) {
+            strf::detail::outbuf_write_continuation(*this, str, len);
+        } else {
+            recycle();
+            if (this->good()) {
+                auto count_inc = strf::detail::fwrite_locked_cfile
+                    (str, sizeof(CharT), len, _dest);
+                _count += count_inc;
+                this->set_good(len == count_inc);
+            }
+        }
+#endif
+    }
+
+    struct result
+    {
+        std::size_t count;
+        bool success;
+    };
+
+    STRF_HD result finish()
+    {
+#ifdef __CUDA_ARCH__
+        asm("trap;");
+        return {};
+#else
+        bool g = this->good();
+        this->set_good(false);
+        if (g) {
+            std::size_t count = this->pos() - _buf;
+            auto count_inc = strf::detail::fwrite_locked_cfile
+                (_buf, sizeof(CharT), count, _dest);
+            _count += count_inc;
+            g = (count == count_inc);
+        }
+        this->set_pos(_buf);
+        if (_locked) {
+            _locked = false;
+            strf::detail::unlock_cfile(_dest);
+        }
+        return {_count, g};
+#endif
+    }
+
+private:
+
+    std::FILE* _dest;
+    std::size_t _count = 0;
+    bool _locked = true;
+    CharT _buf[BufferSize];
+};
+
 class wide_cfile_writer final: public strf::basic_outbuf_noexcept<wchar_t>
 {
 public:
@@ -140,10 +339,26 @@ public:
         auto p = this->pos();
         this->set_pos(_buf);
         if (this->good()) {
-            for (auto it = _buf; it != p; ++it, ++_count) {
-                if(std::fputwc(*it, _dest) == WEOF) {
-                    this->set_good(false);
-                    break;
+            // Whole null-free runs are written with a single std::fputws
+            // call ( hence the extra element in _buf for the terminator ).
+            // Only null characters go through std::fputwc.
+            *p = L'\0';
+            for (auto it = _buf; it != p; ) {
+                if (*it == L'\0') {
+                    if (std::fputwc(L'\0', _dest) == WEOF) {
+                        this->set_good(false);
+                        break;
+                    }
+                    ++it;
+                    ++_count;
+                } else {
+                    if (std::fputws(it, _dest) < 0) {
+                        this->set_good(false);
+                        break;
+                    }
+                    auto len = std::wcslen(it);
+                    it += len;
+                    _count += len;
                 }
             }
         }
@@ -169,7 +384,7 @@ public:
     std::size_t _count = 0;
     static constexpr std::size_t _buf_size
         = strf::min_size_after_recycle<wchar_t>();
-    wchar_t _buf[_buf_size];
+    wchar_t _buf[_buf_size + 1];
 };
 
 namespace detail {
@@ -199,6 +414,31 @@ private:
     FILE* _file;
 };
 
+template <typename CharT, std::size_t BufferSize>
+class locked_cfile_writer_creator
+{
+public:
+
+    using char_type = CharT;
+    using outbuf_type = strf::locked_cfile_writer<CharT, BufferSize>;
+    using finish_type = typename outbuf_type::result;
+
+    constexpr locked_cfile_writer_creator(FILE* file) noexcept
+        : _file(file)
+    {}
+
+    constexpr locked_cfile_writer_creator
+        (const locked_cfile_writer_creator&) = default;
+
+    outbuf_type create() const
+    {
+        return outbuf_type{_file};
+    }
+
+private:
+    FILE* _file;
+};
+
 class wide_cfile_writer_creator
 {
 public:
@@ -238,6 +478,18 @@ inline auto to(std::FILE* destination)
 #endif
 }
 
+template <typename CharT = char, std::size_t BufferSize = 4096>
+inline auto to_locked(std::FILE* destination)
+{
+#ifndef __CUDA_ARCH__
+    return strf::destination_no_reserve
+        < strf::detail::locked_cfile_writer_creator<CharT, BufferSize> >
+        (destination);
+#else
+    return 0;
+#endif
+}
+
 inline auto wto(std::FILE* destination)
 {
 #ifndef __CUDA_ARCH__
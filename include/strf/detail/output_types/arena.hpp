@@ -0,0 +1,331 @@
+#ifndef STRF_DETAIL_OUTPUT_TYPES_ARENA_HPP
+#define STRF_DETAIL_OUTPUT_TYPES_ARENA_HPP
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <strf/outbuf.hpp>
+#include <strf/destination.hpp>
+#include <strf/detail/output_types/std_string.hpp>
+#include <strf/detail/output_types/reusable_buffer.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+
+namespace strf {
+
+// A monotonic allocator: memory is taken from the current block by
+// bumping a pointer, and is only released all at once, by release()
+// or by the destructor. When the current block is exhausted, a new one
+// is allocated with operator new. Optionally, the first block can be
+// a buffer provided by the caller.
+class bump_arena
+{
+    struct _block_header
+    {
+        _block_header* next;
+    };
+
+public:
+
+    explicit bump_arena(std::size_t block_size = 4096) noexcept
+        : _block_size(block_size)
+    {
+    }
+
+    bump_arena(void* initial_buffer, std::size_t size, std::size_t block_size = 4096) noexcept
+        : _initial_begin(static_cast<char*>(initial_buffer))
+        , _initial_end(static_cast<char*>(initial_buffer) + size)
+        , _cur(_initial_begin)
+        , _end(_initial_end)
+        , _block_size(block_size)
+    {
+    }
+
+    bump_arena(const bump_arena&) = delete;
+    bump_arena& operator=(const bump_arena&) = delete;
+
+    ~bump_arena()
+    {
+        _free_blocks();
+    }
+
+    void* allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t))
+    {
+        char* p = _align(_cur, alignment);
+        if (p == nullptr || p > _end || static_cast<std::size_t>(_end - p) < size) {
+            _new_block(size + alignment);
+            p = _align(_cur, alignment);
+        }
+        _last = p;
+        _cur = p + size;
+        return p;
+    }
+
+    // Allocates at least min_size bytes, but possibly more: it takes all
+    // the remaining space of the current block, whose size is assigned
+    // to obtained_size. Use shrink_last to give back what is not used.
+    void* allocate_at_least
+        ( std::size_t min_size
+        , std::size_t alignment
+        , std::size_t& obtained_size )
+    {
+        char* p = _align(_cur, alignment);
+        if (p == nullptr || p > _end || static_cast<std::size_t>(_end - p) < min_size) {
+            _new_block(min_size + alignment);
+            p = _align(_cur, alignment);
+        }
+        _last = p;
+        _cur = _end;
+        obtained_size = _end - p;
+        return p;
+    }
+
+    // Like allocate_at_least, but for a memory area p, whose first used_size
+    // bytes are preserved. If p is the last area that has been allocated,
+    // it is extended in place when the current block has room for min_size
+    // bytes. Otherwise it moves to a new block, and the previous block is
+    // freed if p was all it contained.
+    void* reallocate_last_at_least
+        ( void* p
+        , std::size_t used_size
+        , std::size_t min_size
+        , std::size_t alignment
+        , std::size_t& obtained_size )
+    {
+        char* pc = static_cast<char*>(p);
+        if (pc == nullptr || pc != _last) {
+            void* q = allocate_at_least(min_size, alignment, obtained_size);
+            if (used_size != 0) {
+                std::memcpy(q, p, used_size);
+            }
+            return q;
+        }
+        if (static_cast<std::size_t>(_end - pc) >= min_size) {
+            _cur = _end;
+            obtained_size = _end - pc;
+            return pc;
+        }
+        _block_header* prev_block = _blocks;
+        bool sole = prev_block != nullptr
+                 && pc == _align(reinterpret_cast<char*>(prev_block) + _header_size(), alignment);
+        _new_block(min_size + alignment);
+        char* q = _align(_cur, alignment);
+        if (used_size != 0) {
+            std::memcpy(q, pc, used_size);
+        }
+        if (sole) {
+            _blocks->next = prev_block->next;
+            ::operator delete(prev_block);
+        }
+        _last = q;
+        _cur = _end;
+        obtained_size = _end - q;
+        return q;
+    }
+
+    // Gives back the end of the memory area p, if it is
+    // the last one that has been allocated.
+    void shrink_last(void* p, std::size_t new_size) noexcept
+    {
+        char* pc = static_cast<char*>(p);
+        if (p != nullptr && p == _last && pc + new_size <= _cur) {
+            _cur = pc + new_size;
+        }
+    }
+
+    // Releases all the memory allocated so far
+    void release() noexcept
+    {
+        _free_blocks();
+        _cur = _initial_begin;
+        _end = _initial_end;
+        _last = nullptr;
+    }
+
+    // Number of bytes left in the current block
+    std::size_t available() const noexcept
+    {
+        return _end - _cur;
+    }
+
+private:
+
+    static char* _align(char* p, std::size_t alignment) noexcept
+    {
+        if (p == nullptr) {
+            return nullptr;
+        }
+        auto addr = reinterpret_cast<std::uintptr_t>(p);
+        auto aligned = (addr + alignment - 1) & ~(static_cast<std::uintptr_t>(alignment) - 1);
+        return p + (aligned - addr);
+    }
+
+    static constexpr std::size_t _header_size() noexcept
+    {
+        return sizeof(std::max_align_t) > sizeof(_block_header)
+             ? sizeof(std::max_align_t)
+             : sizeof(_block_header);
+    }
+
+    void _new_block(std::size_t min_size)
+    {
+        std::size_t size = min_size > _block_size ? min_size : _block_size;
+        char* mem = static_cast<char*>(::operator new(_header_size() + size));
+        auto* header = reinterpret_cast<_block_header*>(mem);
+        header->next = _blocks;
+        _blocks = header;
+        _cur = mem + _header_size();
+        _end = _cur + size;
+    }
+
+    void _free_blocks() noexcept
+    {
+        while (_blocks != nullptr) {
+            auto next = _blocks->next;
+            ::operator delete(_blocks);
+            _blocks = next;
+        }
+    }
+
+    char* _initial_begin = nullptr;
+    char* _initial_end = nullptr;
+    char* _cur = nullptr;
+    char* _end = nullptr;
+    char* _last = nullptr;
+    _block_header* _blocks = nullptr;
+    std::size_t _block_size;
+};
+
+// Writes into memory taken from a bump_arena. The content is written
+// directly in the arena's current block, and is only copied when it
+// does not fit there, to a block at least twice as large. Once
+// finished, the unused space is given back.
+template <typename CharT>
+class basic_arena_writer final: public strf::basic_outbuf<CharT>
+{
+public:
+
+    explicit basic_arena_writer(strf::bump_arena& arena, std::size_t size = 0)
+        : strf::basic_outbuf<CharT>(nullptr, nullptr)
+        , _arena(arena)
+    {
+        // plus one for the termination character
+        std::size_t min_size = size < strf::min_size_after_recycle<CharT>()
+                             ? strf::min_size_after_recycle<CharT>()
+                             : size + 1;
+        std::size_t obtained = 0;
+        void* p = _arena.allocate_at_least
+            ( min_size * sizeof(CharT), alignof(CharT), obtained );
+        _begin = static_cast<CharT*>(p);
+        this->set_pos(_begin);
+        this->set_end(_begin + obtained / sizeof(CharT));
+    }
+
+#if defined(STRF_NO_CXX17_COPY_ELISION)
+
+    basic_arena_writer(basic_arena_writer&&);
+
+#else // defined(STRF_NO_CXX17_COPY_ELISION)
+
+    basic_arena_writer(const basic_arena_writer&) = delete;
+    basic_arena_writer(basic_arena_writer&&) = delete;
+
+#endif // defined(STRF_NO_CXX17_COPY_ELISION)
+
+    void recycle() override
+    {
+        _grow(strf::min_size_after_recycle<CharT>());
+    }
+
+    bool do_reserve_contiguous(std::size_t s) override
+    {
+        _grow(s);
+        return true;
+    }
+
+    // The returned view is valid until the arena releases its memory.
+    // The content is followed by a termination character.
+    strf::transient_string_view<CharT> finish()
+    {
+        if (this->pos() == this->end()) {
+            _grow(1);
+        }
+        std::size_t len = this->pos() - _begin;
+        *this->pos() = CharT();
+        _arena.shrink_last(_begin, (len + 1) * sizeof(CharT));
+        this->set_good(false);
+        this->set_pos(strf::outbuf_garbage_buf<CharT>());
+        this->set_end(strf::outbuf_garbage_buf_end<CharT>());
+        return {_begin, len};
+    }
+
+private:
+
+    void _grow(std::size_t min_increment)
+    {
+        std::size_t used_size = this->pos() - _begin;
+        auto new_size = used_size + (used_size > min_increment ? used_size : min_increment);
+        this->set_good(false);
+        std::size_t obtained = 0;
+        void* p = _arena.reallocate_last_at_least
+            ( _begin, used_size * sizeof(CharT), new_size * sizeof(CharT)
+            , alignof(CharT), obtained );
+        _begin = static_cast<CharT*>(p);
+        this->set_pos(_begin + used_size);
+        this->set_end(_begin + obtained / sizeof(CharT));
+        this->set_good(true);
+    }
+
+    strf::bump_arena& _arena;
+    CharT* _begin = nullptr;
+};
+
+namespace detail {
+
+template <typename CharT>
+class basic_arena_writer_creator
+{
+public:
+
+    using char_type = CharT;
+    using outbuf_type = strf::basic_arena_writer<CharT>;
+    using finish_type = strf::transient_string_view<CharT>;
+
+    explicit basic_arena_writer_creator(strf::bump_arena& arena) noexcept
+        : _arena(arena)
+    {
+    }
+
+    basic_arena_writer_creator(const basic_arena_writer_creator&) = default;
+
+    outbuf_type create() const
+    {
+        return outbuf_type{_arena};
+    }
+    outbuf_type create(std::size_t size) const
+    {
+        return outbuf_type{_arena, size};
+    }
+
+private:
+
+    strf::bump_arena& _arena;
+};
+
+} // namespace detail
+
+template <typename CharT = char>
+inline auto to_arena(strf::bump_arena& arena)
+{
+    return strf::destination_no_reserve
+        < strf::detail::basic_arena_writer_creator<CharT> >
+        (arena);
+}
+
+} // namespace strf
+
+#endif  // STRF_DETAIL_OUTPUT_TYPES_ARENA_HPP
+
@@ -0,0 +1,454 @@
+#ifndef STRF_DETAIL_OUTPUT_TYPES_ASYNC_FD_HPP
+#define STRF_DETAIL_OUTPUT_TYPES_ASYNC_FD_HPP
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <strf/detail/output_types/posix_fd.hpp>
+
+namespace strf {
+
+namespace detail {
+
+struct async_fd_buffer
+{
+    explicit async_fd_buffer(std::size_t capacity_)
+        : data(capacity_ != 0 ? new char[capacity_] : nullptr)
+        , capacity(capacity_)
+    {
+    }
+
+    std::atomic<async_fd_buffer*> next{nullptr};
+    std::unique_ptr<char[]> data;
+    std::size_t capacity;
+    std::size_t size = 0;
+};
+
+// Intrusive multiple-producer single-consumer queue
+// ( Dmitry Vyukov's algorithm ). push() is wait-free.
+class async_fd_buffer_queue
+{
+public:
+
+    async_fd_buffer_queue() noexcept
+        : _head(&_stub)
+        , _tail(&_stub)
+    {
+    }
+
+    async_fd_buffer_queue(const async_fd_buffer_queue&) = delete;
+
+    void push(async_fd_buffer* b) noexcept
+    {
+        b->next.store(nullptr, std::memory_order_relaxed);
+        auto prev = _head.exchange(b, std::memory_order_acq_rel);
+        prev->next.store(b, std::memory_order_release);
+    }
+
+    // Only to be called by the consumer thread.
+    // Returns nullptr if the queue is empty, or if the last pushed
+    // buffer is not completely linked yet.
+    async_fd_buffer* pop() noexcept
+    {
+        auto tail = _tail;
+        auto next = tail->next.load(std::memory_order_acquire);
+        if (tail == &_stub) {
+            if (next == nullptr) {
+                return nullptr;
+            }
+            _tail = next;
+            tail = next;
+            next = next->next.load(std::memory_order_acquire);
+        }
+        if (next != nullptr) {
+            _tail = next;
+            return tail;
+        }
+        if (tail != _head.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        push(&_stub);
+        next = tail->next.load(std::memory_order_acquire);
+        if (next != nullptr) {
+            _tail = next;
+            return tail;
+        }
+        return nullptr;
+    }
+
+private:
+
+    std::atomic<async_fd_buffer*> _head;
+    async_fd_buffer* _tail;
+    async_fd_buffer _stub{0};
+};
+
+// Bounded multiple-producer multiple-consumer queue of buffer pointers
+// ( Dmitry Vyukov's algorithm ). Used as the pool of free buffers.
+class async_fd_buffer_pool
+{
+public:
+
+    explicit async_fd_buffer_pool(std::size_t capacity)
+    {
+        std::size_t cap = 2;
+        while (cap < capacity) {
+            cap *= 2;
+        }
+        _mask = cap - 1;
+        _cells.reset(new cell[cap]);
+        for (std::size_t i = 0; i < cap; ++i) {
+            _cells[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    async_fd_buffer_pool(const async_fd_buffer_pool&) = delete;
+
+    ~async_fd_buffer_pool()
+    {
+        while (auto b = try_pop()) {
+            delete b;
+        }
+    }
+
+    bool try_push(async_fd_buffer* b) noexcept
+    {
+        auto pos = _enqueue_pos.load(std::memory_order_relaxed);
+        for (;;) {
+            auto& c = _cells[pos & _mask];
+            auto seq = c.seq.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(seq - pos);
+            if (diff == 0) {
+                if (_enqueue_pos.compare_exchange_weak
+                       (pos, pos + 1, std::memory_order_relaxed)) {
+                    c.value = b;
+                    c.seq.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = _enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    async_fd_buffer* try_pop() noexcept
+    {
+        auto pos = _dequeue_pos.load(std::memory_order_relaxed);
+        for (;;) {
+            auto& c = _cells[pos & _mask];
+            auto seq = c.seq.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(seq - (pos + 1));
+            if (diff == 0) {
+                if (_dequeue_pos.compare_exchange_weak
+                       (pos, pos + 1, std::memory_order_relaxed)) {
+                    auto b = c.value;
+                    c.seq.store(pos + _mask + 1, std::memory_order_release);
+                    return b;
+                }
+            } else if (diff < 0) {
+                return nullptr;
+            } else {
+                pos = _dequeue_pos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+private:
+
+    struct cell
+    {
+        std::atomic<std::size_t> seq;
+        async_fd_buffer* value;
+    };
+
+    std::unique_ptr<cell[]> _cells;
+    std::size_t _mask;
+    std::atomic<std::size_t> _enqueue_pos{0};
+    std::atomic<std::size_t> _dequeue_pos{0};
+};
+
+} // namespace detail
+
+// Owns a background thread that writes into a file descriptor the
+// buffers filled by async_fd_writer objects. Buffers come from a pool
+// and are returned to it after being written, so that no allocation
+// happens once the pool is warmed up.
+//
+// Content printed in a single call is written contiguously as long as
+// it fits in one buffer. Otherwise, it may be interleaved with the
+// content printed by other threads at the same time.
+class async_fd_sink
+{
+public:
+
+    explicit async_fd_sink
+        ( int fd
+        , std::size_t buffer_size = 8192
+        , std::size_t pool_size = 64 )
+        : _fd(fd)
+        , _buffer_size( buffer_size > strf::min_size_after_recycle<char>()
+                      ? buffer_size
+                      : strf::min_size_after_recycle<char>() )
+        , _pool(pool_size)
+        , _thread([this](){ _consume(); })
+    {
+    }
+
+    async_fd_sink(const async_fd_sink&) = delete;
+    async_fd_sink& operator=(const async_fd_sink&) = delete;
+
+    // Writes everything that has been queued and stops the background
+    // thread. No async_fd_writer of this object shall still be alive.
+    ~async_fd_sink()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop.store(true);
+        }
+        _cv.notify_one();
+        _thread.join();
+    }
+
+    // Blocks until everything that has been queued so far is written.
+    void flush()
+    {
+        auto target = _queued_count.load();
+        std::unique_lock<std::mutex> lock(_mutex);
+        _flush_waiters.fetch_add(1);
+        _flush_cv.wait(lock, [&]{ return _written_count.load() >= target; });
+        _flush_waiters.fetch_sub(1);
+    }
+
+    // Returns false if a write error has occurred.
+    bool good() const noexcept
+    {
+        return _good.load(std::memory_order_acquire);
+    }
+
+    std::size_t bytes_written() const noexcept
+    {
+        return _bytes_written.load(std::memory_order_acquire);
+    }
+
+    strf::detail::async_fd_buffer* acquire_buffer()
+    {
+        auto b = _pool.try_pop();
+        if (b == nullptr) {
+            b = new strf::detail::async_fd_buffer(_buffer_size);
+        }
+        b->size = 0;
+        return b;
+    }
+
+    void release_buffer(strf::detail::async_fd_buffer* b) noexcept
+    {
+        if ( ! _pool.try_push(b)) {
+            delete b;
+        }
+    }
+
+    void publish(strf::detail::async_fd_buffer* b) noexcept
+    {
+        _queue.push(b);
+        // _queued_count and _consumer_sleeping are accessed with sequentially
+        // consistent operations, so that either the consumer sees the new
+        // count before going to sleep, or this thread sees that it sleeps.
+        // Locking the mutex before notifying ensures that the consumer is
+        // already waiting, and hence that the notification is not lost.
+        _queued_count.fetch_add(1);
+        if (_consumer_sleeping.load()) {
+            { std::lock_guard<std::mutex> lock(_mutex); }
+            _cv.notify_one();
+        }
+    }
+
+private:
+
+    void _consume()
+    {
+        std::size_t popped_count = 0;
+        for (;;) {
+            auto b = _queue.pop();
+            if (b != nullptr) {
+                ++popped_count;
+                if (_good.load(std::memory_order_relaxed)) {
+                    std::size_t written = 0;
+                    ::iovec iov[1] = {{b->data.get(), b->size}};
+                    if ( ! strf::detail::posix_writev_all(_fd, iov, 1, written)) {
+                        _good.store(false, std::memory_order_release);
+                    }
+                    _bytes_written.fetch_add(written, std::memory_order_acq_rel);
+                }
+                release_buffer(b);
+                _written_count.fetch_add(1);
+                if (_flush_waiters.load() != 0) {
+                    { std::lock_guard<std::mutex> lock(_mutex); }
+                    _flush_cv.notify_all();
+                }
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(_mutex);
+            if (_stop.load() && popped_count == _queued_count.load()) {
+                return;
+            }
+            // When the count is ahead of popped_count while pop() failed,
+            // a producer is still linking a buffer, and this loop retries
+            // without sleeping.
+            _consumer_sleeping.store(true);
+            _cv.wait(lock, [&]{ return _stop.load() || _queued_count.load() != popped_count; });
+            _consumer_sleeping.store(false);
+        }
+    }
+
+    int _fd;
+    std::size_t _buffer_size;
+    strf::detail::async_fd_buffer_pool _pool;
+    strf::detail::async_fd_buffer_queue _queue;
+    std::atomic<bool> _good{true};
+    std::atomic<bool> _stop{false};
+    std::atomic<bool> _consumer_sleeping{false};
+    std::atomic<std::size_t> _queued_count{0};
+    std::atomic<std::size_t> _written_count{0};
+    std::atomic<std::size_t> _bytes_written{0};
+    std::atomic<unsigned> _flush_waiters{0};
+    std::mutex _mutex;
+    std::condition_variable _cv;
+    std::condition_variable _flush_cv;
+    std::thread _thread;
+};
+
+class async_fd_writer final: public strf::basic_outbuf<char>
+{
+public:
+
+    explicit async_fd_writer(strf::async_fd_sink& sink)
+        : strf::basic_outbuf<char>(nullptr, nullptr)
+        , _sink(sink)
+        , _buffer(sink.acquire_buffer())
+    {
+        this->set_pos(_buffer->data.get());
+        this->set_end(_buffer->data.get() + _buffer->capacity);
+    }
+
+    async_fd_writer() = delete;
+
+#ifdef STRF_NO_CXX17_COPY_ELISION
+
+    async_fd_writer(async_fd_writer&&);
+
+#else // defined(STRF_NO_CXX17_COPY_ELISION)
+
+    async_fd_writer(const async_fd_writer&) = delete;
+    async_fd_writer(async_fd_writer&&) = delete;
+
+#endif // defined(STRF_NO_CXX17_COPY_ELISION)
+
+    ~async_fd_writer()
+    {
+        if (_buffer != nullptr) {
+            _sink.release_buffer(_buffer);
+        }
+    }
+
+    void recycle() override
+    {
+        if (_buffer != nullptr) {
+            _buffer->size = this->pos() - _buffer->data.get();
+            if (_buffer->size == 0) {
+                this->set_pos(_buffer->data.get());
+                return;
+            }
+            auto full = _buffer;
+            _buffer = nullptr;
+            _sink.publish(full);
+            // The published buffer must not be written anymore,
+            // even if acquire_buffer() throws
+            this->set_good(false);
+            this->set_pos(strf::outbuf_garbage_buf<char>());
+            this->set_end(strf::outbuf_garbage_buf_end<char>());
+        }
+        _buffer = _sink.acquire_buffer();
+        this->set_good(true);
+        this->set_pos(_buffer->data.get());
+        this->set_end(_buffer->data.get() + _buffer->capacity);
+    }
+
+    bool do_reserve_contiguous(std::size_t s) override
+    {
+        if (_buffer != nullptr && s <= _buffer->capacity) {
+            recycle();
+            return true;
+        }
+        return false;
+    }
+
+    void finish()
+    {
+        if (_buffer == nullptr) {
+            return;
+        }
+        _buffer->size = this->pos() - _buffer->data.get();
+        auto b = _buffer;
+        _buffer = nullptr;
+        this->set_good(false);
+        this->set_pos(strf::outbuf_garbage_buf<char>());
+        this->set_end(strf::outbuf_garbage_buf_end<char>());
+        if (b->size != 0) {
+            _sink.publish(b);
+        } else {
+            _sink.release_buffer(b);
+        }
+    }
+
+private:
+
+    strf::async_fd_sink& _sink;
+    strf::detail::async_fd_buffer* _buffer;
+};
+
+namespace detail {
+
+class async_fd_writer_creator
+{
+public:
+
+    using char_type = char;
+    using outbuf_type = strf::async_fd_writer;
+    using finish_type = void;
+
+    constexpr async_fd_writer_creator(strf::async_fd_sink& sink) noexcept
+        : _sink(sink)
+    {}
+
+    constexpr async_fd_writer_creator(const async_fd_writer_creator&) = default;
+
+    outbuf_type create() const
+    {
+        return outbuf_type{_sink};
+    }
+
+private:
+
+    strf::async_fd_sink& _sink;
+};
+
+} // namespace detail
+
+inline auto to(strf::async_fd_sink& sink)
+{
+    return strf::destination_no_reserve<strf::detail::async_fd_writer_creator>
+        (sink);
+}
+
+} // namespace strf
+
+#endif  // STRF_DETAIL_OUTPUT_TYPES_ASYNC_FD_HPP
+
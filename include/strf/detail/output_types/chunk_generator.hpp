@@ -0,0 +1,416 @@
+#ifndef STRF_DETAIL_OUTPUT_TYPES_CHUNK_GENERATOR_HPP
+#define STRF_DETAIL_OUTPUT_TYPES_CHUNK_GENERATOR_HPP
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+// This header requires C++20 coroutines, and is therefore
+// not included by <strf.hpp>.
+
+#include <strf/outbuf.hpp>
+#include <strf/destination.hpp>
+#include <strf/detail/output_types/reusable_buffer.hpp>
+#include <strf/detail/input_types/string.hpp>
+#include <strf/detail/input_types/range.hpp>
+#include <strf/detail/input_types/join.hpp>
+#include <coroutine>
+#include <exception>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+namespace strf {
+
+// A coroutine that runs a print and yields its content in chunks. Nothing
+// is printed before the first call to next() ( or to begin() ), and each
+// further call resumes the print until the next chunk is available.
+template <typename CharT>
+class basic_chunk_generator
+{
+public:
+
+    struct promise_type
+    {
+        const CharT* chunk_ptr = nullptr;
+        std::size_t chunk_len = 0;
+        std::exception_ptr exception;
+
+        basic_chunk_generator get_return_object() noexcept
+        {
+            return basic_chunk_generator{_handle::from_promise(*this)};
+        }
+        std::suspend_always initial_suspend() const noexcept
+        {
+            return {};
+        }
+        std::suspend_always final_suspend() const noexcept
+        {
+            return {};
+        }
+        std::suspend_always yield_value(strf::transient_string_view<CharT> c) noexcept
+        {
+            chunk_ptr = c.begin();
+            chunk_len = c.size();
+            return {};
+        }
+        void return_void() const noexcept
+        {
+        }
+        void unhandled_exception() noexcept
+        {
+            exception = std::current_exception();
+        }
+    };
+
+    class iterator
+    {
+    public:
+
+        using iterator_category = std::input_iterator_tag;
+        using value_type = strf::transient_string_view<CharT>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = value_type;
+
+        iterator() noexcept = default;
+
+        value_type operator*() const noexcept
+        {
+            return _gen->chunk();
+        }
+        iterator& operator++()
+        {
+            if ( ! _gen->next()) {
+                _gen = nullptr;
+            }
+            return *this;
+        }
+        void operator++(int)
+        {
+            ++*this;
+        }
+        friend bool operator==(const iterator& it, std::default_sentinel_t) noexcept
+        {
+            return it._gen == nullptr;
+        }
+
+    private:
+
+        friend class basic_chunk_generator;
+
+        explicit iterator(basic_chunk_generator* gen) noexcept
+            : _gen(gen)
+        {
+        }
+
+        basic_chunk_generator* _gen = nullptr;
+    };
+
+    basic_chunk_generator(basic_chunk_generator&& other) noexcept
+        : _coro(std::exchange(other._coro, nullptr))
+    {
+    }
+
+    basic_chunk_generator& operator=(basic_chunk_generator&& other) noexcept
+    {
+        if (this != &other) {
+            _destroy();
+            _coro = std::exchange(other._coro, nullptr);
+        }
+        return *this;
+    }
+
+    basic_chunk_generator(const basic_chunk_generator&) = delete;
+    basic_chunk_generator& operator=(const basic_chunk_generator&) = delete;
+
+    ~basic_chunk_generator()
+    {
+        _destroy();
+    }
+
+    // Resumes the print until the next chunk is available.
+    // Returns false when the print is complete. An exception
+    // thrown while printing is propagated here.
+    bool next()
+    {
+        if ( ! _coro || _coro.done()) {
+            return false;
+        }
+        _coro.resume();
+        if (_coro.promise().exception) {
+            std::rethrow_exception(std::exchange(_coro.promise().exception, nullptr));
+        }
+        return ! _coro.done();
+    }
+
+    // The chunk obtained by the last successful call to next().
+    // It is only valid until the next call to next().
+    strf::transient_string_view<CharT> chunk() const noexcept
+    {
+        const auto& p = _coro.promise();
+        return {p.chunk_ptr, p.chunk_len};
+    }
+
+    iterator begin()
+    {
+        return iterator{next() ? this : nullptr};
+    }
+    std::default_sentinel_t end() const noexcept
+    {
+        return {};
+    }
+
+private:
+
+    using _handle = std::coroutine_handle<promise_type>;
+
+    explicit basic_chunk_generator(_handle coro) noexcept
+        : _coro(coro)
+    {
+    }
+
+    void _destroy() noexcept
+    {
+        if (_coro) {
+            _coro.destroy();
+            _coro = nullptr;
+        }
+    }
+
+    _handle _coro;
+};
+
+using chunk_generator = basic_chunk_generator<char>;
+
+namespace detail {
+
+// The outbuf used inside the coroutine. Since recycle() can not
+// suspend the coroutine, it grows the buffer instead. The content
+// is consumed from the front by the coroutine between two arguments.
+template <typename CharT>
+class chunk_writer final: public strf::basic_outbuf<CharT>
+{
+public:
+
+    explicit chunk_writer(std::size_t chunk_size)
+        : strf::basic_outbuf<CharT>(nullptr, nullptr)
+    {
+        std::size_t min_cap = chunk_size < strf::min_size_after_recycle<CharT>()
+                            ? strf::min_size_after_recycle<CharT>()
+                            : chunk_size;
+        strf::detail::grow_reusable_buffer(_buf, 0, 2 * min_cap);
+        this->set_pos(_buf.data.get());
+        this->set_end(_buf.data.get() + _buf.capacity);
+    }
+
+    chunk_writer(const chunk_writer&) = delete;
+    chunk_writer(chunk_writer&&) = delete;
+
+    void recycle() override
+    {
+        std::size_t used_size = this->pos() - _buf.data.get();
+        this->set_good(false);
+        strf::detail::grow_reusable_buffer
+            ( _buf, used_size, strf::min_size_after_recycle<CharT>() );
+        this->set_good(true);
+        this->set_pos(_buf.data.get() + used_size);
+        this->set_end(_buf.data.get() + _buf.capacity);
+    }
+
+    std::size_t pending_size() const noexcept
+    {
+        return this->pos() - _buf.data.get() - _consumed;
+    }
+
+    // Consumes the first size characters of the pending content
+    strf::transient_string_view<CharT> take_front(std::size_t size) noexcept
+    {
+        const CharT* p = _buf.data.get() + _consumed;
+        _consumed += size;
+        return {p, size};
+    }
+
+    // Moves the remaining content to the beginning of the buffer
+    void compact() noexcept
+    {
+        std::size_t pending = pending_size();
+        if (_consumed != 0 && pending != 0) {
+            std::char_traits<CharT>::move
+                (_buf.data.get(), _buf.data.get() + _consumed, pending);
+        }
+        _consumed = 0;
+        this->set_pos(_buf.data.get() + pending);
+    }
+
+private:
+
+    strf::detail::reusable_buffer<CharT> _buf;
+    std::size_t _consumed = 0;
+};
+
+template <typename CharT, typename FPack, typename Arg>
+void write_one_arg
+    ( strf::basic_outbuf<CharT>& ob
+    , const FPack& fp
+    , const Arg& arg )
+{
+    strf::print_preview<false, false> preview;
+    make_printer<CharT, FPack>(strf::rank<5>{}, fp, preview, arg).print_to(ob);
+}
+
+template <typename CharT, typename FPack, typename ... Args>
+void write_nth_arg
+    ( strf::basic_outbuf<CharT>& ob
+    , const FPack& fp
+    , std::size_t n
+    , const Args& ... args )
+{
+    std::size_t i = 0;
+    (..., (i++ == n ? strf::detail::write_one_arg<CharT>(ob, fp, args) : void()));
+}
+
+// Whether an argument type only refers to content that it does not own,
+// and hence can not be safely copied into the coroutine frame
+template <typename T>
+struct chunk_arg_is_view: std::false_type
+{
+};
+
+template <typename ForwardIt>
+struct chunk_arg_is_view<strf::range_p<ForwardIt>>: std::true_type
+{
+};
+
+template <typename ForwardIt, typename CharIn>
+struct chunk_arg_is_view<strf::separated_range_p<ForwardIt, CharIn>>: std::true_type
+{
+};
+
+template <typename ForwardIt, typename UnaryOp>
+struct chunk_arg_is_view<strf::transformed_range_p<ForwardIt, UnaryOp>>: std::true_type
+{
+};
+
+template <typename ForwardIt, typename CharIn, typename UnaryOp>
+struct chunk_arg_is_view
+    < strf::separated_transformed_range_p<ForwardIt, CharIn, UnaryOp> >
+    : std::true_type
+{
+};
+
+// joins may hold references to their arguments
+template <typename ... T>
+struct chunk_arg_is_view<strf::detail::simple_tuple<T...>>: std::true_type
+{
+};
+
+// Format functions convert strings ( even std::basic_string ) into
+// views. A view passed without them is accepted, since it is
+// explicitly a view, like std::basic_string_view.
+template <typename ValueType, typename ... Fmts>
+struct chunk_arg_is_view<strf::value_with_format<ValueType, Fmts...>>
+    : chunk_arg_is_view<ValueType>
+{
+};
+
+template <typename CharIn, typename ... Fmts>
+struct chunk_arg_is_view
+    < strf::value_with_format<strf::detail::simple_string_view<CharIn>, Fmts...> >
+    : std::true_type
+{
+};
+
+// The arguments are taken by value, so that they live in the coroutine frame
+template <typename CharT, typename FPack, typename ... Args>
+strf::basic_chunk_generator<CharT> generate_chunks
+    ( std::size_t chunk_size, FPack fp, Args ... args )
+{
+    strf::detail::chunk_writer<CharT> ob(chunk_size);
+    for (std::size_t i = 0; i < sizeof...(Args); ++i) {
+        strf::detail::write_nth_arg<CharT>(ob, fp, i, args...);
+        if (ob.pending_size() >= chunk_size) {
+            do {
+                co_yield ob.take_front(chunk_size);
+            } while (ob.pending_size() >= chunk_size);
+            ob.compact();
+        }
+    }
+    if (ob.pending_size() != 0) {
+        co_yield ob.take_front(ob.pending_size());
+    }
+}
+
+} // namespace detail
+
+// Unlike the other destinations, this one does not print anything
+// immediately: operator() returns a basic_chunk_generator<CharT>
+// that yields the content in chunks of chunk_size characters
+// ( except the last one, that may be shorter ).
+//
+// The coroutine can only suspend between two arguments. Hence, the
+// memory used is bounded by chunk_size plus the size of the largest
+// argument, instead of the size of the whole content.
+//
+// The arguments are copied into the generator. But only plain values
+// and strings own their content: format functions over strings
+// ( like strf::right(str, 10) or strf::cv(str) ), ranges and joins
+// only refer to it, and are therefore rejected at compile time.
+// Likewise, a const CharT* argument is copied as a pointer.
+template <typename CharT, typename FPack = strf::facets_pack<>>
+class basic_chunks_destination
+{
+public:
+
+    using char_type = CharT;
+
+    explicit constexpr basic_chunks_destination(std::size_t chunk_size)
+        : _chunk_size(chunk_size == 0 ? 1 : chunk_size)
+    {
+    }
+
+    constexpr basic_chunks_destination(std::size_t chunk_size, FPack fp)
+        : _chunk_size(chunk_size == 0 ? 1 : chunk_size)
+        , _fpack(std::move(fp))
+    {
+    }
+
+    template <typename ... FPE>
+    [[nodiscard]] constexpr auto with(FPE&& ... fpe) const
+    {
+        using new_fpack = decltype(strf::pack(_fpack, std::forward<FPE>(fpe)...));
+        return basic_chunks_destination<CharT, new_fpack>
+            { _chunk_size, strf::pack(_fpack, std::forward<FPE>(fpe)...) };
+    }
+
+    // The arguments are copied into the generator. To avoid copying
+    // a large string, pass a string_view to it instead, as long as
+    // the string outlives the generator.
+    template <typename ... Args>
+    [[nodiscard]] strf::basic_chunk_generator<CharT> operator()(const Args& ... args) const
+    {
+        static_assert
+            ( (... && ! strf::detail::chunk_arg_is_view<std::decay_t<Args>>::value)
+            , "to_chunks does not accept arguments that refer to content they "
+              "do not own ( formatted strings, ranges and joins ), since the "
+              "content could be destroyed before the generator is resumed." );
+        return strf::detail::generate_chunks<CharT, FPack, std::decay_t<const Args>...>
+            (_chunk_size, _fpack, args...);
+    }
+
+private:
+
+    std::size_t _chunk_size;
+    FPack _fpack;
+};
+
+template <typename CharT = char>
+constexpr strf::basic_chunks_destination<CharT> to_chunks(std::size_t chunk_size = 4096)
+{
+    return strf::basic_chunks_destination<CharT>{chunk_size};
+}
+
+} // namespace strf
+
+#endif  // STRF_DETAIL_OUTPUT_TYPES_CHUNK_GENERATOR_HPP
+
@@ -0,0 +1,484 @@
+#ifndef STRF_DETAIL_OUTPUT_TYPES_CONTAINER_HPP
+#define STRF_DETAIL_OUTPUT_TYPES_CONTAINER_HPP
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <strf/outbuf.hpp>
+#include <strf/destination.hpp>
+#include <strf/detail/output_types/std_string.hpp>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace strf {
+
+namespace detail {
+
+template <typename T>
+struct container_char_type_impl
+{
+    static_assert( sizeof(T) == 1 && std::is_trivially_copyable<T>::value
+                 , "Container value type must be a character type "
+                   "or a trivially copyable type of size 1" );
+    using type = char;
+};
+
+template <> struct container_char_type_impl<char>     { using type = char; };
+template <> struct container_char_type_impl<char16_t> { using type = char16_t; };
+template <> struct container_char_type_impl<char32_t> { using type = char32_t; };
+template <> struct container_char_type_impl<wchar_t>  { using type = wchar_t; };
+#if defined(__cpp_char8_t)
+template <> struct container_char_type_impl<char8_t>  { using type = char8_t; };
+#endif
+
+// The character type written into a container whose value_type is T.
+// Byte-like types ( unsigned char, std::byte, ... ) are written as char.
+template <typename T>
+using container_char_type = typename container_char_type_impl<T>::type;
+
+// The size to resize a container to when an outbuf needs min_increment
+// more elements after the used_size it has written. resize() value-
+// initializes the new elements, so the step is bounded to keep that
+// cost proportional to what is actually written. The reallocations
+// remain geometric as long as the container's resize() grows its
+// capacity geometrically, like std::vector does.
+inline std::size_t container_resized_size
+    ( std::size_t used_size, std::size_t min_increment ) noexcept
+{
+    constexpr std::size_t increment = 512;
+    return used_size + (min_increment > increment ? min_increment : increment);
+}
+
+} // namespace detail
+
+// Writes into a contiguous container ( like std::vector<char> ), after the
+// elements it already has. The container only needs to provide operator[],
+// size() and resize(). It is resized in bounded steps as needed, and then,
+// in finish(), to the size of what has actually been written. Each step
+// value-initializes the elements it adds, which costs one extra write per
+// character, plus at most one step that is written twice.
+template <typename Container>
+class container_appender final
+    : public strf::basic_outbuf
+        < strf::detail::container_char_type<typename Container::value_type> >
+{
+    using _value_type = typename Container::value_type;
+    using _char_type = strf::detail::container_char_type<_value_type>;
+
+    static_assert( sizeof(_value_type) == sizeof(_char_type)
+                 , "Unexpected size of Container::value_type" );
+
+public:
+
+    explicit container_appender(Container& c)
+        : strf::basic_outbuf<_char_type>(nullptr, nullptr)
+        , _container(c)
+        , _initial_size(c.size())
+    {
+        _resize(_initial_size, _initial_size + strf::min_size_after_recycle<_char_type>());
+    }
+
+    container_appender(Container& c, std::size_t size)
+        : strf::basic_outbuf<_char_type>(nullptr, nullptr)
+        , _container(c)
+        , _initial_size(c.size())
+    {
+        _resize( _initial_size
+               , _initial_size + ( size > strf::min_size_after_recycle<_char_type>()
+                                 ? size
+                                 : strf::min_size_after_recycle<_char_type>() ) );
+    }
+
+#if defined(STRF_NO_CXX17_COPY_ELISION)
+
+    container_appender(container_appender&&);
+
+#else // defined(STRF_NO_CXX17_COPY_ELISION)
+
+    container_appender(const container_appender&) = delete;
+    container_appender(container_appender&&) = delete;
+
+#endif // defined(STRF_NO_CXX17_COPY_ELISION)
+
+    ~container_appender()
+    {
+        if ( ! _finished) {
+            _container.resize(this->pos() - _begin());
+        }
+    }
+
+    void recycle() override
+    {
+        _grow(strf::min_size_after_recycle<_char_type>());
+    }
+
+    bool do_reserve_contiguous(std::size_t s) override
+    {
+        _grow(s);
+        return true;
+    }
+
+    void finish()
+    {
+        _container.resize(this->pos() - _begin());
+        _finished = true;
+        this->set_good(false);
+    }
+
+private:
+
+    _char_type* _begin() noexcept
+    {
+        return reinterpret_cast<_char_type*>(&_container[0]);
+    }
+
+    void _grow(std::size_t min_increment)
+    {
+        std::size_t used_size = this->pos() - _begin();
+        auto new_size = strf::detail::container_resized_size(used_size, min_increment);
+        this->set_good(false);
+        _resize(used_size, new_size);
+        this->set_good(true);
+    }
+
+    void _resize(std::size_t used_size, std::size_t new_size)
+    {
+        _container.resize(new_size);
+        auto p = _begin();
+        this->set_pos(p + used_size);
+        this->set_end(p + new_size);
+    }
+
+    Container& _container;
+    std::size_t _initial_size;
+    bool _finished = false;
+};
+
+// Creates a Container object, writing into it like container_appender.
+template <typename Container>
+class container_maker final
+    : public strf::basic_outbuf
+        < strf::detail::container_char_type<typename Container::value_type> >
+{
+    using _char_type = strf::detail::container_char_type
+        < typename Container::value_type >;
+
+public:
+
+    container_maker()
+        : strf::basic_outbuf<_char_type>(nullptr, nullptr)
+    {
+        _resize(0, strf::min_size_after_recycle<_char_type>());
+    }
+
+    explicit container_maker(std::size_t size)
+        : strf::basic_outbuf<_char_type>(nullptr, nullptr)
+    {
+        _resize(0, size > strf::min_size_after_recycle<_char_type>()
+                 ? size
+                 : strf::min_size_after_recycle<_char_type>() );
+    }
+
+#if defined(STRF_NO_CXX17_COPY_ELISION)
+
+    container_maker(container_maker&&);
+
+#else // defined(STRF_NO_CXX17_COPY_ELISION)
+
+    container_maker(const container_maker&) = delete;
+    container_maker(container_maker&&) = delete;
+
+#endif // defined(STRF_NO_CXX17_COPY_ELISION)
+
+    void recycle() override
+    {
+        _grow(strf::min_size_after_recycle<_char_type>());
+    }
+
+    bool do_reserve_contiguous(std::size_t s) override
+    {
+        _grow(s);
+        return true;
+    }
+
+    Container finish()
+    {
+        _container.resize(this->pos() - _begin());
+        this->set_good(false);
+        return std::move(_container);
+    }
+
+private:
+
+    _char_type* _begin() noexcept
+    {
+        return reinterpret_cast<_char_type*>(&_container[0]);
+    }
+
+    void _grow(std::size_t min_increment)
+    {
+        std::size_t used_size = this->pos() - _begin();
+        auto new_size = strf::detail::container_resized_size(used_size, min_increment);
+        this->set_good(false);
+        _resize(used_size, new_size);
+        this->set_good(true);
+    }
+
+    void _resize(std::size_t used_size, std::size_t new_size)
+    {
+        _container.resize(new_size);
+        auto p = _begin();
+        this->set_pos(p + used_size);
+        this->set_end(p + new_size);
+    }
+
+    Container _container;
+};
+
+// Writes into a C-style buffer described by a pointer, a length and a
+// capacity, appending the content after the first len characters.
+// When more space is needed, calls grow(ptr, len, new_capacity), that
+// shall return a pointer to a buffer of new_capacity characters that
+// preserves the first len ones ( like realloc ), or nullptr on failure.
+// The variables passed to the constructor are updated on each growth
+// and in finish().
+template <typename CharT, typename GrowFunc>
+class growable_buffer_writer final: public strf::basic_outbuf<CharT>
+{
+public:
+
+    growable_buffer_writer
+        ( CharT*& ptr
+        , std::size_t& len
+        , std::size_t& cap
+        , GrowFunc grow
+        , std::size_t size = 0 )
+        : strf::basic_outbuf<CharT>(nullptr, nullptr)
+        , _ptr(ptr)
+        , _len(len)
+        , _cap(cap)
+        , _grow_func(grow)
+    {
+        if (_ptr != nullptr && _cap - _len >= strf::min_size_after_recycle<CharT>()
+                            && _cap - _len >= size) {
+            this->set_pos(_ptr + _len);
+            this->set_end(_ptr + _cap);
+        } else {
+            _grow(_len, size > strf::min_size_after_recycle<CharT>()
+                      ? size
+                      : strf::min_size_after_recycle<CharT>() );
+        }
+    }
+
+#if defined(STRF_NO_CXX17_COPY_ELISION)
+
+    growable_buffer_writer(growable_buffer_writer&&);
+
+#else // defined(STRF_NO_CXX17_COPY_ELISION)
+
+    growable_buffer_writer(const growable_buffer_writer&) = delete;
+    growable_buffer_writer(growable_buffer_writer&&) = delete;
+
+#endif // defined(STRF_NO_CXX17_COPY_ELISION)
+
+    void recycle() override
+    {
+        if (this->good()) {
+            _grow(this->pos() - _ptr, strf::min_size_after_recycle<CharT>());
+        } else {
+            this->set_pos(strf::outbuf_garbage_buf<CharT>());
+        }
+    }
+
+    bool do_reserve_contiguous(std::size_t s) override
+    {
+        if (this->good()) {
+            _grow(this->pos() - _ptr, s);
+            return this->good();
+        }
+        return false;
+    }
+
+    struct result
+    {
+        std::size_t count;
+        bool success;
+    };
+
+    result finish()
+    {
+        bool g = this->good();
+        if (g) {
+            _len = this->pos() - _ptr;
+        }
+        this->set_good(false);
+        this->set_pos(strf::outbuf_garbage_buf<CharT>());
+        this->set_end(strf::outbuf_garbage_buf_end<CharT>());
+        return {_len - _initial_len, g};
+    }
+
+private:
+
+    void _grow(std::size_t used_size, std::size_t min_increment)
+    {
+        auto new_cap = _initial_len + strf::detail::string_grown_size
+            ( used_size - _initial_len, min_increment );
+        CharT* p = _grow_func(_ptr, used_size, new_cap);
+        if (p != nullptr) {
+            _ptr = p;
+            _cap = new_cap;
+            _len = used_size;
+            this->set_pos(p + used_size);
+            this->set_end(p + new_cap);
+        } else {
+            _len = used_size;
+            this->set_good(false);
+            this->set_pos(strf::outbuf_garbage_buf<CharT>());
+            this->set_end(strf::outbuf_garbage_buf_end<CharT>());
+        }
+    }
+
+    CharT*& _ptr;
+    std::size_t& _len;
+    std::size_t& _cap;
+    GrowFunc _grow_func;
+    std::size_t _initial_len = _len;
+};
+
+namespace detail {
+
+template <typename Container>
+class container_appender_creator
+{
+public:
+
+    using char_type = strf::detail::container_char_type<typename Container::value_type>;
+    using outbuf_type = strf::container_appender<Container>;
+    using finish_type = void;
+
+    container_appender_creator(Container& c)
+        : _container(c)
+    {
+    }
+
+    container_appender_creator(const container_appender_creator&) = default;
+
+    outbuf_type create() const
+    {
+        return outbuf_type{_container};
+    }
+
+    outbuf_type create(std::size_t size) const
+    {
+        return outbuf_type{_container, size};
+    }
+
+private:
+
+    Container& _container;
+};
+
+template <typename Container>
+class container_maker_creator
+{
+public:
+
+    using char_type = strf::detail::container_char_type<typename Container::value_type>;
+    using outbuf_type = strf::container_maker<Container>;
+    using finish_type = Container;
+
+    outbuf_type create() const
+    {
+        return outbuf_type{};
+    }
+
+    outbuf_type create(std::size_t size) const
+    {
+        return outbuf_type{size};
+    }
+};
+
+template <typename CharT, typename GrowFunc>
+class growable_buffer_writer_creator
+{
+public:
+
+    using char_type = CharT;
+    using outbuf_type = strf::growable_buffer_writer<CharT, GrowFunc>;
+    using finish_type = typename outbuf_type::result;
+
+    growable_buffer_writer_creator
+        ( CharT*& ptr, std::size_t& len, std::size_t& cap, GrowFunc grow )
+        : _ptr(ptr)
+        , _len(len)
+        , _cap(cap)
+        , _grow(grow)
+    {
+    }
+
+    growable_buffer_writer_creator(const growable_buffer_writer_creator&) = default;
+
+    outbuf_type create() const
+    {
+        return outbuf_type{_ptr, _len, _cap, _grow};
+    }
+
+    outbuf_type create(std::size_t size) const
+    {
+        return outbuf_type{_ptr, _len, _cap, _grow, size};
+    }
+
+private:
+
+    CharT*& _ptr;
+    std::size_t& _len;
+    std::size_t& _cap;
+    GrowFunc _grow;
+};
+
+} // namespace detail
+
+template <typename T, typename Allocator>
+auto append(std::vector<T, Allocator>& vec)
+{
+    return strf::destination_no_reserve
+        < strf::detail::container_appender_creator<std::vector<T, Allocator>> >
+        { vec };
+}
+
+template <typename T, typename Allocator>
+auto assign(std::vector<T, Allocator>& vec)
+{
+    vec.clear();
+    return strf::append(vec);
+}
+
+// Appends into any contiguous container that has operator[], size(),
+// capacity() and resize() member functions
+template <typename Container>
+auto append_to_container(Container& c)
+{
+    return strf::destination_no_reserve
+        < strf::detail::container_appender_creator<Container> >
+        { c };
+}
+
+template <typename Container>
+constexpr strf::destination_no_reserve
+    < strf::detail::container_maker_creator<Container> >
+    to_container{};
+
+template <typename CharT, typename GrowFunc>
+auto to_growable_buffer
+    ( CharT*& ptr, std::size_t& len, std::size_t& cap, GrowFunc grow )
+{
+    return strf::destination_no_reserve
+        < strf::detail::growable_buffer_writer_creator<CharT, GrowFunc> >
+        ( ptr, len, cap, grow );
+}
+
+} // namespace strf
+
+#endif  // STRF_DETAIL_OUTPUT_TYPES_CONTAINER_HPP
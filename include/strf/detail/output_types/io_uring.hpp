@@ -0,0 +1,662 @@
+#ifndef STRF_DETAIL_OUTPUT_TYPES_IO_URING_HPP
+#define STRF_DETAIL_OUTPUT_TYPES_IO_URING_HPP
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+// This header is Linux-specific, and is therefore not included by
+// <strf.hpp>. It uses the io_uring system calls directly, without
+// liburing. When the kernel does not support io_uring ( or when it
+// is not permitted ), io_uring_sink falls back to write(2).
+
+#include <strf/detail/output_types/posix_fd.hpp>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <linux/io_uring.h>
+
+namespace strf {
+
+namespace detail {
+
+// A minimal wrapper over an io_uring instance
+class io_uring_queue
+{
+public:
+
+    explicit io_uring_queue(unsigned entries) noexcept
+    {
+        ::io_uring_params p;
+        std::memset(&p, 0, sizeof(p));
+        int fd = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &p));
+        if (fd < 0) {
+            return;
+        }
+        _ring_fd = fd;
+        _features = p.features;
+        _sq_ring_size = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+        _cq_ring_size = p.cq_off.cqes + p.cq_entries * sizeof(::io_uring_cqe);
+        bool single_mmap = (p.features & IORING_FEAT_SINGLE_MMAP);
+        if (single_mmap) {
+            if (_cq_ring_size > _sq_ring_size) {
+                _sq_ring_size = _cq_ring_size;
+            }
+            _cq_ring_size = _sq_ring_size;
+        }
+        _sq_ring = _mmap(_sq_ring_size, IORING_OFF_SQ_RING);
+        if (_sq_ring == nullptr) {
+            _close();
+            return;
+        }
+        if (single_mmap) {
+            _cq_ring = _sq_ring;
+        } else {
+            _cq_ring = _mmap(_cq_ring_size, IORING_OFF_CQ_RING);
+            if (_cq_ring == nullptr) {
+                _close();
+                return;
+            }
+        }
+        _sqes_size = p.sq_entries * sizeof(::io_uring_sqe);
+        _sqes = static_cast<::io_uring_sqe*>(_mmap(_sqes_size, IORING_OFF_SQES));
+        if (_sqes == nullptr) {
+            _close();
+            return;
+        }
+        _sq_head = _member<unsigned>(_sq_ring, p.sq_off.head);
+        _sq_tail = _member<unsigned>(_sq_ring, p.sq_off.tail);
+        _sq_mask = *_member<unsigned>(_sq_ring, p.sq_off.ring_mask);
+        _sq_array = _member<unsigned>(_sq_ring, p.sq_off.array);
+        _sq_entries = p.sq_entries;
+        _cq_head = _member<unsigned>(_cq_ring, p.cq_off.head);
+        _cq_tail = _member<unsigned>(_cq_ring, p.cq_off.tail);
+        _cq_mask = *_member<unsigned>(_cq_ring, p.cq_off.ring_mask);
+        _cqes = _member<::io_uring_cqe>(_cq_ring, p.cq_off.cqes);
+        _local_sq_tail = *_sq_tail;
+    }
+
+    io_uring_queue(const io_uring_queue&) = delete;
+    io_uring_queue& operator=(const io_uring_queue&) = delete;
+
+    ~io_uring_queue()
+    {
+        _close();
+    }
+
+    bool valid() const noexcept
+    {
+        return _ring_fd >= 0;
+    }
+
+    unsigned features() const noexcept
+    {
+        return _features;
+    }
+
+    bool register_buffers(const ::iovec* iov, unsigned count) noexcept
+    {
+        return 0 == ::syscall( __NR_io_uring_register, _ring_fd
+                             , IORING_REGISTER_BUFFERS, iov, count );
+    }
+
+    bool register_file(int fd) noexcept
+    {
+        return 0 == ::syscall( __NR_io_uring_register, _ring_fd
+                             , IORING_REGISTER_FILES, &fd, 1 );
+    }
+
+    // Returns a zeroed submission queue entry, or nullptr if
+    // the submission queue is full.
+    ::io_uring_sqe* get_sqe() noexcept
+    {
+        unsigned head = __atomic_load_n(_sq_head, __ATOMIC_ACQUIRE);
+        if (_local_sq_tail - head >= _sq_entries) {
+            return nullptr;
+        }
+        unsigned idx = _local_sq_tail & _sq_mask;
+        _sq_array[idx] = idx;
+        ++ _local_sq_tail;
+        ::io_uring_sqe* sqe = &_sqes[idx];
+        std::memset(sqe, 0, sizeof(*sqe));
+        return sqe;
+    }
+
+    // Submits the pending entries, and waits until at least
+    // wait_nr completions are available. Returns false on error.
+    bool submit_and_wait(unsigned wait_nr) noexcept
+    {
+        __atomic_store_n(_sq_tail, _local_sq_tail, __ATOMIC_RELEASE);
+        while (true) {
+            unsigned head = __atomic_load_n(_sq_head, __ATOMIC_ACQUIRE);
+            unsigned to_submit = _local_sq_tail - head;
+            if (to_submit == 0 && (wait_nr == 0 || _completions_available() >= wait_nr)) {
+                return true;
+            }
+            unsigned flags = wait_nr != 0 ? IORING_ENTER_GETEVENTS : 0;
+            long r = ::syscall( __NR_io_uring_enter, _ring_fd, to_submit
+                              , wait_nr, flags, nullptr, 0 );
+            if (r < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+                return false;
+            }
+            if (r >= 0 && static_cast<unsigned>(r) == to_submit) {
+                return true;
+            }
+        }
+    }
+
+    // Calls f for each available completion queue entry
+    template <typename F>
+    void for_each_cqe(F f)
+    {
+        unsigned head = *_cq_head;
+        unsigned tail = __atomic_load_n(_cq_tail, __ATOMIC_ACQUIRE);
+        while (head != tail) {
+            ::io_uring_cqe cqe = _cqes[head & _cq_mask];
+            ++ head;
+            __atomic_store_n(_cq_head, head, __ATOMIC_RELEASE);
+            f(cqe);
+            tail = __atomic_load_n(_cq_tail, __ATOMIC_ACQUIRE);
+        }
+    }
+
+private:
+
+    unsigned _completions_available() const noexcept
+    {
+        return __atomic_load_n(_cq_tail, __ATOMIC_ACQUIRE) - *_cq_head;
+    }
+
+    void* _mmap(std::size_t size, long long offset) noexcept
+    {
+        void* p = ::mmap( nullptr, size, PROT_READ | PROT_WRITE
+                        , MAP_SHARED | MAP_POPULATE, _ring_fd, offset );
+        return p == MAP_FAILED ? nullptr : p;
+    }
+
+    template <typename T>
+    static T* _member(void* ring, unsigned offset) noexcept
+    {
+        return reinterpret_cast<T*>(static_cast<char*>(ring) + offset);
+    }
+
+    void _close() noexcept
+    {
+        if (_sqes != nullptr) {
+            ::munmap(_sqes, _sqes_size);
+        }
+        if (_cq_ring != nullptr && _cq_ring != _sq_ring) {
+            ::munmap(_cq_ring, _cq_ring_size);
+        }
+        if (_sq_ring != nullptr) {
+            ::munmap(_sq_ring, _sq_ring_size);
+        }
+        if (_ring_fd >= 0) {
+            ::close(_ring_fd);
+        }
+        _sqes = nullptr;
+        _cq_ring = nullptr;
+        _sq_ring = nullptr;
+        _ring_fd = -1;
+    }
+
+    int _ring_fd = -1;
+    unsigned _features = 0;
+    void* _sq_ring = nullptr;
+    void* _cq_ring = nullptr;
+    ::io_uring_sqe* _sqes = nullptr;
+    std::size_t _sq_ring_size = 0;
+    std::size_t _cq_ring_size = 0;
+    std::size_t _sqes_size = 0;
+    unsigned* _sq_head = nullptr;
+    unsigned* _sq_tail = nullptr;
+    unsigned* _sq_array = nullptr;
+    unsigned _sq_mask = 0;
+    unsigned _sq_entries = 0;
+    unsigned _local_sq_tail = 0;
+    unsigned* _cq_head = nullptr;
+    unsigned* _cq_tail = nullptr;
+    unsigned _cq_mask = 0;
+    ::io_uring_cqe* _cqes = nullptr;
+};
+
+} // namespace detail
+
+// Owns an io_uring instance and a small ring of buffers that are
+// written into a file descriptor. The buffers and the file descriptor
+// are registered in the io_uring instance once, when the kernel permits
+// it, so that this object is meant to be long-lived and shared by many
+// printing calls, through basic_io_uring_writer objects that borrow its
+// buffers. When a buffer gets full, it is submitted as a write, and the
+// writing continues into the next one, only waiting when that one is
+// still being written. The writes are not waited at the end of each
+// printing call, but only by flush() and by the destructor.
+//
+// When the file descriptor is seekable and not in append mode, each
+// buffer is written at an explicit offset, so that several writes can
+// be in flight at the same time, and the file offset is updated in
+// flush(). Otherwise, the writes are serialized.
+//
+// This class is not thread-safe, and at most one writer can borrow
+// it at a time.
+class io_uring_sink
+{
+    struct _slot
+    {
+        std::size_t size = 0;  // in bytes
+        std::size_t done = 0;  // in bytes
+        std::uint64_t offset = 0;
+        ::iovec iov;
+        bool busy = false;
+    };
+
+    // The buffer size is a multiple of this value, and is large enough
+    // for min_size_after_recycle characters of any type.
+    static constexpr std::size_t _buffer_granularity = 8;
+    static constexpr std::size_t _min_buffer_size
+        = strf::min_size_after_recycle<char32_t>() * sizeof(char32_t);
+
+public:
+
+    static constexpr std::size_t default_buffer_size = 0x10000;
+    static constexpr unsigned default_buffers_count = 4;
+
+    // buffer_size is in bytes
+    explicit io_uring_sink
+        ( int fd
+        , std::size_t buffer_size = default_buffer_size
+        , unsigned buffers_count = default_buffers_count )
+        : _fd(fd)
+        , _buf_size( buffer_size < _min_buffer_size
+                   ? _min_buffer_size
+                   : ( (buffer_size + _buffer_granularity - 1)
+                     & ~(_buffer_granularity - 1) ) )
+        , _bufs_count(buffers_count == 0 ? 1 : buffers_count)
+        , _data(new char[_buf_size * _bufs_count])
+        , _slots(new _slot[_bufs_count])
+        , _queue(_bufs_count)
+    {
+        if (_queue.valid()) {
+            std::unique_ptr<::iovec[]> iovs{new ::iovec[_bufs_count]};
+            for (unsigned i = 0; i < _bufs_count; ++i) {
+                iovs[i].iov_base = _buffer(i);
+                iovs[i].iov_len = _buf_size;
+            }
+            _fixed_buffers = _queue.register_buffers(iovs.get(), _bufs_count);
+            _fixed_file = _queue.register_file(fd);
+            auto offset = ::lseek(fd, 0, SEEK_CUR);
+            int flags = ::fcntl(fd, F_GETFL);
+            _seekable = offset >= 0 && flags != -1 && ! (flags & O_APPEND);
+            if (_seekable) {
+                _offset = static_cast<std::uint64_t>(offset);
+            }
+        }
+    }
+
+    io_uring_sink(const io_uring_sink&) = delete;
+    io_uring_sink& operator=(const io_uring_sink&) = delete;
+
+    // Waits for all the writes. No writer of this object shall still be alive.
+    ~io_uring_sink()
+    {
+        STRF_ASSERT( ! _borrowed);
+        flush();
+    }
+
+    // Waits until everything submitted so far is written, and updates the
+    // file offset of the file descriptor. Returns false if a write error
+    // has occurred.
+    bool flush() noexcept
+    {
+        _wait_all();
+        if (_seekable) {
+            ::lseek(_fd, static_cast<off_t>(_offset), SEEK_SET);
+        }
+        return _good;
+    }
+
+    // Returns false if a write error has occurred.
+    bool good() const noexcept
+    {
+        return _good;
+    }
+
+    // Number of bytes whose writing has completed
+    std::size_t bytes_written() const noexcept
+    {
+        return _bytes_written;
+    }
+
+    // Whether io_uring is being used, rather than write(2)
+    bool uses_io_uring() const noexcept
+    {
+        return _queue.valid();
+    }
+
+    // In bytes
+    std::size_t buffer_size() const noexcept
+    {
+        return _buf_size;
+    }
+
+    // Returns the current buffer, after waiting until it is not being
+    // written anymore. It must be returned by submit() or release().
+    char* acquire_buffer() noexcept
+    {
+        STRF_ASSERT( ! _borrowed);
+        _borrowed = true;
+        _wait_for_slot(_current);
+        return _buffer(_current);
+    }
+
+    // Submits the first size bytes of the current buffer,
+    // and moves to the next buffer.
+    void submit(std::size_t size) noexcept
+    {
+        STRF_ASSERT(_borrowed);
+        _borrowed = false;
+        if ( ! _good || size == 0) {
+            return;
+        }
+        if (_queue.valid()) {
+            _submit(_current, size);
+            _current = (_current + 1) % _bufs_count;
+        } else {
+            ::iovec iov[1] = {{_buffer(_current), size}};
+            _good = strf::detail::posix_writev_all(_fd, iov, 1, _bytes_written);
+        }
+    }
+
+    // Gives back the current buffer, without writing it.
+    void release() noexcept
+    {
+        STRF_ASSERT(_borrowed);
+        _borrowed = false;
+    }
+
+private:
+
+    char* _buffer(unsigned i) const noexcept
+    {
+        return _data.get() + i * _buf_size;
+    }
+
+    void _submit(unsigned i, std::size_t size) noexcept
+    {
+        if ( ! _seekable) {
+            _wait_all();
+        }
+        auto& slot = _slots[i];
+        slot.size = size;
+        slot.done = 0;
+        slot.offset = _offset;
+        if (_seekable) {
+            _offset += size;
+        }
+        slot.busy = true;
+        ++ _in_flight;
+        _push(i);
+    }
+
+    // Submits the part of the buffer i that has not been written yet
+    void _push(unsigned i) noexcept
+    {
+        auto& slot = _slots[i];
+        ::io_uring_sqe* sqe = _queue.get_sqe();
+        if (sqe == nullptr) {
+            _fail(i);
+            return;
+        }
+        char* addr = _buffer(i) + slot.done;
+        std::size_t len = slot.size - slot.done;
+        if (_fixed_buffers) {
+            sqe->opcode = IORING_OP_WRITE_FIXED;
+            sqe->addr = reinterpret_cast<std::uintptr_t>(addr);
+            sqe->len = static_cast<std::uint32_t>(len);
+            sqe->buf_index = static_cast<std::uint16_t>(i);
+        } else {
+            slot.iov.iov_base = addr;
+            slot.iov.iov_len = len;
+            sqe->opcode = IORING_OP_WRITEV;
+            sqe->addr = reinterpret_cast<std::uintptr_t>(&slot.iov);
+            sqe->len = 1;
+        }
+        if (_fixed_file) {
+            sqe->fd = 0;
+            sqe->flags = IOSQE_FIXED_FILE;
+        } else {
+            sqe->fd = _fd;
+        }
+        if (_seekable) {
+            sqe->off = slot.offset + slot.done;
+        } else {
+            // Use ( and update ) the file position, when supported
+            sqe->off = (_queue.features() & IORING_FEAT_RW_CUR_POS) ? ~std::uint64_t(0) : 0;
+        }
+        sqe->user_data = i;
+        if ( ! _queue.submit_and_wait(0)) {
+            _fail(i);
+        }
+    }
+
+    void _fail(unsigned i) noexcept
+    {
+        _slots[i].busy = false;
+        -- _in_flight;
+        _good = false;
+    }
+
+    void _reap() noexcept
+    {
+        _queue.for_each_cqe([this](const ::io_uring_cqe& cqe) {
+            auto i = static_cast<unsigned>(cqe.user_data);
+            auto& slot = _slots[i];
+            if (cqe.res < 0) {
+                if (cqe.res == -EINTR || cqe.res == -EAGAIN) {
+                    _push(i);
+                } else {
+                    _fail(i);
+                }
+                return;
+            }
+            slot.done += static_cast<std::size_t>(cqe.res);
+            _bytes_written += static_cast<std::size_t>(cqe.res);
+            if (slot.done < slot.size) {
+                if (cqe.res == 0) {
+                    _fail(i);
+                } else {
+                    _push(i);
+                }
+                return;
+            }
+            slot.busy = false;
+            -- _in_flight;
+        });
+    }
+
+    void _wait_for_slot(unsigned i) noexcept
+    {
+        while (_slots[i].busy) {
+            _wait_one();
+        }
+    }
+
+    void _wait_all() noexcept
+    {
+        while (_in_flight != 0) {
+            _wait_one();
+        }
+    }
+
+    void _wait_one() noexcept
+    {
+        if ( ! _queue.submit_and_wait(1)) {
+            // Should not happen. Give up waiting.
+            for (unsigned i = 0; i < _bufs_count; ++i) {
+                _slots[i].busy = false;
+            }
+            _in_flight = 0;
+            _good = false;
+            return;
+        }
+        _reap();
+    }
+
+    int _fd;
+    std::size_t _buf_size;
+    unsigned _bufs_count;
+    std::unique_ptr<char[]> _data;
+    std::unique_ptr<_slot[]> _slots;
+    strf::detail::io_uring_queue _queue;
+    unsigned _current = 0;
+    unsigned _in_flight = 0;
+    std::uint64_t _offset = 0;
+    std::size_t _bytes_written = 0;
+    bool _good = true;
+    bool _borrowed = false;
+    bool _seekable = false;
+    bool _fixed_buffers = false;
+    bool _fixed_file = false;
+};
+
+// Borrows the buffers of an io_uring_sink. Content of a writer
+// destroyed before finish() is partially discarded: buffers that
+// got full before are still written.
+template <typename CharT>
+class basic_io_uring_writer final: public strf::basic_outbuf_noexcept<CharT>
+{
+public:
+
+    explicit basic_io_uring_writer(strf::io_uring_sink& sink) noexcept
+        : strf::basic_outbuf_noexcept<CharT>(nullptr, nullptr)
+        , _sink(sink)
+        , _buf_size(sink.buffer_size() / sizeof(CharT))
+    {
+        _acquire();
+    }
+
+    basic_io_uring_writer() = delete;
+
+#if defined(STRF_NO_CXX17_COPY_ELISION)
+
+    basic_io_uring_writer(basic_io_uring_writer&&);
+
+#else // defined(STRF_NO_CXX17_COPY_ELISION)
+
+    basic_io_uring_writer(const basic_io_uring_writer&) = delete;
+    basic_io_uring_writer(basic_io_uring_writer&&) = delete;
+
+#endif // defined(STRF_NO_CXX17_COPY_ELISION)
+
+    ~basic_io_uring_writer()
+    {
+        if (_begin != nullptr) {
+            _sink.release();
+        }
+    }
+
+    void recycle() noexcept override
+    {
+        _submit();
+        _acquire();
+    }
+
+    bool do_reserve_contiguous(std::size_t s) override
+    {
+        if (s <= _buf_size) {
+            recycle();
+            return this->good();
+        }
+        return false;
+    }
+
+    struct result
+    {
+        std::size_t count;
+        bool success;
+    };
+
+    // Submits the remaining content, without waiting for it to be written.
+    result finish() noexcept
+    {
+        _submit();
+        this->set_good(false);
+        this->set_pos(strf::outbuf_garbage_buf<CharT>());
+        this->set_end(strf::outbuf_garbage_buf_end<CharT>());
+        return {_count, _sink.good()};
+    }
+
+private:
+
+    void _acquire() noexcept
+    {
+        _begin = reinterpret_cast<CharT*>(_sink.acquire_buffer());
+        this->set_pos(_begin);
+        this->set_end(_begin + _buf_size);
+        this->set_good(_sink.good());
+    }
+
+    void _submit() noexcept
+    {
+        std::size_t count = this->pos() - _begin;
+        _begin = nullptr;
+        _sink.submit(count * sizeof(CharT));
+        _count += count;
+    }
+
+    strf::io_uring_sink& _sink;
+    std::size_t _buf_size;
+    CharT* _begin = nullptr;
+    std::size_t _count = 0;
+};
+
+using io_uring_writer = strf::basic_io_uring_writer<char>;
+
+namespace detail {
+
+template <typename CharT>
+class basic_io_uring_writer_creator
+{
+public:
+
+    using char_type = CharT;
+    using outbuf_type = strf::basic_io_uring_writer<CharT>;
+    using finish_type = typename outbuf_type::result;
+
+    constexpr basic_io_uring_writer_creator(strf::io_uring_sink& sink) noexcept
+        : _sink(sink)
+    {
+    }
+
+    constexpr basic_io_uring_writer_creator
+        ( const basic_io_uring_writer_creator& ) = default;
+
+    outbuf_type create() const
+    {
+        return outbuf_type{_sink};
+    }
+
+private:
+
+    strf::io_uring_sink& _sink;
+};
+
+} // namespace detail
+
+template <typename CharT = char>
+inline auto to_io_uring(strf::io_uring_sink& sink)
+{
+    return strf::destination_no_reserve
+        < strf::detail::basic_io_uring_writer_creator<CharT> >
+        (sink);
+}
+
+} // namespace strf
+
+#endif  // STRF_DETAIL_OUTPUT_TYPES_IO_URING_HPP
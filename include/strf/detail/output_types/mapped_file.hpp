@@ -0,0 +1,232 @@
+#ifndef STRF_DETAIL_OUTPUT_TYPES_MAPPED_FILE_HPP
+#define STRF_DETAIL_OUTPUT_TYPES_MAPPED_FILE_HPP
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <unistd.h>
+#include <sys/mman.h>
+#include <strf/destination.hpp>
+
+namespace strf {
+
+template <typename CharT>
+class basic_mapped_file_writer final: public strf::basic_outbuf_noexcept<CharT>
+{
+public:
+
+    static constexpr std::size_t default_initial_size = 65536;
+
+    explicit STRF_HD basic_mapped_file_writer
+        ( int fd
+        , std::size_t initial_size = default_initial_size )
+        : strf::basic_outbuf_noexcept<CharT>
+            ( strf::outbuf_garbage_buf<CharT>()
+            , strf::outbuf_garbage_buf_end<CharT>() )
+        , _fd(fd)
+    {
+#ifdef __CUDA_ARCH__
+        // files are not accessible on CUDA devices
+        asm("trap;");
+#else
+        _map(initial_size != 0 ? initial_size : 1);
+#endif
+    }
+
+    STRF_HD basic_mapped_file_writer() = delete;
+
+#ifdef STRF_NO_CXX17_COPY_ELISION
+
+    STRF_HD basic_mapped_file_writer(basic_mapped_file_writer&&);
+
+#else // defined(STRF_NO_CXX17_COPY_ELISION)
+
+    basic_mapped_file_writer(const basic_mapped_file_writer&) = delete;
+    basic_mapped_file_writer(basic_mapped_file_writer&&) = delete;
+
+#endif // defined(STRF_NO_CXX17_COPY_ELISION)
+
+    STRF_HD ~basic_mapped_file_writer()
+    {
+#ifndef __CUDA_ARCH__
+        if ( ! _finished) {
+            (void) finish();
+        }
+#endif
+    }
+
+    STRF_HD void recycle() noexcept override
+    {
+#ifdef __CUDA_ARCH__
+        asm("trap;");
+#else
+        if (this->good()) {
+            std::size_t count = this->pos() - _begin;
+            _count = count;
+            std::size_t new_capacity = count + ( count > _capacity
+                                               ? count : _capacity );
+            if (new_capacity < count + strf::min_size_after_recycle<CharT>()) {
+                new_capacity = count + strf::min_size_after_recycle<CharT>();
+            }
+            _remap(count, new_capacity);
+        } else {
+            this->set_pos(strf::outbuf_garbage_buf<CharT>());
+        }
+#endif
+    }
+
+    STRF_HD bool do_reserve_contiguous(std::size_t s) noexcept override
+    {
+#ifdef __CUDA_ARCH__
+        asm("trap;");
+        return false;
+#else
+        if ( ! this->good()) {
+            return false;
+        }
+        std::size_t count = this->pos() - _begin;
+        _count = count;
+        _remap(count, count + (s > _capacity ? s : _capacity));
+        return this->good();
+#endif
+    }
+
+    struct result
+    {
+        std::size_t count;
+        bool success;
+    };
+
+    STRF_HD result finish()
+    {
+#ifdef __CUDA_ARCH__
+        asm("trap;");
+        return {};
+#else
+        bool g = this->good();
+        if (g) {
+            _count = this->pos() - _begin;
+        }
+        this->set_good(false);
+        this->set_pos(strf::outbuf_garbage_buf<CharT>());
+        this->set_end(strf::outbuf_garbage_buf_end<CharT>());
+        if ( ! _finished) {
+            _finished = true;
+            if (_begin != nullptr) {
+                g = (0 == ::munmap(_begin, _capacity * sizeof(CharT))) && g;
+                _begin = nullptr;
+            }
+            g = (0 == ::ftruncate(_fd, _count * sizeof(CharT))) && g;
+        }
+        return {_count, g};
+#endif
+    }
+
+private:
+
+    void _map(std::size_t capacity) noexcept
+    {
+        if (0 == ::ftruncate(_fd, capacity * sizeof(CharT))) {
+            void* p = ::mmap( nullptr, capacity * sizeof(CharT)
+                            , PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0 );
+            if (p != MAP_FAILED) {
+                _begin = static_cast<CharT*>(p);
+                _capacity = capacity;
+                this->set_pos(_begin);
+                this->set_end(_begin + capacity);
+                return;
+            }
+        }
+        this->set_good(false);
+    }
+
+    void _remap(std::size_t count, std::size_t new_capacity) noexcept
+    {
+        if (0 == ::ftruncate(_fd, new_capacity * sizeof(CharT))) {
+#if defined(__linux__) && defined(MREMAP_MAYMOVE)
+            void* p = ::mremap( _begin, _capacity * sizeof(CharT)
+                              , new_capacity * sizeof(CharT), MREMAP_MAYMOVE );
+            if (p != MAP_FAILED) {
+                _begin = static_cast<CharT*>(p);
+                _capacity = new_capacity;
+                this->set_pos(_begin + count);
+                this->set_end(_begin + new_capacity);
+                return;
+            }
+#else
+            void* p = ::mmap( nullptr, new_capacity * sizeof(CharT)
+                            , PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0 );
+            if (p != MAP_FAILED) {
+                ::munmap(_begin, _capacity * sizeof(CharT));
+                _begin = static_cast<CharT*>(p);
+                _capacity = new_capacity;
+                this->set_pos(_begin + count);
+                this->set_end(_begin + new_capacity);
+                return;
+            }
+#endif
+        }
+        this->set_good(false);
+        this->set_pos(strf::outbuf_garbage_buf<CharT>());
+        this->set_end(strf::outbuf_garbage_buf_end<CharT>());
+    }
+
+    int _fd;
+    CharT* _begin = nullptr;
+    std::size_t _capacity = 0;
+    std::size_t _count = 0;
+    bool _finished = false;
+};
+
+namespace detail {
+
+template <typename CharT>
+class basic_mapped_file_writer_creator
+{
+public:
+
+    using char_type = CharT;
+    using outbuf_type = strf::basic_mapped_file_writer<CharT>;
+    using finish_type = typename outbuf_type::result;
+
+    constexpr basic_mapped_file_writer_creator(int fd) noexcept
+        : _fd(fd)
+    {}
+
+    constexpr basic_mapped_file_writer_creator
+        (const basic_mapped_file_writer_creator&) = default;
+
+    outbuf_type create() const
+    {
+        return outbuf_type{_fd};
+    }
+
+    outbuf_type create(std::size_t size) const
+    {
+        return outbuf_type{_fd, size};
+    }
+
+private:
+
+    int _fd;
+};
+
+} // namespace detail
+
+template <typename CharT = char>
+inline auto to_mapped_file(int fd)
+{
+#ifndef __CUDA_ARCH__
+    return strf::destination_no_reserve
+        < strf::detail::basic_mapped_file_writer_creator<CharT> >
+        (fd);
+#else
+    return 0;
+#endif
+}
+
+} // namespace strf
+
+#endif  // STRF_DETAIL_OUTPUT_TYPES_MAPPED_FILE_HPP
+
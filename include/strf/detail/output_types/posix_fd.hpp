@@ -0,0 +1,438 @@
+#ifndef STRF_DETAIL_OUTPUT_TYPES_POSIX_FD_HPP
+#define STRF_DETAIL_OUTPUT_TYPES_POSIX_FD_HPP
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <unistd.h>
+#include <sys/uio.h>
+#include <strf/destination.hpp>
+
+namespace strf {
+
+namespace detail {
+
+// Writes the whole content referenced by iov into fd, retrying on
+// partial writes and on EINTR. iov is modified. Returns false if an
+// error occurs. The number of bytes written is added to written_bytes.
+inline bool posix_writev_all
+    ( int fd, ::iovec* iov, int iovcnt, std::size_t& written_bytes ) noexcept
+{
+    while (iovcnt > 0 && iov->iov_len == 0) {
+        ++iov;
+        --iovcnt;
+    }
+    while (iovcnt > 0) {
+        auto r = ::writev(fd, iov, iovcnt);
+        if (r <= 0) {
+            if (r < 0 && errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        written_bytes += static_cast<std::size_t>(r);
+        auto n = static_cast<std::size_t>(r);
+        while (iovcnt > 0 && n >= iov->iov_len) {
+            n -= iov->iov_len;
+            ++iov;
+            --iovcnt;
+        }
+        if (iovcnt > 0) {
+            iov->iov_base = static_cast<char*>(iov->iov_base) + n;
+            iov->iov_len -= n;
+        }
+    }
+    return true;
+}
+
+} // namespace detail
+
+template <typename CharT, std::size_t BufferSize = 4096>
+class basic_fd_writer final: public strf::basic_outbuf_noexcept<CharT>
+{
+    static_assert( BufferSize >= strf::min_size_after_recycle<CharT>()
+                 , "BufferSize must not be less than min_size_after_recycle" );
+
+    using _underlying_char_t = strf::underlying_outbuf_char_type<sizeof(CharT)>;
+
+public:
+
+    // Content passed to write_direct that does not fit in the remaining
+    // space of the buffer and that has at least this number of characters
+    // is not copied into the buffer: it is sent with writev along with the
+    // buffer content.
+    static constexpr std::size_t direct_write_threshold = BufferSize / 4;
+
+    explicit STRF_HD basic_fd_writer(int fd)
+        : strf::basic_outbuf_noexcept<CharT>(_buf, BufferSize)
+        , _fd(fd)
+    {
+#ifdef __CUDA_ARCH__
+        // file descriptors are not accessible on CUDA devices
+        asm("trap;");
+#endif
+    }
+
+    STRF_HD basic_fd_writer() = delete;
+
+#ifdef STRF_NO_CXX17_COPY_ELISION
+
+    STRF_HD basic_fd_writer(basic_fd_writer&&);
+
+#else // defined(STRF_NO_CXX17_COPY_ELISION)
+
+    basic_fd_writer(const basic_fd_writer&) = delete;
+    basic_fd_writer(basic_fd_writer&&) = delete;
+
+#endif // defined(STRF_NO_CXX17_COPY_ELISION)
+
+    STRF_HD ~basic_fd_writer()
+    {
+    }
+
+    STRF_HD void recycle() noexcept override
+    {
+#ifdef __CUDA_ARCH__
+        asm("trap;");
+#else
+        auto p = this->pos();
+        this->set_pos(_buf);
+        if (this->good()) {
+            ::iovec iov[1] = {{_buf, (p - _buf) * sizeof(CharT)}};
+            this->set_good(strf::detail::posix_writev_all(_fd, iov, 1, _bytes_count));
+        }
+#endif
+    }
+
+    STRF_HD bool do_reserve_contiguous(std::size_t s) override
+    {
+        if (s <= BufferSize) {
+            recycle();
+            return this->good();
+        }
+        return false;
+    }
+
+    STRF_HD void write_direct
+        ( const _underlying_char_t* ustr, std::size_t len ) override
+    {
+#ifdef __CUDA_ARCH__
+        asm("trap;");
+#else
+        auto str = reinterpret_cast<const CharT*>(ustr);
+        if (len <= this->size()) {
+            strf::detail::str_copy_n(this->pos(), str, len);
+            this->advance(len);
+        } else if (len < direct_write_threshold || ! this->good()) {
+            strf::detail::outbuf_write_continuation(*this, str, len);
+        } else {
+            auto p = this->pos();
+            this->set_pos(_buf);
+            ::iovec iov[2] =
+                { {_buf, (p - _buf) * sizeof(CharT)}
+                , {const_cast<CharT*>(str), len * sizeof(CharT)} };
+            this->set_good(strf::detail::posix_writev_all(_fd, iov, 2, _bytes_count));
+        }
+#endif
+    }
+
+    struct result
+    {
+        std::size_t count;
+        bool success;
+    };
+
+    STRF_HD result finish()
+    {
+#ifdef __CUDA_ARCH__
+        asm("trap;");
+        return {};
+#else
+        bool g = this->good();
+        if (g) {
+            recycle();
+            g = this->good();
+        }
+        this->set_good(false);
+        return {_bytes_count / sizeof(CharT), g};
+#endif
+    }
+
+private:
+
+    int _fd;
+    std::size_t _bytes_count = 0;
+    CharT _buf[BufferSize];
+};
+
+using fd_writer = strf::basic_fd_writer<char>;
+
+namespace detail {
+
+template <typename CharT, std::size_t BufferSize>
+class basic_fd_writer_creator
+{
+public:
+
+    using char_type = CharT;
+    using outbuf_type = strf::basic_fd_writer<CharT, BufferSize>;
+    using finish_type = typename outbuf_type::result;
+
+    constexpr basic_fd_writer_creator(int fd) noexcept
+        : _fd(fd)
+    {}
+
+    constexpr basic_fd_writer_creator(const basic_fd_writer_creator&) = default;
+
+    outbuf_type create() const
+    {
+        return outbuf_type{_fd};
+    }
+
+private:
+
+    int _fd;
+};
+
+} // namespace detail
+
+template <typename CharT = char, std::size_t BufferSize = 4096>
+inline auto to_fd(int fd)
+{
+#ifndef __CUDA_ARCH__
+    return strf::destination_no_reserve
+        < strf::detail::basic_fd_writer_creator<CharT, BufferSize> >
+        (fd);
+#else
+    return 0;
+#endif
+}
+
+namespace detail {
+
+struct fd_atomic_buffer
+{
+    fd_atomic_buffer() = default;
+    fd_atomic_buffer(const fd_atomic_buffer&) = delete;
+
+    ~fd_atomic_buffer()
+    {
+        ::operator delete(data);
+    }
+
+    void* data = nullptr;
+    std::size_t capacity_bytes = 0;
+    bool in_use = false;
+};
+
+// The buffer is kept across calls, so that, once it is large enough,
+// no allocation happens.
+inline strf::detail::fd_atomic_buffer& fd_atomic_thread_buffer()
+{
+    static thread_local strf::detail::fd_atomic_buffer buf;
+    return buf;
+}
+
+} // namespace detail
+
+template <typename CharT>
+class basic_fd_atomic_writer final: public strf::basic_outbuf<CharT>
+{
+public:
+
+    static constexpr std::size_t initial_capacity = 1024;
+
+    explicit STRF_HD basic_fd_atomic_writer
+        ( int fd
+        , std::size_t min_capacity = initial_capacity )
+        : strf::basic_outbuf<CharT>
+            ( strf::outbuf_garbage_buf<CharT>()
+            , strf::outbuf_garbage_buf_end<CharT>() )
+        , _fd(fd)
+    {
+#ifdef __CUDA_ARCH__
+        // file descriptors are not accessible on CUDA devices
+        asm("trap;");
+#else
+        auto& tls_buf = strf::detail::fd_atomic_thread_buffer();
+        if ( ! tls_buf.in_use) {
+            // Otherwise, this writer is being used while another
+            // one of the same thread is still alive. It then uses
+            // its own buffer, in _local_buf.
+            _buf = &tls_buf;
+        }
+        if (min_capacity < strf::min_size_after_recycle<CharT>()) {
+            min_capacity = strf::min_size_after_recycle<CharT>();
+        }
+        _reserve(0, min_capacity);
+        // Only marked as in use after _reserve, which may throw,
+        // since the destructor does not run in that case.
+        if (_buf != &_local_buf) {
+            _buf->in_use = true;
+        }
+#endif
+    }
+
+    STRF_HD basic_fd_atomic_writer() = delete;
+
+#ifdef STRF_NO_CXX17_COPY_ELISION
+
+    STRF_HD basic_fd_atomic_writer(basic_fd_atomic_writer&&);
+
+#else // defined(STRF_NO_CXX17_COPY_ELISION)
+
+    basic_fd_atomic_writer(const basic_fd_atomic_writer&) = delete;
+    basic_fd_atomic_writer(basic_fd_atomic_writer&&) = delete;
+
+#endif // defined(STRF_NO_CXX17_COPY_ELISION)
+
+    STRF_HD ~basic_fd_atomic_writer()
+    {
+#ifndef __CUDA_ARCH__
+        _release();
+#endif
+    }
+
+    STRF_HD void recycle() override
+    {
+#ifdef __CUDA_ARCH__
+        asm("trap;");
+#else
+        auto count = this->pos() - _begin();
+        auto capacity = _buf->capacity_bytes / sizeof(CharT);
+        _reserve(count, capacity + ( capacity > strf::min_size_after_recycle<CharT>()
+                                   ? capacity
+                                   : strf::min_size_after_recycle<CharT>() ));
+#endif
+    }
+
+    STRF_HD bool do_reserve_contiguous(std::size_t s) override
+    {
+#ifdef __CUDA_ARCH__
+        asm("trap;");
+        return false;
+#else
+        auto count = this->pos() - _begin();
+        auto capacity = _buf->capacity_bytes / sizeof(CharT);
+        _reserve(count, count + ( s > capacity ? s : capacity ));
+        return true;
+#endif
+    }
+
+    struct result
+    {
+        std::size_t count;
+        bool success;
+    };
+
+    // Writes the whole content with a single call to write(2), unless
+    // it only partially succeeds, in which case the rest is written
+    // with subsequent calls.
+    STRF_HD result finish()
+    {
+#ifdef __CUDA_ARCH__
+        asm("trap;");
+        return {};
+#else
+        std::size_t count = this->pos() - _begin();
+        this->set_good(false);
+        this->set_pos(strf::outbuf_garbage_buf<CharT>());
+        this->set_end(strf::outbuf_garbage_buf_end<CharT>());
+        std::size_t written_bytes = 0;
+        ::iovec iov[1] = {{_buf->data, count * sizeof(CharT)}};
+        bool success = strf::detail::posix_writev_all(_fd, iov, 1, written_bytes);
+        _release();
+        return {written_bytes / sizeof(CharT), success};
+#endif
+    }
+
+private:
+
+    CharT* _begin() const noexcept
+    {
+        return static_cast<CharT*>(_buf->data);
+    }
+
+    void _reserve(std::size_t count, std::size_t capacity)
+    {
+        if (_buf->capacity_bytes < capacity * sizeof(CharT)) {
+            void* new_data = ::operator new(capacity * sizeof(CharT));
+            if (count != 0) {
+                std::memcpy(new_data, _buf->data, count * sizeof(CharT));
+            }
+            ::operator delete(_buf->data);
+            _buf->data = new_data;
+            _buf->capacity_bytes = capacity * sizeof(CharT);
+        }
+        this->set_pos(_begin() + count);
+        this->set_end(_begin() + _buf->capacity_bytes / sizeof(CharT));
+    }
+
+    void _release() noexcept
+    {
+        if (_buf != &_local_buf) {
+            _buf->in_use = false;
+            _buf = &_local_buf;
+        }
+    }
+
+    int _fd;
+    strf::detail::fd_atomic_buffer _local_buf;
+    strf::detail::fd_atomic_buffer* _buf = &_local_buf;
+};
+
+namespace detail {
+
+template <typename CharT>
+class basic_fd_atomic_writer_creator
+{
+public:
+
+    using char_type = CharT;
+    using outbuf_type = strf::basic_fd_atomic_writer<CharT>;
+    using finish_type = typename outbuf_type::result;
+
+    constexpr basic_fd_atomic_writer_creator(int fd) noexcept
+        : _fd(fd)
+    {}
+
+    constexpr basic_fd_atomic_writer_creator
+        (const basic_fd_atomic_writer_creator&) = default;
+
+    outbuf_type create() const
+    {
+        return outbuf_type{_fd};
+    }
+
+    outbuf_type create(std::size_t size) const
+    {
+        return outbuf_type{_fd, size};
+    }
+
+private:
+
+    int _fd;
+};
+
+} // namespace detail
+
+template <typename CharT = char>
+inline auto to_fd_atomic(int fd)
+{
+#ifndef __CUDA_ARCH__
+    return strf::destination_no_reserve
+        < strf::detail::basic_fd_atomic_writer_creator<CharT> >
+        (fd);
+#else
+    return 0;
+#endif
+}
+
+} // namespace strf
+
+#endif  // STRF_DETAIL_OUTPUT_TYPES_POSIX_FD_HPP
+
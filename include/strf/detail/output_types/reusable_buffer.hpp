@@ -0,0 +1,468 @@
+#ifndef STRF_DETAIL_OUTPUT_TYPES_REUSABLE_BUFFER_HPP
+#define STRF_DETAIL_OUTPUT_TYPES_REUSABLE_BUFFER_HPP
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <strf/outbuf.hpp>
+#include <strf/destination.hpp>
+#include <strf/detail/input_types/string.hpp>
+#include <strf/detail/output_types/std_string.hpp>
+#include <memory>
+
+namespace strf {
+
+#if defined(STRF_HAS_STD_STRING_VIEW)
+
+template <typename CharT>
+using transient_string_view = std::basic_string_view<CharT>;
+
+#else
+
+template <typename CharT>
+using transient_string_view = strf::detail::simple_string_view<CharT>;
+
+#endif // defined(STRF_HAS_STD_STRING_VIEW)
+
+namespace detail {
+
+template <typename CharT>
+struct reusable_buffer
+{
+    std::unique_ptr<CharT[]> data;
+    std::size_t capacity = 0;
+};
+
+// Reallocates buf so that it has room for at least used_size + min_increment
+// characters, preserving the first used_size ones. The capacity at least
+// doubles, so that writing n characters takes O(log n) reallocations.
+template <typename CharT>
+void grow_reusable_buffer
+    ( strf::detail::reusable_buffer<CharT>& buf
+    , std::size_t used_size
+    , std::size_t min_increment )
+{
+    auto new_capacity = used_size + (used_size > min_increment ? used_size : min_increment);
+    std::unique_ptr<CharT[]> new_data{new CharT[new_capacity]};
+    strf::detail::str_copy_n(new_data.get(), buf.data.get(), used_size);
+    buf.data = std::move(new_data);
+    buf.capacity = new_capacity;
+}
+
+// The buffers that to_tls_view writes into. They only grow. Each call
+// writes into the one that does not contain the view returned by the
+// previous call, so that this view can be an argument of the next call.
+template <typename CharT>
+struct tls_view_buffers
+{
+    strf::detail::reusable_buffer<CharT> buffers[2];
+    unsigned last = 1; // index of the buffer of the last returned view
+    bool writing = false;
+};
+
+template <typename CharT>
+strf::detail::tls_view_buffers<CharT>& tls_view_buffers_instance()
+{
+    static thread_local strf::detail::tls_view_buffers<CharT> bufs;
+    return bufs;
+}
+
+// Keeps the buffers of destroyed pooled strings, up to max_count buffers
+// per thread, so that they can be reused without allocation. Buffers
+// larger than max_capacity characters are not kept.
+template <typename CharT>
+class reusable_buffer_pool
+{
+public:
+
+    static constexpr std::size_t max_count = 16;
+    static constexpr std::size_t max_capacity = 0x10000;
+
+    reusable_buffer_pool() = default;
+    reusable_buffer_pool(const reusable_buffer_pool&) = delete;
+
+    static reusable_buffer_pool& thread_instance()
+    {
+        static thread_local reusable_buffer_pool pool;
+        return pool;
+    }
+
+    strf::detail::reusable_buffer<CharT> acquire() noexcept
+    {
+        if (_count == 0) {
+            return {};
+        }
+        return std::move(_buffers[--_count]);
+    }
+
+    void release(strf::detail::reusable_buffer<CharT>&& buf) noexcept
+    {
+        if (_count < max_count && buf.capacity <= max_capacity) {
+            _buffers[_count++] = std::move(buf);
+        }
+    }
+
+private:
+
+    strf::detail::reusable_buffer<CharT> _buffers[max_count];
+    std::size_t _count = 0;
+};
+
+} // namespace detail
+
+// Writes into per-thread buffers that are reused across calls and never
+// shrink. The view returned by finish() remains valid while the next
+// basic_tls_view_writer<CharT> of the same thread writes, so it can be
+// printed by it. It is invalidated by the one after that. Hence a view
+// must not be printed by any later call, and to_tls_view must not be
+// used while another basic_tls_view_writer<CharT> of the same thread is
+// alive, e.g. inside a printer.
+template <typename CharT>
+class basic_tls_view_writer final: public strf::basic_outbuf<CharT>
+{
+public:
+
+    basic_tls_view_writer()
+        : basic_tls_view_writer(0)
+    {
+    }
+
+    explicit basic_tls_view_writer(std::size_t size)
+        : strf::basic_outbuf<CharT>(nullptr, nullptr)
+        , _bufs(strf::detail::tls_view_buffers_instance<CharT>())
+        , _index(1 - _bufs.last)
+        , _buf(_bufs.buffers[_index])
+    {
+        STRF_ASSERT( ! _bufs.writing );
+        _bufs.writing = true;
+        // plus one for the termination character
+        std::size_t min_cap = size < strf::min_size_after_recycle<CharT>()
+                            ? strf::min_size_after_recycle<CharT>()
+                            : size + 1;
+        if (_buf.capacity < min_cap) {
+            strf::detail::grow_reusable_buffer(_buf, 0, min_cap);
+        }
+        this->set_pos(_buf.data.get());
+        this->set_end(_buf.data.get() + _buf.capacity);
+    }
+
+#if defined(STRF_NO_CXX17_COPY_ELISION)
+
+    basic_tls_view_writer(basic_tls_view_writer&&);
+
+#else // defined(STRF_NO_CXX17_COPY_ELISION)
+
+    basic_tls_view_writer(const basic_tls_view_writer&) = delete;
+    basic_tls_view_writer(basic_tls_view_writer&&) = delete;
+
+#endif // defined(STRF_NO_CXX17_COPY_ELISION)
+
+    ~basic_tls_view_writer()
+    {
+        _bufs.writing = false;
+    }
+
+    void recycle() override
+    {
+        _grow(strf::min_size_after_recycle<CharT>());
+    }
+
+    bool do_reserve_contiguous(std::size_t s) override
+    {
+        _grow(s);
+        return true;
+    }
+
+    // The content is followed by a termination character,
+    // which is not included in the returned view.
+    strf::transient_string_view<CharT> finish()
+    {
+        if (this->pos() == this->end()) {
+            _grow(1);
+        }
+        const CharT* begin = _buf.data.get();
+        std::size_t len = this->pos() - begin;
+        *this->pos() = CharT();
+        this->set_good(false);
+        this->set_pos(strf::outbuf_garbage_buf<CharT>());
+        this->set_end(strf::outbuf_garbage_buf_end<CharT>());
+        _bufs.last = _index;
+        return {begin, len};
+    }
+
+private:
+
+    void _grow(std::size_t min_increment)
+    {
+        std::size_t used_size = this->pos() - _buf.data.get();
+        this->set_good(false);
+        strf::detail::grow_reusable_buffer(_buf, used_size, min_increment);
+        this->set_good(true);
+        this->set_pos(_buf.data.get() + used_size);
+        this->set_end(_buf.data.get() + _buf.capacity);
+    }
+
+    strf::detail::tls_view_buffers<CharT>& _bufs;
+    unsigned _index;
+    strf::detail::reusable_buffer<CharT>& _buf;
+};
+
+template <typename CharT>
+class basic_pooled_string_writer;
+
+// A movable string whose buffer, when destroyed, goes back to a
+// thread-local pool to be reused by the next to_pooled_string call.
+// The content is always followed by a termination character.
+template <typename CharT>
+class basic_pooled_string
+{
+    using _pool = strf::detail::reusable_buffer_pool<CharT>;
+
+public:
+
+    basic_pooled_string() noexcept = default;
+
+    basic_pooled_string(basic_pooled_string&& other) noexcept
+        : _buf(std::move(other._buf))
+        , _size(other._size)
+    {
+        other._buf.capacity = 0;
+        other._size = 0;
+    }
+
+    basic_pooled_string& operator=(basic_pooled_string&& other) noexcept
+    {
+        if (this != &other) {
+            _release();
+            _buf = std::move(other._buf);
+            _size = other._size;
+            other._buf.capacity = 0;
+            other._size = 0;
+        }
+        return *this;
+    }
+
+    basic_pooled_string(const basic_pooled_string&) = delete;
+    basic_pooled_string& operator=(const basic_pooled_string&) = delete;
+
+    ~basic_pooled_string()
+    {
+        _release();
+    }
+
+    const CharT* data() const noexcept
+    {
+        return _buf.data ? _buf.data.get() : _empty();
+    }
+    const CharT* c_str() const noexcept
+    {
+        return data();
+    }
+    std::size_t size() const noexcept
+    {
+        return _size;
+    }
+    bool empty() const noexcept
+    {
+        return _size == 0;
+    }
+    const CharT* begin() const noexcept
+    {
+        return data();
+    }
+    const CharT* end() const noexcept
+    {
+        return data() + _size;
+    }
+
+#if defined(STRF_HAS_STD_STRING_VIEW)
+
+    operator std::basic_string_view<CharT> () const noexcept
+    {
+        return {data(), _size};
+    }
+
+#endif // defined(STRF_HAS_STD_STRING_VIEW)
+
+private:
+
+    friend class basic_pooled_string_writer<CharT>;
+
+    basic_pooled_string
+        ( strf::detail::reusable_buffer<CharT>&& buf
+        , std::size_t size ) noexcept
+        : _buf(std::move(buf))
+        , _size(size)
+    {
+    }
+
+    static const CharT* _empty() noexcept
+    {
+        static const CharT empty_str[1] = {CharT()};
+        return empty_str;
+    }
+
+    void _release() noexcept
+    {
+        if (_buf.data) {
+            _pool::thread_instance().release(std::move(_buf));
+            _buf.capacity = 0;
+        }
+        _size = 0;
+    }
+
+    strf::detail::reusable_buffer<CharT> _buf;
+    std::size_t _size = 0;
+};
+
+template <typename CharT>
+class basic_pooled_string_writer final: public strf::basic_outbuf<CharT>
+{
+    using _pool = strf::detail::reusable_buffer_pool<CharT>;
+
+public:
+
+    basic_pooled_string_writer()
+        : basic_pooled_string_writer(0)
+    {
+    }
+
+    explicit basic_pooled_string_writer(std::size_t size)
+        : strf::basic_outbuf<CharT>(nullptr, nullptr)
+        , _buf(_pool::thread_instance().acquire())
+    {
+        // plus one for the termination character
+        std::size_t min_cap = size < strf::min_size_after_recycle<CharT>()
+                            ? strf::min_size_after_recycle<CharT>()
+                            : size + 1;
+        if (_buf.capacity < min_cap) {
+            strf::detail::grow_reusable_buffer(_buf, 0, min_cap);
+        }
+        this->set_pos(_buf.data.get());
+        this->set_end(_buf.data.get() + _buf.capacity);
+    }
+
+#if defined(STRF_NO_CXX17_COPY_ELISION)
+
+    basic_pooled_string_writer(basic_pooled_string_writer&&);
+
+#else // defined(STRF_NO_CXX17_COPY_ELISION)
+
+    basic_pooled_string_writer(const basic_pooled_string_writer&) = delete;
+    basic_pooled_string_writer(basic_pooled_string_writer&&) = delete;
+
+#endif // defined(STRF_NO_CXX17_COPY_ELISION)
+
+    ~basic_pooled_string_writer()
+    {
+        if (_buf.data) {
+            _pool::thread_instance().release(std::move(_buf));
+        }
+    }
+
+    void recycle() override
+    {
+        _grow(strf::min_size_after_recycle<CharT>());
+    }
+
+    bool do_reserve_contiguous(std::size_t s) override
+    {
+        _grow(s);
+        return true;
+    }
+
+    strf::basic_pooled_string<CharT> finish()
+    {
+        if (this->pos() == this->end()) {
+            _grow(1);
+        }
+        std::size_t len = this->pos() - _buf.data.get();
+        *this->pos() = CharT();
+        this->set_good(false);
+        this->set_pos(strf::outbuf_garbage_buf<CharT>());
+        this->set_end(strf::outbuf_garbage_buf_end<CharT>());
+        return {std::move(_buf), len};
+    }
+
+private:
+
+    void _grow(std::size_t min_increment)
+    {
+        std::size_t used_size = this->pos() - _buf.data.get();
+        this->set_good(false);
+        strf::detail::grow_reusable_buffer(_buf, used_size, min_increment);
+        this->set_good(true);
+        this->set_pos(_buf.data.get() + used_size);
+        this->set_end(_buf.data.get() + _buf.capacity);
+    }
+
+    strf::detail::reusable_buffer<CharT> _buf;
+};
+
+using pooled_string = basic_pooled_string<char>;
+
+namespace detail {
+
+template <typename CharT>
+class basic_tls_view_writer_creator
+{
+public:
+
+    using char_type = CharT;
+    using outbuf_type = strf::basic_tls_view_writer<CharT>;
+    using finish_type = strf::transient_string_view<CharT>;
+
+    outbuf_type create() const
+    {
+        return outbuf_type{};
+    }
+    outbuf_type create(std::size_t size) const
+    {
+        return outbuf_type{size};
+    }
+};
+
+template <typename CharT>
+class basic_pooled_string_writer_creator
+{
+public:
+
+    using char_type = CharT;
+    using outbuf_type = strf::basic_pooled_string_writer<CharT>;
+    using finish_type = strf::basic_pooled_string<CharT>;
+
+    outbuf_type create() const
+    {
+        return outbuf_type{};
+    }
+    outbuf_type create(std::size_t size) const
+    {
+        return outbuf_type{size};
+    }
+};
+
+} // namespace detail
+
+template <typename CharT>
+constexpr strf::destination_no_reserve
+    < strf::detail::basic_tls_view_writer_creator<CharT> >
+    to_basic_tls_view{};
+
+constexpr strf::destination_no_reserve
+    < strf::detail::basic_tls_view_writer_creator<char> >
+    to_tls_view{};
+
+template <typename CharT>
+constexpr strf::destination_no_reserve
+    < strf::detail::basic_pooled_string_writer_creator<CharT> >
+    to_basic_pooled_string{};
+
+constexpr strf::destination_no_reserve
+    < strf::detail::basic_pooled_string_writer_creator<char> >
+    to_pooled_string{};
+
+} // namespace strf
+
+#endif  // STRF_DETAIL_OUTPUT_TYPES_REUSABLE_BUFFER_HPP
+
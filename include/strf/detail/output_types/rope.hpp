@@ -0,0 +1,434 @@
+#ifndef STRF_DETAIL_OUTPUT_TYPES_ROPE_HPP
+#define STRF_DETAIL_OUTPUT_TYPES_ROPE_HPP
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <strf/outbuf.hpp>
+#include <strf/destination.hpp>
+#include <iterator>
+#include <string>
+
+namespace strf {
+
+namespace detail {
+
+template <typename CharT, std::size_t ChunkSize>
+struct rope_chunk
+{
+    rope_chunk* next;
+    std::size_t size;
+    CharT data[ChunkSize];
+};
+
+// Keeps the chunks of destroyed ropes, up to max_size chunks
+// per thread, so that they can be reused without allocation.
+template <typename CharT, std::size_t ChunkSize>
+class rope_chunk_pool
+{
+    using _chunk = strf::detail::rope_chunk<CharT, ChunkSize>;
+
+    enum class _state { not_created, alive, destroyed };
+
+public:
+
+    static constexpr std::size_t max_size = 64;
+
+    rope_chunk_pool() noexcept
+    {
+        _thread_state() = _state::alive;
+    }
+
+    rope_chunk_pool(const rope_chunk_pool&) = delete;
+
+    ~rope_chunk_pool()
+    {
+        _thread_state() = _state::destroyed;
+        while (_head != nullptr) {
+            auto next = _head->next;
+            delete _head;
+            _head = next;
+        }
+    }
+
+    static rope_chunk_pool& thread_instance()
+    {
+        static thread_local rope_chunk_pool pool;
+        return pool;
+    }
+
+    // Uses the pool of this thread, unless it has already been
+    // destroyed, which happens when a rope with static or thread
+    // storage duration is destroyed after it.
+    static _chunk* acquire_chunk()
+    {
+        if (_thread_state() == _state::destroyed) {
+            _chunk* c = new _chunk;
+            c->next = nullptr;
+            c->size = 0;
+            return c;
+        }
+        return thread_instance().acquire();
+    }
+
+    static void release_chunk(_chunk* c) noexcept
+    {
+        if (_thread_state() == _state::alive) {
+            thread_instance().release(c);
+        } else {
+            delete c;
+        }
+    }
+
+    _chunk* acquire()
+    {
+        _chunk* c = _head;
+        if (c != nullptr) {
+            _head = c->next;
+            -- _size;
+        } else {
+            c = new _chunk;
+        }
+        c->next = nullptr;
+        c->size = 0;
+        return c;
+    }
+
+    void release(_chunk* c) noexcept
+    {
+        if (_size < max_size) {
+            c->next = _head;
+            _head = c;
+            ++ _size;
+        } else {
+            delete c;
+        }
+    }
+
+private:
+
+    // Trivially destructible, hence still usable after the pool is destroyed
+    static _state& _thread_state() noexcept
+    {
+        static thread_local _state state = _state::not_created;
+        return state;
+    }
+
+    _chunk* _head = nullptr;
+    std::size_t _size = 0;
+};
+
+} // namespace detail
+
+template <typename CharT, std::size_t ChunkSize = 4096>
+class basic_rope
+{
+    using _chunk = strf::detail::rope_chunk<CharT, ChunkSize>;
+    using _pool = strf::detail::rope_chunk_pool<CharT, ChunkSize>;
+
+public:
+
+    struct segment
+    {
+        const CharT* data;
+        std::size_t size;
+    };
+
+    class const_iterator
+    {
+    public:
+
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = segment;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const segment*;
+        using reference = segment;
+
+        const_iterator() noexcept = default;
+
+        segment operator*() const noexcept
+        {
+            return {_it->data, _it->size};
+        }
+        const_iterator& operator++() noexcept
+        {
+            _it = _it->next;
+            return *this;
+        }
+        const_iterator operator++(int) noexcept
+        {
+            auto copy = *this;
+            _it = _it->next;
+            return copy;
+        }
+        bool operator==(const const_iterator& other) const noexcept
+        {
+            return _it == other._it;
+        }
+        bool operator!=(const const_iterator& other) const noexcept
+        {
+            return _it != other._it;
+        }
+
+    private:
+
+        friend class basic_rope;
+
+        explicit const_iterator(const _chunk* it) noexcept
+            : _it(it)
+        {
+        }
+
+        const _chunk* _it = nullptr;
+    };
+
+    basic_rope() noexcept = default;
+
+    basic_rope(basic_rope&& other) noexcept
+        : _first(other._first)
+        , _size(other._size)
+        , _segments_count(other._segments_count)
+    {
+        other._first = nullptr;
+        other._size = 0;
+        other._segments_count = 0;
+    }
+
+    basic_rope& operator=(basic_rope&& other) noexcept
+    {
+        if (this != &other) {
+            _clear();
+            _first = other._first;
+            _size = other._size;
+            _segments_count = other._segments_count;
+            other._first = nullptr;
+            other._size = 0;
+            other._segments_count = 0;
+        }
+        return *this;
+    }
+
+    basic_rope(const basic_rope&) = delete;
+    basic_rope& operator=(const basic_rope&) = delete;
+
+    ~basic_rope()
+    {
+        _clear();
+    }
+
+    // Number of characters
+    std::size_t size() const noexcept
+    {
+        return _size;
+    }
+    bool empty() const noexcept
+    {
+        return _size == 0;
+    }
+    // Number of non-empty segments
+    std::size_t segments_count() const noexcept
+    {
+        return _segments_count;
+    }
+    const_iterator begin() const noexcept
+    {
+        return const_iterator{_first};
+    }
+    const_iterator end() const noexcept
+    {
+        return const_iterator{};
+    }
+
+    // Copies all characters into dest, which must have
+    // room for at least size() characters.
+    CharT* copy_to(CharT* dest) const noexcept
+    {
+        for (auto seg : *this) {
+            strf::detail::str_copy_n(dest, seg.data, seg.size);
+            dest += seg.size;
+        }
+        return dest;
+    }
+
+    template <typename Traits = std::char_traits<CharT>>
+    std::basic_string<CharT, Traits> to_string() const
+    {
+        std::basic_string<CharT, Traits> str;
+        str.reserve(_size);
+        for (auto seg : *this) {
+            str.append(seg.data, seg.size);
+        }
+        return str;
+    }
+
+private:
+
+    template <typename, std::size_t>
+    friend class basic_rope_writer;
+
+    basic_rope(_chunk* first, std::size_t size, std::size_t segments_count) noexcept
+        : _first(first)
+        , _size(size)
+        , _segments_count(segments_count)
+    {
+    }
+
+    void _clear() noexcept
+    {
+        while (_first != nullptr) {
+            auto next = _first->next;
+            _pool::release_chunk(_first);
+            _first = next;
+        }
+    }
+
+    _chunk* _first = nullptr;
+    std::size_t _size = 0;
+    std::size_t _segments_count = 0;
+};
+
+template <typename CharT, std::size_t ChunkSize = 4096>
+class basic_rope_writer final: public strf::basic_outbuf<CharT>
+{
+    static_assert( ChunkSize >= strf::min_size_after_recycle<CharT>()
+                 , "ChunkSize must not be less than min_size_after_recycle" );
+
+    using _chunk = strf::detail::rope_chunk<CharT, ChunkSize>;
+    using _pool = strf::detail::rope_chunk_pool<CharT, ChunkSize>;
+
+public:
+
+    basic_rope_writer()
+        : strf::basic_outbuf<CharT>(nullptr, nullptr)
+        , _first(_pool::acquire_chunk())
+        , _last(_first)
+    {
+        this->set_pos(_first->data);
+        this->set_end(_first->data + ChunkSize);
+    }
+
+#if defined(STRF_NO_CXX17_COPY_ELISION)
+
+    basic_rope_writer(basic_rope_writer&&);
+
+#else // defined(STRF_NO_CXX17_COPY_ELISION)
+
+    basic_rope_writer(const basic_rope_writer&) = delete;
+    basic_rope_writer(basic_rope_writer&&) = delete;
+
+#endif // defined(STRF_NO_CXX17_COPY_ELISION)
+
+    ~basic_rope_writer()
+    {
+        (void) basic_rope<CharT, ChunkSize>{_first, 0, 0};
+    }
+
+    // Does not copy the content written so far. Instead,
+    // links a new chunk at the end of the list.
+    void recycle() override
+    {
+        std::size_t s = this->pos() - _last->data;
+        if (s != 0) {
+            _last->size = s;
+            _size += s;
+            ++ _segments_count;
+            auto c = _pool::acquire_chunk();
+            _last->next = c;
+            _before_last = _last;
+            _last = c;
+        }
+        this->set_pos(_last->data);
+        this->set_end(_last->data + ChunkSize);
+    }
+
+    bool do_reserve_contiguous(std::size_t s) override
+    {
+        if (s <= ChunkSize) {
+            recycle();
+            return true;
+        }
+        return false;
+    }
+
+    basic_rope<CharT, ChunkSize> finish()
+    {
+        std::size_t s = this->pos() - _last->data;
+        _last->size = s;
+        _size += s;
+        _segments_count += (s != 0);
+        this->set_good(false);
+        this->set_pos(strf::outbuf_garbage_buf<CharT>());
+        this->set_end(strf::outbuf_garbage_buf_end<CharT>());
+        auto first = _first;
+        _first = nullptr;
+        if (s == 0) {
+            // remove the empty last chunk
+            if (_before_last != nullptr) {
+                _before_last->next = nullptr;
+            } else {
+                first = nullptr;
+            }
+            _pool::release_chunk(_last);
+        }
+        return {first, _size, _segments_count};
+    }
+
+private:
+
+    _chunk* _first;
+    _chunk* _last;
+    _chunk* _before_last = nullptr;
+    std::size_t _size = 0;
+    std::size_t _segments_count = 0;
+};
+
+using rope = basic_rope<char>;
+using u16rope = basic_rope<char16_t>;
+using u32rope = basic_rope<char32_t>;
+using wrope = basic_rope<wchar_t>;
+
+namespace detail {
+
+template <typename CharT, std::size_t ChunkSize>
+class basic_rope_writer_creator
+{
+public:
+
+    using char_type = CharT;
+    using outbuf_type = strf::basic_rope_writer<CharT, ChunkSize>;
+    using finish_type = strf::basic_rope<CharT, ChunkSize>;
+
+    outbuf_type create() const
+    {
+        return outbuf_type{};
+    }
+};
+
+} // namespace detail
+
+template <typename CharT, std::size_t ChunkSize = 4096>
+constexpr strf::destination_no_reserve
+    < strf::detail::basic_rope_writer_creator<CharT, ChunkSize> >
+    to_basic_rope{};
+
+constexpr strf::destination_no_reserve
+    < strf::detail::basic_rope_writer_creator<char, 4096> >
+    to_rope{};
+
+constexpr strf::destination_no_reserve
+    < strf::detail::basic_rope_writer_creator<char16_t, 4096> >
+    to_u16rope{};
+
+constexpr strf::destination_no_reserve
+    < strf::detail::basic_rope_writer_creator<char32_t, 4096> >
+    to_u32rope{};
+
+constexpr strf::destination_no_reserve
+    < strf::detail::basic_rope_writer_creator<wchar_t, 4096> >
+    to_wrope{};
+
+} // namespace strf
+
+#endif  // STRF_DETAIL_OUTPUT_TYPES_ROPE_HPP
+
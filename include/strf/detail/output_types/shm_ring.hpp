@@ -0,0 +1,497 @@
+#ifndef STRF_DETAIL_OUTPUT_TYPES_SHM_RING_HPP
+#define STRF_DETAIL_OUTPUT_TYPES_SHM_RING_HPP
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <strf/destination.hpp>
+
+namespace strf {
+
+namespace detail {
+
+static_assert( ATOMIC_INT_LOCK_FREE == 2 && ATOMIC_LLONG_LOCK_FREE == 2
+             , "shm_ring requires lock-free atomics, since they are shared between processes" );
+
+// The beginning of the shared memory segment. The data area follows it.
+struct shm_ring_header
+{
+    static constexpr std::uint64_t magic_value = 0x676e6972666d6873; // "shmfring"
+
+    std::atomic<std::uint64_t> magic;
+    std::uint64_t capacity;
+    std::atomic<std::uint64_t> dropped_count;
+    std::atomic<std::uint64_t> abandoned_count;
+
+    // Incremented by the producers to claim space
+    alignas(64) std::atomic<std::uint64_t> reserve_pos;
+
+    // Incremented by the consumer when it releases space
+    alignas(64) std::atomic<std::uint64_t> read_pos;
+};
+
+constexpr std::size_t shm_ring_data_offset
+    = (sizeof(shm_ring_header) + 63) & ~static_cast<std::size_t>(63);
+
+} // namespace detail
+
+// A multiple-producer single-consumer queue of records, in a POSIX shared
+// memory segment. Each record starts with an 8 bytes header, which is an
+// atomic 64-bit integer. Its high 32 bits contain the length of the record
+// ( header and padding included ), stored when the record is claimed. Its
+// low 32 bits are zero until the record is committed. Afterwards they
+// contain the size of the content plus one, or 0xFFFFFFFF for a padding
+// record, that fills the end of the data area when a record would not
+// fit there. Records are aligned to 8 bytes, and they are never split.
+//
+// Producers never block: push() fails when there is no room for the
+// record, and increments dropped_count(). The consumer zeroes the space
+// it releases, so that the producers never see stale record headers.
+//
+// A producer that dies after claiming a record and before committing
+// it stalls the consumer, which consumes the records in order. Hence
+// the consumer can pass a timeout to consume(), after which such a
+// record is skipped, and abandoned_count() is incremented. A producer
+// that is merely delayed longer than that timeout has its record
+// discarded: push() then returns false. The timeout must be much longer
+// than such delays, since the delayed producer may still be copying its
+// content into the released space. A producer that dies in the few
+// instructions between claiming the space and storing its length can
+// not be detected, and still stalls the consumer.
+class shm_ring
+{
+public:
+
+    static constexpr std::size_t record_header_size = 8;
+
+    shm_ring() noexcept = default;
+
+    shm_ring(shm_ring&& other) noexcept
+        : _header(other._header)
+        , _data(other._data)
+        , _capacity(other._capacity)
+        , _mapping_size(other._mapping_size)
+        , _stalled_pos(other._stalled_pos)
+        , _stalled_since(other._stalled_since)
+    {
+        other._header = nullptr;
+        other._data = nullptr;
+        other._capacity = 0;
+        other._mapping_size = 0;
+    }
+
+    shm_ring& operator=(shm_ring&& other) noexcept
+    {
+        if (this != &other) {
+            _unmap();
+            _header = other._header;
+            _data = other._data;
+            _capacity = other._capacity;
+            _mapping_size = other._mapping_size;
+            _stalled_pos = other._stalled_pos;
+            _stalled_since = other._stalled_since;
+            other._header = nullptr;
+            other._data = nullptr;
+            other._capacity = 0;
+            other._mapping_size = 0;
+        }
+        return *this;
+    }
+
+    shm_ring(const shm_ring&) = delete;
+    shm_ring& operator=(const shm_ring&) = delete;
+
+    ~shm_ring()
+    {
+        _unmap();
+    }
+
+    // Creates a new segment, whose data area has at least capacity bytes
+    // ( rounded up to a power of two ). Fails if the segment already exists.
+    static shm_ring create(const char* name, std::size_t capacity) noexcept
+    {
+        std::size_t cap = 64;
+        while (cap < capacity) {
+            cap *= 2;
+        }
+        shm_ring ring;
+        int fd = ::shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+        if (fd < 0) {
+            return ring;
+        }
+        std::size_t size = strf::detail::shm_ring_data_offset + cap;
+        if (0 == ::ftruncate(fd, static_cast<off_t>(size))) {
+            ring._map(fd, size);
+        }
+        ::close(fd);
+        if (ring._header == nullptr) {
+            ::shm_unlink(name);
+            return ring;
+        }
+        // The segment is zero-filled by ftruncate
+        auto* h = ring._header;
+        h->capacity = cap;
+        ring._capacity = cap;
+        h->magic.store(strf::detail::shm_ring_header::magic_value, std::memory_order_release);
+        return ring;
+    }
+
+    // Maps a segment previously created by create()
+    static shm_ring open(const char* name) noexcept
+    {
+        shm_ring ring;
+        int fd = ::shm_open(name, O_RDWR, 0);
+        if (fd < 0) {
+            return ring;
+        }
+        struct ::stat st;
+        if ( 0 == ::fstat(fd, &st)
+          && static_cast<std::size_t>(st.st_size) > strf::detail::shm_ring_data_offset ) {
+            ring._map(fd, static_cast<std::size_t>(st.st_size));
+        }
+        ::close(fd);
+        auto* h = ring._header;
+        if (h != nullptr) {
+            if ( h->magic.load(std::memory_order_acquire)
+                   == strf::detail::shm_ring_header::magic_value
+              && h->capacity + strf::detail::shm_ring_data_offset == ring._mapping_size ) {
+                ring._capacity = static_cast<std::size_t>(h->capacity);
+            } else {
+                ring._unmap();
+            }
+        }
+        return ring;
+    }
+
+    static bool unlink(const char* name) noexcept
+    {
+        return 0 == ::shm_unlink(name);
+    }
+
+    bool valid() const noexcept
+    {
+        return _header != nullptr;
+    }
+
+    std::size_t capacity() const noexcept
+    {
+        return _capacity;
+    }
+
+    // The maximum size of the content of a record
+    std::size_t max_record_size() const noexcept
+    {
+        return _capacity < record_header_size ? 0 : _capacity - record_header_size;
+    }
+
+    // Number of records that could not be pushed because the ring was full
+    std::uint64_t dropped_count() const noexcept
+    {
+        return _header->dropped_count.load(std::memory_order_relaxed);
+    }
+
+    // Number of records skipped by consume() because they were
+    // not committed before the timeout
+    std::uint64_t abandoned_count() const noexcept
+    {
+        return _header->abandoned_count.load(std::memory_order_relaxed);
+    }
+
+    // Copies size bytes into a new record, and commits it.
+    // Safe to be called concurrently, from any process.
+    bool push(const void* content, std::size_t size) noexcept
+    {
+        char* rec = _claim(size);
+        if (rec == nullptr) {
+            return false;
+        }
+        std::memcpy(rec + record_header_size, content, size);
+        // Fails if the consumer has abandoned the record
+        std::uint64_t claimed = _claimed_header(_record_length(size));
+        return _record_header(rec).compare_exchange_strong
+            ( claimed, claimed | (size + 1)
+            , std::memory_order_release
+            , std::memory_order_relaxed );
+    }
+
+    // Calls f(const char* content, std::size_t size) for each committed
+    // record, in the order they were claimed, and releases them. Stops at
+    // the first record that is not committed yet. Returns the number of
+    // records consumed. Only one consumer may call it at a time.
+    template <typename F>
+    std::size_t consume(F&& f)
+    {
+        return _consume(f, nullptr);
+    }
+
+    // Like consume(f), except that a record that has been claimed but not
+    // committed since at least abandon_timeout is skipped. The time is
+    // measured from the first call of consume that finds it uncommitted.
+    template <typename F>
+    std::size_t consume(F&& f, std::chrono::steady_clock::duration abandon_timeout)
+    {
+        return _consume(f, &abandon_timeout);
+    }
+
+private:
+
+    static constexpr std::uint32_t _padding_state = 0xFFFFFFFF;
+    static constexpr std::uint64_t _state_mask = 0xFFFFFFFF;
+    static constexpr std::size_t _max_size = 0xFFFFFFF0 - record_header_size;
+
+    template <typename F>
+    std::size_t _consume(F& f, const std::chrono::steady_clock::duration* abandon_timeout)
+    {
+        std::size_t count = 0;
+        std::uint64_t pos = _header->read_pos.load(std::memory_order_relaxed);
+        while (true) {
+            std::size_t offset = static_cast<std::size_t>(pos & (_capacity - 1));
+            char* rec = _data + offset;
+            std::uint64_t header = _record_header(rec).load(std::memory_order_acquire);
+            std::uint64_t state = header & _state_mask;
+            std::size_t len;
+            if (state == 0) {
+                std::size_t claimed_len = static_cast<std::size_t>(header >> 32);
+                if ( claimed_len == 0 || abandon_timeout == nullptr
+                  || ! _abandon(rec, pos, header, *abandon_timeout) ) {
+                    break;
+                }
+                len = claimed_len;
+            } else if (state == _padding_state) {
+                len = _capacity - offset;
+            } else {
+                std::size_t size = static_cast<std::size_t>(state - 1);
+                f(static_cast<const char*>(rec + record_header_size), size);
+                len = _record_length(size);
+                ++count;
+            }
+            _record_header(rec).store(0, std::memory_order_relaxed);
+            std::memset(rec + record_header_size, 0, len - record_header_size);
+            pos += len;
+            _header->read_pos.store(pos, std::memory_order_release);
+        }
+        return count;
+    }
+
+    // Returns true if the uncommitted record at pos is to be skipped
+    bool _abandon
+        ( char* rec
+        , std::uint64_t pos
+        , std::uint64_t header
+        , std::chrono::steady_clock::duration timeout ) noexcept
+    {
+        auto now = std::chrono::steady_clock::now();
+        if (_stalled_pos != pos) {
+            _stalled_pos = pos;
+            _stalled_since = now;
+        }
+        if (now - _stalled_since < timeout) {
+            return false;
+        }
+        // Fails if the producer has just committed it
+        if ( ! _record_header(rec).compare_exchange_strong
+                 ( header, 0
+                 , std::memory_order_acquire
+                 , std::memory_order_relaxed ) ) {
+            return false;
+        }
+        _header->abandoned_count.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    static std::size_t _record_length(std::size_t size) noexcept
+    {
+        return (record_header_size + size + 7) & ~static_cast<std::size_t>(7);
+    }
+
+    static std::uint64_t _claimed_header(std::size_t len) noexcept
+    {
+        return static_cast<std::uint64_t>(len) << 32;
+    }
+
+    static std::atomic<std::uint64_t>& _record_header(char* rec) noexcept
+    {
+        return *reinterpret_cast<std::atomic<std::uint64_t>*>(rec);
+    }
+
+    char* _claim(std::size_t size) noexcept
+    {
+        if (size > max_record_size() || size > _max_size) {
+            _header->dropped_count.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        const std::size_t need = _record_length(size);
+        std::uint64_t pos = _header->reserve_pos.load(std::memory_order_relaxed);
+        std::size_t offset, pad;
+        do {
+            offset = static_cast<std::size_t>(pos & (_capacity - 1));
+            pad = _capacity - offset < need ? _capacity - offset : 0;
+            auto read_pos = _header->read_pos.load(std::memory_order_acquire);
+            if (pos + pad + need - read_pos > _capacity) {
+                _header->dropped_count.fetch_add(1, std::memory_order_relaxed);
+                return nullptr;
+            }
+        } while ( ! _header->reserve_pos.compare_exchange_weak
+                    ( pos, pos + pad + need
+                    , std::memory_order_acq_rel
+                    , std::memory_order_relaxed ) );
+        char* rec = _data + offset;
+        if (pad != 0) {
+            _record_header(rec).store
+                ( _claimed_header(pad) | _padding_state
+                , std::memory_order_release );
+            rec = _data;
+        }
+        _record_header(rec).store(_claimed_header(need), std::memory_order_relaxed);
+        return rec;
+    }
+
+    void _map(int fd, std::size_t size) noexcept
+    {
+        void* p = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (p != MAP_FAILED) {
+            _header = static_cast<strf::detail::shm_ring_header*>(p);
+            _data = static_cast<char*>(p) + strf::detail::shm_ring_data_offset;
+            _mapping_size = size;
+        }
+    }
+
+    void _unmap() noexcept
+    {
+        if (_header != nullptr) {
+            ::munmap(_header, _mapping_size);
+            _header = nullptr;
+            _data = nullptr;
+            _capacity = 0;
+            _mapping_size = 0;
+        }
+    }
+
+    strf::detail::shm_ring_header* _header = nullptr;
+    char* _data = nullptr;
+    std::size_t _capacity = 0;
+    std::size_t _mapping_size = 0;
+
+    // Only used by the consumer
+    std::uint64_t _stalled_pos = ~static_cast<std::uint64_t>(0);
+    std::chrono::steady_clock::time_point _stalled_since;
+};
+
+// Collects the content of one record in an internal buffer of BufferSize
+// characters, and pushes it into the ring in finish(). Content that does
+// not fit in the buffer is not written: finish() then returns a failure.
+template <typename CharT, std::size_t BufferSize = 1024>
+class basic_shm_ring_writer final: public strf::basic_outbuf_noexcept<CharT>
+{
+    static_assert( BufferSize >= strf::min_size_after_recycle<CharT>()
+                 , "BufferSize must not be less than min_size_after_recycle" );
+
+public:
+
+    explicit basic_shm_ring_writer(strf::shm_ring& ring) noexcept
+        : strf::basic_outbuf_noexcept<CharT>(_buf, BufferSize)
+        , _ring(ring)
+    {
+    }
+
+    basic_shm_ring_writer() = delete;
+
+#if defined(STRF_NO_CXX17_COPY_ELISION)
+
+    basic_shm_ring_writer(basic_shm_ring_writer&&);
+
+#else // defined(STRF_NO_CXX17_COPY_ELISION)
+
+    basic_shm_ring_writer(const basic_shm_ring_writer&) = delete;
+    basic_shm_ring_writer(basic_shm_ring_writer&&) = delete;
+
+#endif // defined(STRF_NO_CXX17_COPY_ELISION)
+
+    // The content does not fit in the buffer, so the record is discarded
+    void recycle() noexcept override
+    {
+        this->set_good(false);
+        this->set_pos(strf::outbuf_garbage_buf<CharT>());
+        this->set_end(strf::outbuf_garbage_buf_end<CharT>());
+    }
+
+    struct result
+    {
+        std::size_t count;
+        bool success;
+    };
+
+    result finish() noexcept
+    {
+        std::size_t count = 0;
+        bool g = this->good();
+        if (g) {
+            count = this->pos() - _buf;
+            g = _ring.valid() && _ring.push(_buf, count * sizeof(CharT));
+        }
+        this->set_good(false);
+        this->set_pos(strf::outbuf_garbage_buf<CharT>());
+        this->set_end(strf::outbuf_garbage_buf_end<CharT>());
+        return {g ? count : 0, g};
+    }
+
+private:
+
+    strf::shm_ring& _ring;
+    CharT _buf[BufferSize];
+};
+
+template <std::size_t BufferSize = 1024>
+using shm_ring_writer = strf::basic_shm_ring_writer<char, BufferSize>;
+
+namespace detail {
+
+template <typename CharT, std::size_t BufferSize>
+class shm_ring_writer_creator
+{
+public:
+
+    using char_type = CharT;
+    using outbuf_type = strf::basic_shm_ring_writer<CharT, BufferSize>;
+    using finish_type = typename outbuf_type::result;
+
+    explicit shm_ring_writer_creator(strf::shm_ring& ring) noexcept
+        : _ring(ring)
+    {
+    }
+
+    shm_ring_writer_creator(const shm_ring_writer_creator&) = default;
+
+    outbuf_type create() const noexcept
+    {
+        return outbuf_type{_ring};
+    }
+
+private:
+
+    strf::shm_ring& _ring;
+};
+
+} // namespace detail
+
+template <typename CharT = char, std::size_t BufferSize = 1024>
+inline auto to_shm_ring(strf::shm_ring& ring) noexcept
+{
+    return strf::destination_no_reserve
+        < strf::detail::shm_ring_writer_creator<CharT, BufferSize> >
+        (ring);
+}
+
+} // namespace strf
+
+#endif  // STRF_DETAIL_OUTPUT_TYPES_SHM_RING_HPP
+
@@ -0,0 +1,324 @@
+#ifndef STRF_DETAIL_OUTPUT_TYPES_SMALL_STRING_HPP
+#define STRF_DETAIL_OUTPUT_TYPES_SMALL_STRING_HPP
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <strf/outbuf.hpp>
+#include <strf/destination.hpp>
+#include <strf/detail/output_types/std_string.hpp>
+#include <memory>
+
+namespace strf {
+
+template <typename CharT, std::size_t N>
+class basic_small_string_maker;
+
+// A string that keeps up to N characters ( plus the termination
+// character ) inside the object itself, and only allocates memory
+// when it is longer than that.
+template <typename CharT, std::size_t N>
+class basic_small_string
+{
+    static_assert(N > 0, "inline capacity must not be zero");
+
+public:
+
+    using value_type = CharT;
+    using size_type = std::size_t;
+    using const_iterator = const CharT*;
+
+    static constexpr std::size_t inline_capacity = N;
+
+    basic_small_string() noexcept
+    {
+        _inline[0] = CharT();
+    }
+
+    basic_small_string(const CharT* str, std::size_t len)
+    {
+        _assign(str, len);
+    }
+
+    basic_small_string(const basic_small_string& other)
+    {
+        _assign(other._ptr, other._size);
+    }
+
+    basic_small_string(basic_small_string&& other) noexcept
+    {
+        _steal(other);
+    }
+
+    basic_small_string& operator=(const basic_small_string& other)
+    {
+        if (this != &other) {
+            _assign(other._ptr, other._size);
+        }
+        return *this;
+    }
+
+    basic_small_string& operator=(basic_small_string&& other) noexcept
+    {
+        if (this != &other) {
+            _free();
+            _steal(other);
+        }
+        return *this;
+    }
+
+    ~basic_small_string()
+    {
+        _free();
+    }
+
+    const CharT* data() const noexcept
+    {
+        return _ptr;
+    }
+    const CharT* c_str() const noexcept
+    {
+        return _ptr;
+    }
+    std::size_t size() const noexcept
+    {
+        return _size;
+    }
+    std::size_t length() const noexcept
+    {
+        return _size;
+    }
+    bool empty() const noexcept
+    {
+        return _size == 0;
+    }
+    // Number of characters it can hold without allocating memory
+    std::size_t capacity() const noexcept
+    {
+        return _cap;
+    }
+    // Whether the characters are stored inside the object
+    bool is_inline() const noexcept
+    {
+        return _ptr == _inline;
+    }
+    const CharT* begin() const noexcept
+    {
+        return _ptr;
+    }
+    const CharT* end() const noexcept
+    {
+        return _ptr + _size;
+    }
+    const CharT& operator[](std::size_t i) const noexcept
+    {
+        return _ptr[i];
+    }
+
+#if defined(STRF_HAS_STD_STRING_VIEW)
+
+    operator std::basic_string_view<CharT> () const noexcept
+    {
+        return {_ptr, _size};
+    }
+
+#endif // defined(STRF_HAS_STD_STRING_VIEW)
+
+    friend bool operator==(const basic_small_string& a, const basic_small_string& b) noexcept
+    {
+        return a._size == b._size
+            && std::char_traits<CharT>::compare(a._ptr, b._ptr, a._size) == 0;
+    }
+    friend bool operator!=(const basic_small_string& a, const basic_small_string& b) noexcept
+    {
+        return ! (a == b);
+    }
+
+private:
+
+    friend class basic_small_string_maker<CharT, N>;
+
+    // Takes ownership of a heap buffer of cap + 1 characters
+    basic_small_string(CharT* heap_buf, std::size_t size, std::size_t cap) noexcept
+        : _ptr(heap_buf)
+        , _size(size)
+        , _cap(cap)
+    {
+    }
+
+    void _assign(const CharT* str, std::size_t len)
+    {
+        if (len > _cap) {
+            CharT* p = new CharT[len + 1];
+            _free();
+            _ptr = p;
+            _cap = len;
+        }
+        strf::detail::str_copy_n(_ptr, str, len);
+        _ptr[len] = CharT();
+        _size = len;
+    }
+
+    void _steal(basic_small_string& other) noexcept
+    {
+        if (other.is_inline()) {
+            _ptr = _inline;
+            _cap = N;
+            strf::detail::str_copy_n(_inline, other._inline, other._size + 1);
+        } else {
+            _ptr = other._ptr;
+            _cap = other._cap;
+            other._ptr = other._inline;
+            other._cap = N;
+            other._inline[0] = CharT();
+        }
+        _size = other._size;
+        other._size = 0;
+    }
+
+    void _free() noexcept
+    {
+        if (! is_inline()) {
+            delete [] _ptr;
+            _ptr = _inline;
+            _cap = N;
+        }
+    }
+
+    CharT* _ptr = _inline;
+    std::size_t _size = 0;
+    std::size_t _cap = N;
+    CharT _inline[N + 1];
+};
+
+template <std::size_t N>
+using small_string = basic_small_string<char, N>;
+
+// Writes into a buffer of N characters inside itself, and only moves
+// to the heap when the content does not fit there.
+template <typename CharT, std::size_t N>
+class basic_small_string_maker final: public strf::basic_outbuf<CharT>
+{
+public:
+
+    basic_small_string_maker()
+        : strf::basic_outbuf<CharT>(_inline, N)
+    {
+    }
+
+    explicit basic_small_string_maker(std::size_t size)
+        : strf::basic_outbuf<CharT>(_inline, N)
+    {
+        if (size > N) {
+            _to_heap(0, size + 1);
+        }
+    }
+
+#if defined(STRF_NO_CXX17_COPY_ELISION)
+
+    basic_small_string_maker(basic_small_string_maker&&);
+
+#else // defined(STRF_NO_CXX17_COPY_ELISION)
+
+    basic_small_string_maker(const basic_small_string_maker&) = delete;
+    basic_small_string_maker(basic_small_string_maker&&) = delete;
+
+#endif // defined(STRF_NO_CXX17_COPY_ELISION)
+
+    void recycle() override
+    {
+        _grow(strf::min_size_after_recycle<CharT>());
+    }
+
+    bool do_reserve_contiguous(std::size_t s) override
+    {
+        _grow(s);
+        return true;
+    }
+
+    strf::basic_small_string<CharT, N> finish()
+    {
+        this->set_good(false);
+        if ( ! _heap) {
+            return {_inline, static_cast<std::size_t>(this->pos() - _inline)};
+        }
+        if (this->pos() == this->end()) {
+            _grow(1);
+        }
+        std::size_t len = this->pos() - _heap.get();
+        *this->pos() = CharT();
+        this->set_pos(strf::outbuf_garbage_buf<CharT>());
+        this->set_end(strf::outbuf_garbage_buf_end<CharT>());
+        return {_heap.release(), len, _heap_cap - 1};
+    }
+
+private:
+
+    CharT* _begin() noexcept
+    {
+        return _heap ? _heap.get() : _inline;
+    }
+
+    void _grow(std::size_t min_increment)
+    {
+        std::size_t used_size = this->pos() - _begin();
+        // At least doubles, so that the number of reallocations is O(log n)
+        auto new_cap = used_size + (used_size > min_increment ? used_size : min_increment);
+        this->set_good(false);
+        _to_heap(used_size, new_cap);
+        this->set_good(true);
+    }
+
+    void _to_heap(std::size_t used_size, std::size_t new_cap)
+    {
+        std::unique_ptr<CharT[]> new_heap{new CharT[new_cap]};
+        strf::detail::str_copy_n(new_heap.get(), _begin(), used_size);
+        _heap = std::move(new_heap);
+        _heap_cap = new_cap;
+        this->set_pos(_heap.get() + used_size);
+        this->set_end(_heap.get() + new_cap);
+    }
+
+    std::unique_ptr<CharT[]> _heap;
+    std::size_t _heap_cap = 0;
+    CharT _inline[N];
+};
+
+namespace detail {
+
+template <typename CharT, std::size_t N>
+class basic_small_string_maker_creator
+{
+public:
+
+    using char_type = CharT;
+    using outbuf_type = strf::basic_small_string_maker<CharT, N>;
+    using finish_type = strf::basic_small_string<CharT, N>;
+
+    outbuf_type create() const
+    {
+        return outbuf_type{};
+    }
+    outbuf_type create(std::size_t size) const
+    {
+        return outbuf_type{size};
+    }
+};
+
+} // namespace detail
+
+template <typename CharT, std::size_t N>
+constexpr strf::destination_no_reserve
+    < strf::detail::basic_small_string_maker_creator<CharT, N> >
+    to_basic_small_string{};
+
+template <std::size_t N>
+constexpr strf::destination_no_reserve
+    < strf::detail::basic_small_string_maker_creator<char, N> >
+    to_small_string{};
+
+} // namespace strf
+
+#endif  // STRF_DETAIL_OUTPUT_TYPES_SMALL_STRING_HPP
+
@@ -11,15 +11,53 @@
 
 namespace strf {
 
+namespace detail {
+
+// Gives access to the protected functions of std::basic_streambuf
+// that handle the put area.
+template <typename CharT, typename Traits>
+class streambuf_put_area_access: public std::basic_streambuf<CharT, Traits>
+{
+    using _streambuf_type = std::basic_streambuf<CharT, Traits>;
+
+public:
+
+    static CharT* get_pptr(_streambuf_type& sb)
+    {
+        return (sb.*(&streambuf_put_area_access::pptr))();
+    }
+    static CharT* get_epptr(_streambuf_type& sb)
+    {
+        return (sb.*(&streambuf_put_area_access::epptr))();
+    }
+    static void bump_pptr(_streambuf_type& sb, std::size_t count)
+    {
+        constexpr std::size_t max_step = 0x7FFFFFFF;
+        for ( ; count > max_step; count -= max_step) {
+            (sb.*(&streambuf_put_area_access::pbump))(static_cast<int>(max_step));
+        }
+        (sb.*(&streambuf_put_area_access::pbump))(static_cast<int>(count));
+    }
+};
+
+} // namespace detail
+
+// Writes directly into the put area of the streambuf, whenever it has
+// at least min_size_after_recycle characters available. Otherwise,
+// writes into an internal buffer, whose content is passed to sputn.
 template <typename CharT, typename Traits = std::char_traits<CharT> >
 class basic_streambuf_writer final: public strf::basic_outbuf<CharT>
 {
+    using _underlying_char_t = strf::underlying_outbuf_char_type<sizeof(CharT)>;
+    using _access = strf::detail::streambuf_put_area_access<CharT, Traits>;
+
 public:
 
     explicit basic_streambuf_writer(std::basic_streambuf<CharT, Traits>& dest_)
         : strf::basic_outbuf<CharT>(_buf, _buf_size)
         , _dest(dest_)
     {
+        _acquire();
     }
 
     basic_streambuf_writer() = delete;
@@ -41,12 +79,27 @@ public:
 
     void recycle() override
     {
-        std::streamsize count = this->pos() - _buf;
-        this->set_pos(_buf);
-        if (this->good()) {
-            auto count_inc = _dest.sputn(_buf, count);
-            _count += count_inc;
-            this->set_good(count_inc == count);
+        _commit();
+        _acquire();
+    }
+
+    // Content that does not fit in the buffer is passed directly to
+    // sputn, instead of being copied into it 64 characters at a time
+    void write_direct(const _underlying_char_t* ustr, std::size_t len) override
+    {
+        auto str = reinterpret_cast<const CharT*>(ustr);
+        if (len <= this->size()) {
+            strf::detail::str_copy_n(this->pos(), str, len);
+            this->advance(len);
+        } else {
+            _commit();
+            if (this->good()) {
+                auto count = static_cast<std::streamsize>(len);
+                auto count_inc = _dest.sputn(str, count);
+                _count += count_inc;
+                this->set_good(count_inc == count);
+            }
+            _acquire();
         }
     }
 
@@ -58,22 +111,54 @@ public:
 
     result finish()
     {
-        std::streamsize count = this->pos() - _buf;
+        _commit();
         auto g = this->good();
         this->set_pos(_buf);
+        this->set_end(_buf + _buf_size);
         this->set_good(false);
-        if (g) {
-            auto count_inc = _dest.sputn(_buf, count);
-            _count += count_inc;
-            g = (count_inc == count);
-        }
         return {_count, g};
     }
 
 private:
 
+    // Consumes what has been written since the last call to _acquire
+    void _commit()
+    {
+        if (this->good()) {
+            if (_in_put_area) {
+                std::size_t count = this->pos() - _access::get_pptr(_dest);
+                _access::bump_pptr(_dest, count);
+                _count += count;
+            } else {
+                std::streamsize count = this->pos() - _buf;
+                auto count_inc = _dest.sputn(_buf, count);
+                _count += count_inc;
+                this->set_good(count_inc == count);
+            }
+        }
+    }
+
+    void _acquire()
+    {
+        if (this->good()) {
+            auto p = _access::get_pptr(_dest);
+            auto e = _access::get_epptr(_dest);
+            if ( p != nullptr
+              && static_cast<std::size_t>(e - p) >= strf::min_size_after_recycle<CharT>() ) {
+                _in_put_area = true;
+                this->set_pos(p);
+                this->set_end(e);
+                return;
+            }
+        }
+        _in_put_area = false;
+        this->set_pos(_buf);
+        this->set_end(_buf + _buf_size);
+    }
+
     std::basic_streambuf<CharT, Traits>& _dest;
     std::streamsize _count = 0;
+    bool _in_put_area = false;
     static constexpr std::size_t _buf_size
         = strf::min_size_after_recycle<CharT>();
     CharT _buf[_buf_size];
@@ -9,8 +9,75 @@
 #include <strf/destination.hpp>
 #include <string>
 
+#if defined(__has_include)
+#if __has_include(<memory_resource>) && __cplusplus >= 201703L
+#include <memory_resource>
+#endif
+#endif
+
+#if defined(__cpp_lib_memory_resource)
+#define STRF_HAS_STD_PMR
+#endif
+
 namespace strf {
 
+namespace detail {
+
+// Changes the size of str to new_size. When the standard library
+// provides resize_and_overwrite, the characters that are added are left
+// uninitialized, since they are always overwritten afterwards.
+template <typename CharT, typename Traits, typename Allocator>
+inline void string_resize_uninit
+    ( std::basic_string<CharT, Traits, Allocator>& str
+    , std::size_t new_size )
+{
+#if defined(__cpp_lib_string_resize_and_overwrite)
+    str.resize_and_overwrite(new_size, [](CharT*, std::size_t n){ return n; });
+#else
+    str.resize(new_size);
+#endif
+}
+
+// The size a buffer shall have in the next recycle() when
+// used_size characters have already been written into it.
+// It grows geometrically, so that the content is copied
+// a bounded number of times.
+inline std::size_t string_grown_size(std::size_t used_size, std::size_t min_increment)
+{
+    return used_size + (used_size > min_increment ? used_size : min_increment);
+}
+
+// The size a std::basic_string shall be resized to in the next recycle().
+// Without resize_and_overwrite, resize() zero-fills the new characters.
+// So the string is only enlarged by a bounded amount, which limits
+// how many of them are zero-filled but never written. This is only
+// suitable for resize(), since it still grows the capacity geometrically.
+inline std::size_t string_resized_size(std::size_t used_size, std::size_t min_increment)
+{
+#if defined(__cpp_lib_string_resize_and_overwrite)
+    return strf::detail::string_grown_size(used_size, min_increment);
+#else
+    constexpr std::size_t increment = 512;
+    return used_size + (min_increment > increment ? min_increment : increment);
+#endif
+}
+
+// The size to give to str when an outbuf starts writing at its end,
+// without causing a reallocation.
+template <typename CharT, typename Traits, typename Allocator>
+inline std::size_t string_initial_size
+    ( const std::basic_string<CharT, Traits, Allocator>& str )
+{
+#if defined(__cpp_lib_string_resize_and_overwrite)
+    return str.capacity();
+#else
+    std::size_t size = str.size() + strf::min_size_after_recycle<CharT>();
+    return size < str.capacity() ? size : str.capacity();
+#endif
+}
+
+} // namespace detail
+
 template < typename CharT
          , typename Traits = std::char_traits<CharT>
          , typename Allocator = std::allocator<CharT> >
@@ -21,16 +88,18 @@ class basic_string_appender final: public strf::basic_outbuf<CharT>
 public:
 
     basic_string_appender(_string_type& str)
-        : strf::basic_outbuf<CharT>(_buf, _buf_size)
+        : strf::basic_outbuf<CharT>(nullptr, nullptr)
         , _str(str)
     {
+        _init();
     }
     basic_string_appender( _string_type& str
                          , std::size_t size )
-        : strf::basic_outbuf<CharT>(_buf, _buf_size)
+        : strf::basic_outbuf<CharT>(nullptr, nullptr)
         , _str(str)
     {
-        _str.reserve(size);
+        _str.reserve(_str.size() + size);
+        _init();
     }
 
 #if defined(STRF_NO_CXX17_COPY_ELISION)
@@ -44,32 +113,59 @@ public:
 
 #endif // defined(STRF_NO_CXX17_COPY_ELISION)
 
-    void recycle() override
+    ~basic_string_appender()
     {
-        auto * p = this->pos();
-        this->set_pos(_buf);
-        if (this->good()) {
-            this->set_good(false);
-            _str.append(_buf, p);
-            this->set_good(true);
+        if ( ! _finished) {
+            _str.resize(this->pos() - _str.data());
         }
     }
 
+    void recycle() override
+    {
+        _grow(strf::min_size_after_recycle<CharT>());
+    }
+
+    bool do_reserve_contiguous(std::size_t s) override
+    {
+        _grow(s);
+        return true;
+    }
+
     void finish()
     {
-        auto * p = this->pos();
-        if (this->good()) {
-            this->set_good(false);
-            _str.append(_buf, p);
-        }
+        _str.resize(this->pos() - _str.data());
+        _finished = true;
+        this->set_good(false);
     }
 
 private:
 
+    void _grow(std::size_t min_increment)
+    {
+        std::size_t used_size = this->pos() - _str.data();
+        auto new_size = strf::detail::string_resized_size
+            ( used_size - _initial_size, min_increment );
+        new_size += _initial_size;
+        this->set_good(false);
+        strf::detail::string_resize_uninit(_str, new_size);
+        this->set_good(true);
+        auto * p = &*_str.begin();
+        this->set_pos(p + used_size);
+        this->set_end(p + new_size);
+    }
+
+    void _init()
+    {
+        _initial_size = _str.size();
+        strf::detail::string_resize_uninit(_str, strf::detail::string_initial_size(_str));
+        auto * p = &*_str.begin();
+        this->set_pos(p + _initial_size);
+        this->set_end(p + _str.size());
+    }
+
     _string_type& _str;
-    static constexpr std::size_t _buf_size
-        = strf::min_size_after_recycle<CharT>();
-    CharT _buf[_buf_size];
+    std::size_t _initial_size = 0;
+    bool _finished = false;
 };
 
 template < typename CharT
@@ -81,8 +177,21 @@ class basic_string_maker final: public strf::basic_outbuf<CharT>
 
 public:
 
-    basic_string_maker() : strf::basic_outbuf<CharT>(_buf, _buf_size)
+    basic_string_maker()
+        : basic_string_maker(Allocator())
+    {
+    }
+
+    explicit basic_string_maker(const Allocator& a)
+        : strf::basic_outbuf<CharT>(nullptr, nullptr)
+        , _str(a)
     {
+        // Start writing in the space that the string already has
+        // ( the small-string-optimization area, usually ).
+        strf::detail::string_resize_uninit(_str, strf::detail::string_initial_size(_str));
+        auto * p = &*_str.begin();
+        this->set_pos(p);
+        this->set_end(p + _str.size());
     }
 
 #if defined(STRF_NO_CXX17_COPY_ELISION)
@@ -100,31 +209,37 @@ public:
 
     void recycle() override
     {
-        auto * p = this->pos();
-        this->set_pos(_buf);
-        if (this->good()) {
-            this->set_good(false);
-            _str.append(_buf, p);
-            this->set_good(true);
-        }
+        _grow(strf::min_size_after_recycle<CharT>());
+    }
+
+    bool do_reserve_contiguous(std::size_t s) override
+    {
+        _grow(s);
+        return true;
     }
 
     _string_type finish()
     {
-        auto * p = this->pos();
-        if (this->good()) {
-            this->set_good(false);
-            _str.append(_buf, p);
-        }
+        _str.resize(this->pos() - _str.data());
+        this->set_good(false);
         return std::move(_str);
     }
 
 private:
 
+    void _grow(std::size_t min_increment)
+    {
+        std::size_t used_size = this->pos() - _str.data();
+        auto new_size = strf::detail::string_resized_size(used_size, min_increment);
+        this->set_good(false);
+        strf::detail::string_resize_uninit(_str, new_size);
+        this->set_good(true);
+        auto * p = &*_str.begin();
+        this->set_pos(p + used_size);
+        this->set_end(p + new_size);
+    }
+
     _string_type _str;
-    static constexpr std::size_t _buf_size
-        = strf::min_size_after_recycle<CharT>();
-    CharT _buf[_buf_size];
 };
 
 template < typename CharT
@@ -135,10 +250,11 @@ class basic_pre_sized_string_maker final
 {
 public:
 
-    basic_pre_sized_string_maker(std::size_t count)
+    basic_pre_sized_string_maker(std::size_t count, const Allocator& a = Allocator())
         : strf::basic_outbuf<CharT>(nullptr, nullptr)
-        , _str(count, (CharT)0)
+        , _str(a)
     {
+        strf::detail::string_resize_uninit(_str, count);
         this->set_pos(&*_str.begin());
         this->set_end(&*_str.begin() + count);
     }
@@ -156,13 +272,13 @@ public:
 
     void recycle() override
     {
-        std::size_t original_size = this->pos() - _str.data();
-        auto append_size = std::max
-            ( original_size
-            , strf::min_size_after_recycle<CharT>() );
-        _str.append(append_size, (CharT)0);
-        this->set_pos(&*_str.begin() + original_size);
-        this->set_end(&*_str.begin() + original_size + append_size);
+        _grow(strf::min_size_after_recycle<CharT>());
+    }
+
+    bool do_reserve_contiguous(std::size_t s) override
+    {
+        _grow(s);
+        return true;
     }
 
     std::basic_string<CharT, Traits, Allocator> finish()
@@ -173,6 +289,15 @@ public:
 
 private:
 
+    void _grow(std::size_t min_increment)
+    {
+        std::size_t original_size = this->pos() - _str.data();
+        auto new_size = strf::detail::string_resized_size(original_size, min_increment);
+        strf::detail::string_resize_uninit(_str, new_size);
+        this->set_pos(&*_str.begin() + original_size);
+        this->set_end(&*_str.begin() + new_size);
+    }
+
     std::basic_string<CharT, Traits, Allocator> _str;
 };
 
@@ -255,6 +380,37 @@ public:
     }
 };
 
+template <typename CharT, typename Traits, typename Allocator>
+class basic_string_maker_with_allocator_creator
+{
+public:
+
+    using char_type = CharT;
+    using finish_type = std::basic_string<CharT, Traits, Allocator>;
+
+    explicit basic_string_maker_with_allocator_creator(const Allocator& a)
+        : _alloc(a)
+    {
+    }
+
+    basic_string_maker_with_allocator_creator
+        ( const basic_string_maker_with_allocator_creator& ) = default;
+
+    strf::basic_string_maker<CharT, Traits, Allocator> create() const
+    {
+        return strf::basic_string_maker<CharT, Traits, Allocator>{_alloc};
+    }
+    strf::basic_pre_sized_string_maker<CharT, Traits, Allocator>
+    create(std::size_t size) const
+    {
+        return strf::basic_pre_sized_string_maker<CharT, Traits, Allocator>{size, _alloc};
+    }
+
+private:
+
+    Allocator _alloc;
+};
+
 }
 
 template <typename CharT, typename Traits, typename Allocator>
@@ -279,6 +435,33 @@ constexpr strf::destination_no_reserve
     < strf::detail::basic_string_maker_creator<CharT, Traits, Allocator> >
     to_basic_string{};
 
+// Creates a string that uses a copy of the given allocator
+template <typename Allocator>
+auto to_basic_string_with_allocator(const Allocator& a)
+{
+    using char_type = typename Allocator::value_type;
+    return strf::destination_no_reserve
+        < strf::detail::basic_string_maker_with_allocator_creator
+            < char_type, std::char_traits<char_type>, Allocator > >
+        { a };
+}
+
+#if defined(STRF_HAS_STD_PMR)
+
+template <typename CharT>
+auto to_basic_pmr_string(std::pmr::memory_resource* mr)
+{
+    return strf::to_basic_string_with_allocator
+        ( std::pmr::polymorphic_allocator<CharT>{mr} );
+}
+
+inline auto to_pmr_string(std::pmr::memory_resource* mr)
+{
+    return strf::to_basic_pmr_string<char>(mr);
+}
+
+#endif // defined(STRF_HAS_STD_PMR)
+
 #if defined(__cpp_char8_t)
 
 constexpr strf::destination_no_reserve
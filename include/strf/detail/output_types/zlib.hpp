@@ -0,0 +1,326 @@
+#ifndef STRF_DETAIL_OUTPUT_TYPES_ZLIB_HPP
+#define STRF_DETAIL_OUTPUT_TYPES_ZLIB_HPP
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+// This header requires zlib, and is therefore not included by <strf.hpp>.
+
+#include <strf/detail/output_types/posix_fd.hpp>
+#include <cstdio>
+#include <memory>
+#include <zlib.h>
+
+namespace strf {
+
+enum class zlib_format
+{
+    gzip,    // gzip header and trailer ( RFC 1952 )
+    zlib,    // zlib header and trailer ( RFC 1950 )
+    deflate  // raw deflate data ( RFC 1951 )
+};
+
+namespace detail {
+
+// Where the compressed bytes go: either a FILE* or a file descriptor
+class zlib_sink
+{
+public:
+
+    explicit zlib_sink(std::FILE* file) noexcept
+        : _file(file)
+    {
+    }
+    explicit zlib_sink(int fd) noexcept
+        : _fd(fd)
+    {
+    }
+
+    bool write(const void* data, std::size_t size) noexcept
+    {
+        if (_file != nullptr) {
+            return size == std::fwrite(data, 1, size, _file);
+        }
+        std::size_t written = 0;
+        ::iovec iov[1] = {{const_cast<void*>(data), size}};
+        return strf::detail::posix_writev_all(_fd, iov, 1, written);
+    }
+
+private:
+
+    std::FILE* _file = nullptr;
+    int _fd = -1;
+};
+
+inline int zlib_window_bits(strf::zlib_format format) noexcept
+{
+    switch (format) {
+        case strf::zlib_format::zlib:    return MAX_WBITS;
+        case strf::zlib_format::deflate: return -MAX_WBITS;
+        default:                         return MAX_WBITS + 16;
+    }
+}
+
+} // namespace detail
+
+// Compresses the content with zlib while it is written. Whenever the
+// buffer of buffer_size characters gets full, its content is fed into
+// the deflate stream, and the compressed bytes are written into the
+// FILE* or file descriptor. finish() flushes the stream and its trailer.
+//
+// This is the way to compress content printed in many calls into a
+// single stream: keep a writer alive, print into it with strf::to(writer),
+// and call finish() at the end.
+template <typename CharT>
+class basic_zlib_writer final: public strf::basic_outbuf_noexcept<CharT>
+{
+    using _underlying_char_t = strf::underlying_outbuf_char_type<sizeof(CharT)>;
+
+public:
+
+    static constexpr std::size_t default_buffer_size = 0x10000;
+
+    // A larger buffer does not improve compression, since the
+    // deflate window is 32 KiB
+    static constexpr std::size_t max_reserved_buffer_size = 0x10000;
+
+    basic_zlib_writer
+        ( std::FILE* dest
+        , strf::zlib_format format = strf::zlib_format::gzip
+        , int level = Z_DEFAULT_COMPRESSION
+        , std::size_t buffer_size = default_buffer_size )
+        : basic_zlib_writer(strf::detail::zlib_sink{dest}, format, level, buffer_size)
+    {
+    }
+
+    basic_zlib_writer
+        ( int fd
+        , strf::zlib_format format = strf::zlib_format::gzip
+        , int level = Z_DEFAULT_COMPRESSION
+        , std::size_t buffer_size = default_buffer_size )
+        : basic_zlib_writer(strf::detail::zlib_sink{fd}, format, level, buffer_size)
+    {
+    }
+
+#if defined(STRF_NO_CXX17_COPY_ELISION)
+
+    basic_zlib_writer(basic_zlib_writer&&);
+
+#else // defined(STRF_NO_CXX17_COPY_ELISION)
+
+    basic_zlib_writer(const basic_zlib_writer&) = delete;
+    basic_zlib_writer(basic_zlib_writer&&) = delete;
+
+#endif // defined(STRF_NO_CXX17_COPY_ELISION)
+
+    ~basic_zlib_writer()
+    {
+        if (_stream_initialized) {
+            ::deflateEnd(&_stream);
+        }
+    }
+
+    void recycle() noexcept override
+    {
+        auto p = this->pos();
+        this->set_pos(_buf.get());
+        if (this->good()) {
+            _deflate(_buf.get(), p - _buf.get(), Z_NO_FLUSH);
+        }
+    }
+
+    bool do_reserve_contiguous(std::size_t s) override
+    {
+        if (s <= _buf_size) {
+            recycle();
+            return this->good();
+        }
+        return false;
+    }
+
+    // Content passed to write_direct that does not fit in the remaining
+    // space of the buffer and that has at least buffer_size / 4 characters
+    // is fed directly into the deflate stream, instead of being copied.
+    void write_direct(const _underlying_char_t* ustr, std::size_t len) override
+    {
+        auto str = reinterpret_cast<const CharT*>(ustr);
+        if (len <= this->size()) {
+            strf::detail::str_copy_n(this->pos(), str, len);
+            this->advance(len);
+        } else if (len < _buf_size / 4 || ! this->good()) {
+            strf::detail::outbuf_write_continuation(*this, str, len);
+        } else {
+            recycle();
+            if (this->good()) {
+                _deflate(str, len, Z_NO_FLUSH);
+            }
+        }
+    }
+
+    struct result
+    {
+        std::size_t count;            // characters written
+        std::size_t compressed_size;  // bytes written into the destination
+        bool success;
+    };
+
+    result finish() noexcept
+    {
+        bool g = this->good();
+        if (g) {
+            _deflate(_buf.get(), this->pos() - _buf.get(), Z_FINISH);
+            g = this->good();
+        }
+        if (_stream_initialized) {
+            ::deflateEnd(&_stream);
+            _stream_initialized = false;
+        }
+        this->set_good(false);
+        this->set_pos(strf::outbuf_garbage_buf<CharT>());
+        this->set_end(strf::outbuf_garbage_buf_end<CharT>());
+        return {_count, _compressed_size, g};
+    }
+
+private:
+
+    basic_zlib_writer
+        ( strf::detail::zlib_sink sink
+        , strf::zlib_format format
+        , int level
+        , std::size_t buffer_size )
+        : strf::basic_outbuf_noexcept<CharT>(nullptr, nullptr)
+        , _sink(sink)
+        , _buf_size( buffer_size < strf::min_size_after_recycle<CharT>()
+                   ? strf::min_size_after_recycle<CharT>()
+                   : buffer_size )
+        , _buf(new CharT[_buf_size])
+        , _out_buf(new unsigned char[_out_buf_size])
+    {
+        this->set_pos(_buf.get());
+        this->set_end(_buf.get() + _buf_size);
+        _stream.zalloc = Z_NULL;
+        _stream.zfree = Z_NULL;
+        _stream.opaque = Z_NULL;
+        int r = ::deflateInit2( &_stream, level, Z_DEFLATED
+                              , strf::detail::zlib_window_bits(format)
+                              , 8, Z_DEFAULT_STRATEGY );
+        _stream_initialized = (r == Z_OK);
+        this->set_good(_stream_initialized);
+    }
+
+    void _deflate(const CharT* str, std::size_t len, int flush) noexcept
+    {
+        auto bytes = reinterpret_cast<const unsigned char*>(str);
+        std::size_t bytes_count = len * sizeof(CharT);
+        _count += len;
+        // avail_in is an unsigned int, hence the content
+        // may need to be passed in more than one step
+        constexpr std::size_t max_step = 0x40000000;
+        do {
+            std::size_t step = bytes_count < max_step ? bytes_count : max_step;
+            bytes_count -= step;
+            _stream.next_in = const_cast<unsigned char*>(bytes);
+            _stream.avail_in = static_cast<uInt>(step);
+            bytes += step;
+            int step_flush = bytes_count == 0 ? flush : Z_NO_FLUSH;
+            int r;
+            do {
+                _stream.next_out = _out_buf.get();
+                _stream.avail_out = static_cast<uInt>(_out_buf_size);
+                r = ::deflate(&_stream, step_flush);
+                if (r == Z_STREAM_ERROR) {
+                    this->set_good(false);
+                    return;
+                }
+                std::size_t have = _out_buf_size - _stream.avail_out;
+                if (have != 0) {
+                    if ( ! _sink.write(_out_buf.get(), have)) {
+                        this->set_good(false);
+                        return;
+                    }
+                    _compressed_size += have;
+                }
+            } while (_stream.avail_out == 0 || (step_flush == Z_FINISH && r != Z_STREAM_END));
+        } while (bytes_count != 0);
+    }
+
+    static constexpr std::size_t _out_buf_size = 0x10000;
+
+    strf::detail::zlib_sink _sink;
+    std::size_t _buf_size;
+    std::unique_ptr<CharT[]> _buf;
+    std::unique_ptr<unsigned char[]> _out_buf;
+    ::z_stream _stream;
+    bool _stream_initialized = false;
+    std::size_t _count = 0;
+    std::size_t _compressed_size = 0;
+};
+
+using zlib_writer = strf::basic_zlib_writer<char>;
+
+namespace detail {
+
+// Only used for the gzip format, since the concatenation of the
+// gzip members produced by successive calls is a valid gzip stream.
+template <typename CharT, typename Dest>
+class basic_gzip_writer_creator
+{
+public:
+
+    using char_type = CharT;
+    using outbuf_type = strf::basic_zlib_writer<CharT>;
+    using finish_type = typename outbuf_type::result;
+
+    constexpr basic_gzip_writer_creator(Dest dest, int level) noexcept
+        : _dest(dest)
+        , _level(level)
+    {
+    }
+
+    constexpr basic_gzip_writer_creator(const basic_gzip_writer_creator&) = default;
+
+    outbuf_type create() const
+    {
+        return outbuf_type{_dest, strf::zlib_format::gzip, _level};
+    }
+    // The reserved size only caps the buffer size, hence reserve_calc()
+    // does not allocate a buffer as large as the whole content.
+    outbuf_type create(std::size_t size) const
+    {
+        return outbuf_type
+            { _dest, strf::zlib_format::gzip, _level
+            , ( size < outbuf_type::max_reserved_buffer_size
+              ? size : outbuf_type::max_reserved_buffer_size ) };
+    }
+
+private:
+
+    Dest _dest;
+    int _level;
+};
+
+} // namespace detail
+
+// Each call writes an independent gzip member, with its own header and
+// trailer. Use basic_zlib_writer to compress many calls into one stream.
+template <typename CharT = char>
+inline auto to_gzip(std::FILE* dest, int level = Z_DEFAULT_COMPRESSION)
+{
+    return strf::destination_no_reserve
+        < strf::detail::basic_gzip_writer_creator<CharT, std::FILE*> >
+        (dest, level);
+}
+
+template <typename CharT = char>
+inline auto to_gzip(int fd, int level = Z_DEFAULT_COMPRESSION)
+{
+    return strf::destination_no_reserve
+        < strf::detail::basic_gzip_writer_creator<CharT, int> >
+        (fd, level);
+}
+
+} // namespace strf
+
+#endif  // STRF_DETAIL_OUTPUT_TYPES_ZLIB_HPP
+
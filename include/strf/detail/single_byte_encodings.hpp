@@ -6,31 +6,89 @@
 //  http://www.boost.org/LICENSE_1_0.txt)
 
 #include <strf/printer.hpp>
-#include <algorithm>
+#include <strf/detail/ascii_run.hpp>
 
 namespace strf {
 
 namespace detail {
 
-template<size_t SIZE, class T>
-constexpr STRF_HD size_t array_size(T (&)[SIZE]) {
-    return SIZE;
-}
-
-struct ch32_to_char
+// The code points that the bytes 0x80 to 0xFF of an ASCII-compatible
+// single-byte encoding decode to. 0xFFFF marks the bytes that are not mapped.
+struct single_byte_decode_table
 {
-    char32_t key;
-    unsigned value;
+    char16_t code_points[0x80];
+
+    STRF_HD char32_t decode(std::uint8_t ch) const
+    {
+        if (ch < 0x80) {
+            return ch;
+        }
+        char32_t ch32 = code_points[ch - 0x80];
+        return ch32 != 0xFFFF ? ch32 : (char32_t)-1;
+    }
 };
 
-struct cmp_ch32_to_char
+// The inverse of a single_byte_decode_table, as a two-level table:
+// a code point ch of the BMP is encoded as pages[page_index[ch >> 8]][ch & 0xFF],
+// where zero means that ch is not representable. pages[0] is all zeros,
+// and is the page of all blocks of 256 code points that have no
+// representable character.
+template <std::size_t PagesCount>
+struct single_byte_encode_table
 {
-    STRF_HD bool operator()(ch32_to_char a, ch32_to_char b) const
+    std::uint8_t page_index[0x100];
+    std::uint8_t pages[PagesCount][0x100];
+
+    STRF_HD unsigned encode(char32_t ch) const
     {
-        return a.key < b.key;
+        if (ch < 0x80) {
+            return ch;
+        }
+        if (ch > 0xFFFF) {
+            return 0x100;
+        }
+        unsigned ch_out = pages[page_index[ch >> 8]][ch & 0xFF];
+        return ch_out != 0 ? ch_out : 0x100;
     }
 };
 
+constexpr STRF_HD std::size_t single_byte_encode_pages_count
+    ( const strf::detail::single_byte_decode_table& decode_table )
+{
+    bool used[0x100] = {};
+    std::size_t count = 1;
+    for (std::size_t i = 0; i < 0x80; ++i) {
+        const unsigned ch = decode_table.code_points[i];
+        if (ch != 0xFFFF && ! used[ch >> 8]) {
+            used[ch >> 8] = true;
+            ++count;
+        }
+    }
+    return count;
+}
+
+// Builds at compile time the encode table of a single-byte encoding,
+// where PagesCount is single_byte_encode_pages_count(decode_table)
+template <std::size_t PagesCount>
+constexpr STRF_HD strf::detail::single_byte_encode_table<PagesCount>
+make_single_byte_encode_table
+    ( const strf::detail::single_byte_decode_table& decode_table )
+{
+    strf::detail::single_byte_encode_table<PagesCount> table{};
+    std::size_t pages_used = 1;
+    for (std::size_t i = 0; i < 0x80; ++i) {
+        const unsigned ch = decode_table.code_points[i];
+        if (ch != 0xFFFF) {
+            std::uint8_t& page = table.page_index[ch >> 8];
+            if (page == 0) {
+                page = static_cast<std::uint8_t>(pages_used++);
+            }
+            table.pages[page][ch & 0xFF] = static_cast<std::uint8_t>(0x80 + i);
+        }
+    }
+    return table;
+}
+
 template <typename CharIn>
 static STRF_HD std::size_t same_size
     ( const CharIn* src
@@ -66,6 +124,59 @@ struct single_byte_encoding
         , strf::encoding_error err_hdl
         , strf::surrogate_policy allow_surr );
 
+    static STRF_HD void to_utf8
+        ( strf::underlying_outbuf<1>& ob
+        , const std::uint8_t* src
+        , const std::uint8_t* src_end
+        , strf::encoding_error err_hdl
+        , strf::surrogate_policy allow_surr );
+
+    static STRF_HD std::size_t to_utf8_size
+        ( const std::uint8_t* src
+        , const std::uint8_t* src_end
+        , strf::surrogate_policy allow_surr );
+
+    static STRF_HD void from_utf8
+        ( strf::underlying_outbuf<1>& ob
+        , const std::uint8_t* src
+        , const std::uint8_t* src_end
+        , strf::encoding_error err_hdl
+        , strf::surrogate_policy allow_surr );
+
+    static STRF_HD void to_utf16
+        ( strf::underlying_outbuf<2>& ob
+        , const std::uint8_t* src
+        , const std::uint8_t* src_end
+        , strf::encoding_error err_hdl
+        , strf::surrogate_policy allow_surr );
+
+    static STRF_HD void from_utf16
+        ( strf::underlying_outbuf<1>& ob
+        , const char16_t* src
+        , const char16_t* src_end
+        , strf::encoding_error err_hdl
+        , strf::surrogate_policy allow_surr );
+
+    template <class SrcImpl>
+    static STRF_HD void from_single_byte
+        ( strf::underlying_outbuf<1>& ob
+        , const std::uint8_t* src
+        , const std::uint8_t* src_end
+        , strf::encoding_error err_hdl
+        , strf::surrogate_policy allow_surr );
+
+    static STRF_HD const strf::detail::transcoder_impl<std::uint8_t, std::uint8_t>*
+    from8(const strf::detail::encoding_impl<std::uint8_t>& other);
+
+    static STRF_HD const strf::detail::transcoder_impl<std::uint8_t, std::uint8_t>*
+    to8(const strf::detail::encoding_impl<std::uint8_t>& other);
+
+    static STRF_HD const strf::detail::transcoder_impl<char16_t, std::uint8_t>*
+    from16(const strf::detail::encoding_impl<char16_t>& other);
+
+    static STRF_HD const strf::detail::transcoder_impl<std::uint8_t, char16_t>*
+    to16(const strf::detail::encoding_impl<char16_t>& other);
+
     static STRF_HD std::uint8_t* encode_char(std::uint8_t* dest, char32_t ch);
 
     static STRF_HD void encode_fill
@@ -240,7 +351,24 @@ STRF_HD void single_byte_encoding<Impl>::from_utf32
     (void)allow_surr;
     auto dest_it = ob.pos();
     auto dest_end = ob.end();
+    unsigned ascii_count = 0;
     for(; src != src_end; ++src) {
+        if (*src < 0x80) {
+            STRF_CHECK_DEST;
+            *dest_it = static_cast<std::uint8_t>(*src);
+            ++dest_it;
+            if (++ascii_count == 8) {
+                std::size_t src_left = src_end - src - 1;
+                std::size_t dest_left = dest_end - dest_it;
+                auto n = strf::detail::narrow_ascii_run
+                    ( src + 1, src_left < dest_left ? src_left : dest_left, dest_it );
+                src += n;
+                dest_it += n;
+                ascii_count = 0;
+            }
+            continue;
+        }
+        ascii_count = 0;
         auto ch2 = Impl::encode(*src);
         if(ch2 >= 0x100) {
             if (err_hdl == strf::encoding_error::stop) {
@@ -256,6 +384,351 @@ STRF_HD void single_byte_encoding<Impl>::from_utf32
     ob.advance_to(dest_it);
 }
 
+// The direct transcoders below, between a single-byte encoding and
+// UTF-8, UTF-16 or another single-byte encoding, assume that the
+// encodings are ASCII-compatible, and that every character they
+// decode to is in the Basic Multilingual Plane. They produce the
+// same result as decoding to UTF-32 and then encoding, but without
+// the intermediate buffer.
+
+template <class Impl>
+STRF_HD void single_byte_encoding<Impl>::to_utf8
+    ( strf::underlying_outbuf<1>& ob
+    , const std::uint8_t* src
+    , const std::uint8_t* src_end
+    , strf::encoding_error err_hdl
+    , strf::surrogate_policy allow_surr )
+{
+    (void) allow_surr;
+    auto dest_it = ob.pos();
+    auto dest_end = ob.end();
+    unsigned ascii_count = 0;
+    for (auto src_it = src; src_it < src_end; ) {
+        std::uint8_t ch = *src_it;
+        ++src_it;
+        if (ch < 0x80) {
+            STRF_CHECK_DEST;
+            *dest_it = ch;
+            ++dest_it;
+            if (++ascii_count == 8) {
+                std::size_t src_left = src_end - src_it;
+                std::size_t dest_left = dest_end - dest_it;
+                auto n = strf::detail::copy_ascii_run
+                    ( src_it, src_left < dest_left ? src_left : dest_left, dest_it );
+                src_it += n;
+                dest_it += n;
+                ascii_count = 0;
+            }
+            continue;
+        }
+        ascii_count = 0;
+        char32_t ch32 = Impl::decode(ch);
+        if (ch32 == (char32_t)-1) {
+            if (err_hdl == strf::encoding_error::stop) {
+                ob.advance_to(dest_it);
+                strf::detail::handle_encoding_failure();
+            }
+            ch32 = 0xFFFD;
+        }
+        if (ch32 < 0x80) {
+            STRF_CHECK_DEST;
+            *dest_it = static_cast<std::uint8_t>(ch32);
+            ++dest_it;
+        } else if (ch32 < 0x800) {
+            STRF_CHECK_DEST_SIZE(2);
+            dest_it[0] = static_cast<std::uint8_t>(0xC0 | (ch32 >> 6));
+            dest_it[1] = static_cast<std::uint8_t>(0x80 | (ch32 & 0x3F));
+            dest_it += 2;
+        } else {
+            STRF_CHECK_DEST_SIZE(3);
+            dest_it[0] = static_cast<std::uint8_t>(0xE0 | (ch32 >> 12));
+            dest_it[1] = static_cast<std::uint8_t>(0x80 | ((ch32 >> 6) & 0x3F));
+            dest_it[2] = static_cast<std::uint8_t>(0x80 | (ch32 & 0x3F));
+            dest_it += 3;
+        }
+    }
+    ob.advance_to(dest_it);
+}
+
+template <class Impl>
+STRF_HD std::size_t single_byte_encoding<Impl>::to_utf8_size
+    ( const std::uint8_t* src
+    , const std::uint8_t* src_end
+    , strf::surrogate_policy allow_surr )
+{
+    (void) allow_surr;
+    std::size_t size = 0;
+    for (auto src_it = src; src_it < src_end; ++src_it) {
+        std::uint8_t ch = *src_it;
+        if (ch < 0x80) {
+            ++size;
+        } else {
+            // an invalid byte is decoded as (char32_t)-1, and
+            // replaced by U+FFFD, which has 3 bytes in UTF-8 too
+            char32_t ch32 = Impl::decode(ch);
+            size += ch32 < 0x80 ? 1 : ch32 < 0x800 ? 2 : 3;
+        }
+    }
+    return size;
+}
+
+template <class Impl>
+STRF_HD void single_byte_encoding<Impl>::from_utf8
+    ( strf::underlying_outbuf<1>& ob
+    , const std::uint8_t* src
+    , const std::uint8_t* src_end
+    , strf::encoding_error err_hdl
+    , strf::surrogate_policy allow_surr )
+{
+    using strf::detail::utf8_decode;
+    using strf::detail::is_utf8_continuation;
+
+    std::uint8_t ch0, ch1, ch2, ch3;
+    unsigned long x;
+    auto src_it = src;
+    auto dest_it = ob.pos();
+    auto dest_end = ob.end();
+    char32_t ch32;
+    unsigned ascii_count = 0;
+
+    while(src_it != src_end) {
+        ch0 = (*src_it);
+        ++src_it;
+        if (ch0 < 0x80) {
+            STRF_CHECK_DEST;
+            *dest_it = ch0;
+            ++dest_it;
+            if (++ascii_count == 8) {
+                std::size_t src_left = src_end - src_it;
+                std::size_t dest_left = dest_end - dest_it;
+                auto n = strf::detail::copy_ascii_run
+                    ( src_it, src_left < dest_left ? src_left : dest_left, dest_it );
+                src_it += n;
+                dest_it += n;
+                ascii_count = 0;
+            }
+            continue;
+        }
+        ascii_count = 0;
+        if (0xC0 == (ch0 & 0xE0)) {
+            if(ch0 > 0xC1 && src_it != src_end && is_utf8_continuation(ch1 = * src_it)) {
+                ch32 = utf8_decode(ch0, ch1);
+                ++src_it;
+            } else goto invalid_sequence;
+        } else if (0xE0 == ch0) {
+            if (   src_it != src_end && (((ch1 = * src_it) & 0xE0) == 0xA0)
+              && ++src_it != src_end && is_utf8_continuation(ch2 = * src_it) )
+            {
+                ch32 = ((ch1 & 0x3F) << 6) | (ch2 & 0x3F);
+                ++src_it;
+            } else goto invalid_sequence;
+        } else if (0xE0 == (ch0 & 0xF0)) {
+            if (   src_it != src_end && is_utf8_continuation(ch1 = * src_it)
+              && first_2_of_3_are_valid( x = utf8_decode_first_2_of_3(ch0, ch1)
+                                       , allow_surr )
+              && ++src_it != src_end && is_utf8_continuation(ch2 = * src_it) )
+            {
+                ch32 = (x << 6) | (ch2 & 0x3F);
+                ++src_it;
+            } else goto invalid_sequence;
+        } else if (0xEF < ch0) {
+            if ( src_it != src_end && is_utf8_continuation(ch1 = * src_it)
+              && first_2_of_4_are_valid(x = utf8_decode_first_2_of_4(ch0, ch1))
+              && ++src_it != src_end && is_utf8_continuation(ch2 = * src_it)
+              && ++src_it != src_end && is_utf8_continuation(ch3 = * src_it) )
+            {
+                ch32 = utf8_decode_last_2_of_4(x, ch2, ch3);
+                ++src_it;
+            } else goto invalid_sequence;
+        } else {
+            invalid_sequence:
+            if (err_hdl == strf::encoding_error::stop) {
+                ob.advance_to(dest_it);
+                strf::detail::handle_encoding_failure();
+            }
+            ch32 = 0xFFFD;
+        }
+
+        auto ch_out = Impl::encode(ch32);
+        if (ch_out >= 0x100) {
+            if (err_hdl == strf::encoding_error::stop) {
+                ob.advance_to(dest_it);
+                strf::detail::handle_encoding_failure();
+            }
+            ch_out = '?';
+        }
+        STRF_CHECK_DEST;
+        *dest_it = static_cast<std::uint8_t>(ch_out);
+        ++dest_it;
+    }
+    ob.advance_to(dest_it);
+}
+
+template <class Impl>
+STRF_HD void single_byte_encoding<Impl>::to_utf16
+    ( strf::underlying_outbuf<2>& ob
+    , const std::uint8_t* src
+    , const std::uint8_t* src_end
+    , strf::encoding_error err_hdl
+    , strf::surrogate_policy allow_surr )
+{
+    (void) allow_surr;
+    auto dest_it = ob.pos();
+    auto dest_end = ob.end();
+    unsigned ascii_count = 0;
+    for (auto src_it = src; src_it < src_end; ) {
+        std::uint8_t ch = *src_it;
+        ++src_it;
+        if (ch < 0x80) {
+            STRF_CHECK_DEST;
+            *dest_it = ch;
+            ++dest_it;
+            if (++ascii_count == 8) {
+                std::size_t src_left = src_end - src_it;
+                std::size_t dest_left = dest_end - dest_it;
+                auto n = strf::detail::copy_ascii_run
+                    ( src_it, src_left < dest_left ? src_left : dest_left, dest_it );
+                src_it += n;
+                dest_it += n;
+                ascii_count = 0;
+            }
+            continue;
+        }
+        ascii_count = 0;
+        char32_t ch32 = Impl::decode(ch);
+        if (ch32 == (char32_t)-1) {
+            if (err_hdl == strf::encoding_error::stop) {
+                ob.advance_to(dest_it);
+                strf::detail::handle_encoding_failure();
+            }
+            ch32 = 0xFFFD;
+        }
+        STRF_CHECK_DEST;
+        *dest_it = static_cast<char16_t>(ch32);
+        ++dest_it;
+    }
+    ob.advance_to(dest_it);
+}
+
+template <class Impl>
+STRF_HD void single_byte_encoding<Impl>::from_utf16
+    ( strf::underlying_outbuf<1>& ob
+    , const char16_t* src
+    , const char16_t* src_end
+    , strf::encoding_error err_hdl
+    , strf::surrogate_policy allow_surr )
+{
+    unsigned long ch, ch2;
+    char32_t ch32;
+    auto dest_it = ob.pos();
+    auto dest_end = ob.end();
+    unsigned ascii_count = 0;
+    for(auto src_it = src; src_it < src_end; ) {
+        ch = *src_it;
+        ++src_it;
+        if (ch < 0x80) {
+            STRF_CHECK_DEST;
+            *dest_it = static_cast<std::uint8_t>(ch);
+            ++dest_it;
+            if (++ascii_count == 8) {
+                std::size_t src_left = src_end - src_it;
+                std::size_t dest_left = dest_end - dest_it;
+                auto n = strf::detail::narrow_ascii_run
+                    ( src_it, src_left < dest_left ? src_left : dest_left, dest_it );
+                src_it += n;
+                dest_it += n;
+                ascii_count = 0;
+            }
+            continue;
+        }
+        ascii_count = 0;
+        if (not_surrogate(ch)) {
+            ch32 = ch;
+        } else if ( is_high_surrogate(ch)
+               && src_it != src_end
+               && is_low_surrogate(ch2 = *src_it)) {
+            ch32 = 0x10000 + (((ch & 0x3FF) << 10) | (ch2 & 0x3FF));
+            ++src_it;
+        } else if (allow_surr == strf::surrogate_policy::lax) {
+            ch32 = ch;
+        } else {
+            if (err_hdl == strf::encoding_error::stop) {
+                ob.advance_to(dest_it);
+                strf::detail::handle_encoding_failure();
+            }
+            ch32 = 0xFFFD;
+        }
+
+        auto ch_out = Impl::encode(ch32);
+        if (ch_out >= 0x100) {
+            if (err_hdl == strf::encoding_error::stop) {
+                ob.advance_to(dest_it);
+                strf::detail::handle_encoding_failure();
+            }
+            ch_out = '?';
+        }
+        STRF_CHECK_DEST;
+        *dest_it = static_cast<std::uint8_t>(ch_out);
+        ++dest_it;
+    }
+    ob.advance_to(dest_it);
+}
+
+template <class Impl>
+template <class SrcImpl>
+STRF_HD void single_byte_encoding<Impl>::from_single_byte
+    ( strf::underlying_outbuf<1>& ob
+    , const std::uint8_t* src
+    , const std::uint8_t* src_end
+    , strf::encoding_error err_hdl
+    , strf::surrogate_policy allow_surr )
+{
+    (void) allow_surr;
+    auto dest_it = ob.pos();
+    auto dest_end = ob.end();
+    unsigned ascii_count = 0;
+    for (auto src_it = src; src_it < src_end; ) {
+        std::uint8_t ch = *src_it;
+        ++src_it;
+        if (ch < 0x80) {
+            STRF_CHECK_DEST;
+            *dest_it = ch;
+            ++dest_it;
+            if (++ascii_count == 8) {
+                std::size_t src_left = src_end - src_it;
+                std::size_t dest_left = dest_end - dest_it;
+                auto n = strf::detail::copy_ascii_run
+                    ( src_it, src_left < dest_left ? src_left : dest_left, dest_it );
+                src_it += n;
+                dest_it += n;
+                ascii_count = 0;
+            }
+            continue;
+        }
+        ascii_count = 0;
+        char32_t ch32 = SrcImpl::decode(ch);
+        if (ch32 == (char32_t)-1) {
+            if (err_hdl == strf::encoding_error::stop) {
+                ob.advance_to(dest_it);
+                strf::detail::handle_encoding_failure();
+            }
+            ch32 = 0xFFFD;
+        }
+        auto ch_out = Impl::encode(ch32);
+        if (ch_out >= 0x100) {
+            if (err_hdl == strf::encoding_error::stop) {
+                ob.advance_to(dest_it);
+                strf::detail::handle_encoding_failure();
+            }
+            ch_out = '?';
+        }
+        STRF_CHECK_DEST;
+        *dest_it = static_cast<std::uint8_t>(ch_out);
+        ++dest_it;
+    }
+    ob.advance_to(dest_it);
+}
+
 struct impl_strict_ascii
 {
     static STRF_HD bool is_valid(std::uint8_t ch)
@@ -312,99 +785,42 @@ struct impl_iso8859_3
     static STRF_HD unsigned encode(char32_t ch);
 
     static STRF_HD char32_t decode(std::uint8_t ch);
-};
 
-template< class ForwardIt, class T, class Compare >
-ForwardIt STRF_HD lower_bound
-    ( ForwardIt first
-    , ForwardIt last
-    , const T& value
-    , Compare comp )
-{
-#ifndef __CUDA_ARCH__
-    return std::lower_bound(first, last, value, comp);
-#else
-    auto search_range_length { last - first };
-        // We don't have the equivalent of std::distance on the device-side
-
-    ForwardIt iter;
-    while (search_range_length > 0) {
-        auto half_range_length = search_range_length/2;
-        iter = first;
-        iter += half_range_length;
-        if (comp(*iter, value)) {
-            first = ++iter;
-            search_range_length -= (half_range_length + 1);
-                // the extra +1 is since we've just checked the midpoint
-        }
-        else {
-            search_range_length = half_range_length;
-        }
+    static constexpr STRF_HD strf::detail::single_byte_decode_table decode_table()
+    {
+        return {
+            { /* 80 */ 0x0080, 0x0081, 0x0082, 0x0083, 0x0084, 0x0085, 0x0086, 0x0087
+            , /* 88 */ 0x0088, 0x0089, 0x008A, 0x008B, 0x008C, 0x008D, 0x008E, 0x008F
+            , /* 90 */ 0x0090, 0x0091, 0x0092, 0x0093, 0x0094, 0x0095, 0x0096, 0x0097
+            , /* 98 */ 0x0098, 0x0099, 0x009A, 0x009B, 0x009C, 0x009D, 0x009E, 0x009F
+            , /* A0 */ 0x00A0, 0x0126, 0x02D8, 0x00A3, 0x00A4, 0xFFFF, 0x0124, 0x00A7
+            , /* A8 */ 0x00A8, 0x0130, 0x015E, 0x011E, 0x0134, 0x00AD, 0xFFFF, 0x017B
+            , /* B0 */ 0x00B0, 0x0127, 0x00B2, 0x00B3, 0x00B4, 0x00B5, 0x0125, 0x00B7
+            , /* B8 */ 0x00B8, 0x0131, 0x015F, 0x011F, 0x0135, 0x00BD, 0xFFFF, 0x017C
+            , /* C0 */ 0x00C0, 0x00C1, 0x00C2, 0xFFFF, 0x00C4, 0x010A, 0x0108, 0x00C7
+            , /* C8 */ 0x00C8, 0x00C9, 0x00CA, 0x00CB, 0x00CC, 0x00CD, 0x00CE, 0x00CF
+            , /* D0 */ 0xFFFF, 0x00D1, 0x00D2, 0x00D3, 0x00D4, 0x0120, 0x00D6, 0x00D7
+            , /* D8 */ 0x011C, 0x00D9, 0x00DA, 0x00DB, 0x00DC, 0x016C, 0x015C, 0x00DF
+            , /* E0 */ 0x00E0, 0x00E1, 0x00E2, 0xFFFF, 0x00E4, 0x010B, 0x0109, 0x00E7
+            , /* E8 */ 0x00E8, 0x00E9, 0x00EA, 0x00EB, 0x00EC, 0x00ED, 0x00EE, 0x00EF
+            , /* F0 */ 0xFFFF, 0x00F1, 0x00F2, 0x00F3, 0x00F4, 0x0121, 0x00F6, 0x00F7
+            , /* F8 */ 0x011D, 0x00F9, 0x00FA, 0x00FB, 0x00FC, 0x016D, 0x015D, 0x02D9
+            } };
     }
-    return first;
-#endif
-}
+};
 
 STRF_INLINE STRF_HD unsigned impl_iso8859_3::encode(char32_t ch)
 {
-    if (ch < 0xA1) {
-        return ch;
-    }
-    static const ch32_to_char enc_map[] =
-        { {0x00A3, 0xA3}, {0x00A4, 0xA4}, {0x00A7, 0xA7}, {0x00A8, 0xA8}
-        , {0x00AD, 0xAD}, {0x00B0, 0xB0}, {0x00B2, 0xB2}, {0x00B3, 0xB3}
-        , {0x00B4, 0xB4}, {0x00B5, 0xB5}, {0x00B7, 0xB7}, {0x00B8, 0xB8}
-        , {0x00BD, 0xBD}, {0x00C0, 0xC0}, {0x00C1, 0xC1}, {0x00C2, 0xC2}
-        , {0x00C4, 0xC4}, {0x00C7, 0xC7}, {0x00C8, 0xC8}, {0x00C9, 0xC9}
-        , {0x00CA, 0xCA}, {0x00CB, 0xCB}, {0x00CC, 0xCC}, {0x00CD, 0xCD}
-        , {0x00CE, 0xCE}, {0x00CF, 0xCF}, {0x00D1, 0xD1}, {0x00D2, 0xD2}
-        , {0x00D3, 0xD3}, {0x00D4, 0xD4}, {0x00D6, 0xD6}, {0x00D7, 0xD7}
-        , {0x00D9, 0xD9}, {0x00DA, 0xDA}, {0x00DB, 0xDB}, {0x00DC, 0xDC}
-        , {0x00DF, 0xDF}, {0x00E0, 0xE0}, {0x00E1, 0xE1}, {0x00E2, 0xE2}
-        , {0x00E4, 0xE4}, {0x00E7, 0xE7}, {0x00E8, 0xE8}, {0x00E9, 0xE9}
-        , {0x00EA, 0xEA}, {0x00EB, 0xEB}, {0x00EC, 0xEC}, {0x00ED, 0xED}
-        , {0x00EE, 0xEE}, {0x00EF, 0xEF}, {0x00F1, 0xF1}, {0x00F2, 0xF2}
-        , {0x00F3, 0xF3}, {0x00F4, 0xF4}, {0x00F6, 0xF6}, {0x00F7, 0xF7}
-        , {0x00F9, 0xF9}, {0x00FA, 0xFA}, {0x00FB, 0xFB}, {0x00FC, 0xFC}
-        , {0x0108, 0xC6}, {0x0109, 0xE6}, {0x010A, 0xC5}, {0x010B, 0xE5}
-        , {0x011C, 0xD8}, {0x011D, 0xF8}, {0x011E, 0xAB}, {0x011F, 0xBB}
-        , {0x0120, 0xD5}, {0x0121, 0xF5}, {0x0124, 0xA6}, {0x0125, 0xB6}
-        , {0x0126, 0xA1}, {0x0127, 0xB1}, {0x0130, 0xA9}, {0x0131, 0xB9}
-        , {0x0134, 0xAC}, {0x0135, 0xBC}, {0x015C, 0xDE}, {0x015D, 0xFE}
-        , {0x015E, 0xAA}, {0x015F, 0xBA}, {0x016C, 0xDD}, {0x016D, 0xFD}
-        , {0x017B, 0xAF}, {0x017C, 0xBF}, {0x02D8, 0xA2}, {0x02D9, 0xFF} };
-
-    const ch32_to_char* enc_map_end = enc_map + detail::array_size(enc_map);
-    auto it = lower_bound( enc_map
-                          , enc_map_end
-                          , ch32_to_char{ch, 0}
-                          , cmp_ch32_to_char{} );
-    return it != enc_map_end && it->key == ch ? it->value : 0x100;
+    static const auto table = strf::detail::make_single_byte_encode_table
+        < strf::detail::single_byte_encode_pages_count(decode_table()) >
+        ( decode_table() );
+    return table.encode(ch);
 }
 
 STRF_INLINE STRF_HD char32_t impl_iso8859_3::decode(std::uint8_t ch)
 {
-    if (ch < 0xA1) {
-        return ch;
-    }
-    else {
-        constexpr short undef = -1;
-        static const short ext[] =
-            { /* A0*/ 0x0126, 0x02D8, 0x00A3, 0x00A4,  undef, 0x0124, 0x00A7
-            , 0x00A8, 0x0130, 0x015E, 0x011E, 0x0134, 0x00AD,  undef, 0x017B
-            , 0x00B0, 0x0127, 0x00B2, 0x00B3, 0x00B4, 0x00B5, 0x0125, 0x00B7
-            , 0x00B8, 0x0131, 0x015F, 0x011F, 0x0135, 0x00BD,  undef, 0x017C
-            , 0x00C0, 0x00C1, 0x00C2,  undef, 0x00C4, 0x010A, 0x0108, 0x00C7
-            , 0x00C8, 0x00C9, 0x00CA, 0x00CB, 0x00CC, 0x00CD, 0x00CE, 0x00CF
-            ,  undef, 0x00D1, 0x00D2, 0x00D3, 0x00D4, 0x0120, 0x00D6, 0x00D7
-            , 0x011C, 0x00D9, 0x00DA, 0x00DB, 0x00DC, 0x016C, 0x015C, 0x00DF
-            , 0x00E0, 0x00E1, 0x00E2,  undef, 0x00E4, 0x010B, 0x0109, 0x00E7
-            , 0x00E8, 0x00E9, 0x00EA, 0x00EB, 0x00EC, 0x00ED, 0x00EE, 0x00EF
-            ,  undef, 0x00F1, 0x00F2, 0x00F3, 0x00F4, 0x0121, 0x00F6, 0x00F7
-            , 0x011D, 0x00F9, 0x00FA, 0x00FB, 0x00FC, 0x016D, 0x015D, 0x02D9 };
-
-        return (std::int32_t) ext[ch - 0xA1];
-    }
+    static const auto table = decode_table();
+    return table.decode(ch);
 }
 
 
@@ -417,19 +833,32 @@ public:
         return true;
     }
 
-    static STRF_HD char32_t decode(std::uint8_t ch)
+    static constexpr STRF_HD strf::detail::single_byte_decode_table decode_table()
     {
-        static const unsigned short ext[] = {
-            /*                           */ 0x20AC, 0x00A5, 0x0160, 0x00A7,
-            0x0161, 0x00A9, 0x00AA, 0x00AB, 0x00AC, 0x00AD, 0x00AE, 0x00AF,
-            0x00B0, 0x00B1, 0x00B2, 0x00B3, 0x017D, 0x00B5, 0x00B6, 0x00B7,
-            0x017E, 0x00B9, 0x00BA, 0x00BB, 0x0152, 0x0153, 0x0178
-        };
-
-        if (ch <= 0xA3 || 0xBF <= ch)
-            return ch;
+        return {
+            { /* 80 */ 0x0080, 0x0081, 0x0082, 0x0083, 0x0084, 0x0085, 0x0086, 0x0087
+            , /* 88 */ 0x0088, 0x0089, 0x008A, 0x008B, 0x008C, 0x008D, 0x008E, 0x008F
+            , /* 90 */ 0x0090, 0x0091, 0x0092, 0x0093, 0x0094, 0x0095, 0x0096, 0x0097
+            , /* 98 */ 0x0098, 0x0099, 0x009A, 0x009B, 0x009C, 0x009D, 0x009E, 0x009F
+            , /* A0 */ 0x00A0, 0x00A1, 0x00A2, 0x00A3, 0x20AC, 0x00A5, 0x0160, 0x00A7
+            , /* A8 */ 0x0161, 0x00A9, 0x00AA, 0x00AB, 0x00AC, 0x00AD, 0x00AE, 0x00AF
+            , /* B0 */ 0x00B0, 0x00B1, 0x00B2, 0x00B3, 0x017D, 0x00B5, 0x00B6, 0x00B7
+            , /* B8 */ 0x017E, 0x00B9, 0x00BA, 0x00BB, 0x0152, 0x0153, 0x0178, 0x00BF
+            , /* C0 */ 0x00C0, 0x00C1, 0x00C2, 0x00C3, 0x00C4, 0x00C5, 0x00C6, 0x00C7
+            , /* C8 */ 0x00C8, 0x00C9, 0x00CA, 0x00CB, 0x00CC, 0x00CD, 0x00CE, 0x00CF
+            , /* D0 */ 0x00D0, 0x00D1, 0x00D2, 0x00D3, 0x00D4, 0x00D5, 0x00D6, 0x00D7
+            , /* D8 */ 0x00D8, 0x00D9, 0x00DA, 0x00DB, 0x00DC, 0x00DD, 0x00DE, 0x00DF
+            , /* E0 */ 0x00E0, 0x00E1, 0x00E2, 0x00E3, 0x00E4, 0x00E5, 0x00E6, 0x00E7
+            , /* E8 */ 0x00E8, 0x00E9, 0x00EA, 0x00EB, 0x00EC, 0x00ED, 0x00EE, 0x00EF
+            , /* F0 */ 0x00F0, 0x00F1, 0x00F2, 0x00F3, 0x00F4, 0x00F5, 0x00F6, 0x00F7
+            , /* F8 */ 0x00F8, 0x00F9, 0x00FA, 0x00FB, 0x00FC, 0x00FD, 0x00FE, 0x00FF
+            } };
+    }
 
-        return ext[ch - 0xA4];
+    static STRF_HD char32_t decode(std::uint8_t ch)
+    {
+        static const auto table = decode_table();
+        return table.decode(ch);
     }
 
     static STRF_HD unsigned encode(char32_t ch)
@@ -444,26 +873,10 @@ private:
 
 STRF_INLINE STRF_HD unsigned impl_iso8859_15::encode_ext(char32_t ch)
 {
-    switch(ch) {
-        case 0x20AC: return 0xA4;
-        case 0x0160: return 0xA6;
-        case 0x0161: return 0xA8;
-        case 0x017D: return 0xB4;
-        case 0x017E: return 0xB8;
-        case 0x0152: return 0xBC;
-        case 0x0153: return 0xBD;
-        case 0x0178: return 0xBE;
-        case 0xA4:
-        case 0xA6:
-        case 0xA8:
-        case 0xB4:
-        case 0xB8:
-        case 0xBC:
-        case 0xBD:
-        case 0xBE:
-            return 0x100;
-    }
-    return ch;
+    static const auto table = strf::detail::make_single_byte_encode_table
+        < strf::detail::single_byte_encode_pages_count(decode_table()) >
+        ( decode_table() );
+    return table.encode(ch);
 }
 
 class impl_windows_1252
@@ -471,27 +884,37 @@ class impl_windows_1252
 public:
     // https://www.unicode.org/Public/MAPPINGS/VENDORS/MICSFT/WindowsBestFit/bestfit1252.txt
 
-    constexpr static unsigned short decode_fail = 0xFFFF;
-
     static STRF_HD bool is_valid(std::uint8_t)
     {
         return true;
     }
 
+    static constexpr STRF_HD strf::detail::single_byte_decode_table decode_table()
+    {
+        return {
+            { /* 80 */ 0x20AC, 0x0081, 0x201A, 0x0192, 0x201E, 0x2026, 0x2020, 0x2021
+            , /* 88 */ 0x02C6, 0x2030, 0x0160, 0x2039, 0x0152, 0x008D, 0x017D, 0x008F
+            , /* 90 */ 0x0090, 0x2018, 0x2019, 0x201C, 0x201D, 0x2022, 0x2013, 0x2014
+            , /* 98 */ 0x02DC, 0x2122, 0x0161, 0x203A, 0x0153, 0x009D, 0x017E, 0x0178
+            , /* A0 */ 0x00A0, 0x00A1, 0x00A2, 0x00A3, 0x00A4, 0x00A5, 0x00A6, 0x00A7
+            , /* A8 */ 0x00A8, 0x00A9, 0x00AA, 0x00AB, 0x00AC, 0x00AD, 0x00AE, 0x00AF
+            , /* B0 */ 0x00B0, 0x00B1, 0x00B2, 0x00B3, 0x00B4, 0x00B5, 0x00B6, 0x00B7
+            , /* B8 */ 0x00B8, 0x00B9, 0x00BA, 0x00BB, 0x00BC, 0x00BD, 0x00BE, 0x00BF
+            , /* C0 */ 0x00C0, 0x00C1, 0x00C2, 0x00C3, 0x00C4, 0x00C5, 0x00C6, 0x00C7
+            , /* C8 */ 0x00C8, 0x00C9, 0x00CA, 0x00CB, 0x00CC, 0x00CD, 0x00CE, 0x00CF
+            , /* D0 */ 0x00D0, 0x00D1, 0x00D2, 0x00D3, 0x00D4, 0x00D5, 0x00D6, 0x00D7
+            , /* D8 */ 0x00D8, 0x00D9, 0x00DA, 0x00DB, 0x00DC, 0x00DD, 0x00DE, 0x00DF
+            , /* E0 */ 0x00E0, 0x00E1, 0x00E2, 0x00E3, 0x00E4, 0x00E5, 0x00E6, 0x00E7
+            , /* E8 */ 0x00E8, 0x00E9, 0x00EA, 0x00EB, 0x00EC, 0x00ED, 0x00EE, 0x00EF
+            , /* F0 */ 0x00F0, 0x00F1, 0x00F2, 0x00F3, 0x00F4, 0x00F5, 0x00F6, 0x00F7
+            , /* F8 */ 0x00F8, 0x00F9, 0x00FA, 0x00FB, 0x00FC, 0x00FD, 0x00FE, 0x00FF
+            } };
+    }
+
     static STRF_HD char32_t decode(std::uint8_t ch)
     {
-        if (ch < 0x80 || 0x9F < ch) {
-            return ch;
-        }
-        else {
-            static const unsigned short ext[] = {
-                0x20AC, 0x0081, 0x201A, 0x0192, 0x201E, 0x2026, 0x2020, 0x2021,
-                0x02C6, 0x2030, 0x0160, 0x2039, 0x0152, 0x008D, 0x017D, 0x008F,
-                0X0090, 0x2018, 0x2019, 0x201C, 0x201D, 0x2022, 0x2013, 0x2014,
-                0x02DC, 0x2122, 0x0161, 0x203A, 0x0153, 0x009D, 0x017E, 0x0178,
-            };
-            return ext[ch - 0x80];
-        }
+        static const auto table = decode_table();
+        return table.decode(ch);
     }
 
     static STRF_HD unsigned encode(char32_t ch)
@@ -506,41 +929,84 @@ private:
 
 STRF_INLINE STRF_HD unsigned impl_windows_1252::encode_ext(char32_t ch)
 {
-    switch(ch) {
-        case 0x81: return 0x81;
-        case 0x8D: return 0x8D;
-        case 0x8F: return 0x8F;
-        case 0x90: return 0x90;
-        case 0x9D: return 0x9D;
-        case 0x20AC: return 0x80;
-        case 0x201A: return 0x82;
-        case 0x0192: return 0x83;
-        case 0x201E: return 0x84;
-        case 0x2026: return 0x85;
-        case 0x2020: return 0x86;
-        case 0x2021: return 0x87;
-        case 0x02C6: return 0x88;
-        case 0x2030: return 0x89;
-        case 0x0160: return 0x8A;
-        case 0x2039: return 0x8B;
-        case 0x0152: return 0x8C;
-        case 0x017D: return 0x8E;
-        case 0x2018: return 0x91;
-        case 0x2019: return 0x92;
-        case 0x201C: return 0x93;
-        case 0x201D: return 0x94;
-        case 0x2022: return 0x95;
-        case 0x2013: return 0x96;
-        case 0x2014: return 0x97;
-        case 0x02DC: return 0x98;
-        case 0x2122: return 0x99;
-        case 0x0161: return 0x9A;
-        case 0x203A: return 0x9B;
-        case 0x0153: return 0x9C;
-        case 0x017E: return 0x9E;
-        case 0x0178: return 0x9F;
-    }
-    return 0x100;
+    static const auto table = strf::detail::make_single_byte_encode_table
+        < strf::detail::single_byte_encode_pages_count(decode_table()) >
+        ( decode_table() );
+    return table.encode(ch);
+}
+
+template <class Impl>
+STRF_HD const strf::detail::transcoder_impl<std::uint8_t, std::uint8_t>*
+single_byte_encoding<Impl>::from8(const strf::detail::encoding_impl<std::uint8_t>& other)
+{
+    using transcoder_type = strf::detail::transcoder_impl<std::uint8_t, std::uint8_t>;
+    switch (other.id) {
+        case strf::encoding_id::eid_utf8: {
+            static const transcoder_type tr_obj =
+                { from_utf8, strf::detail::utf8_to_utf32_size };
+            return & tr_obj;
+        }
+        case strf::encoding_id::eid_iso_8859_1: {
+            static const transcoder_type tr_obj =
+                { from_single_byte<impl_iso8859_1>, detail::same_size<std::uint8_t> };
+            return & tr_obj;
+        }
+        case strf::encoding_id::eid_iso_8859_3: {
+            static const transcoder_type tr_obj =
+                { from_single_byte<impl_iso8859_3>, detail::same_size<std::uint8_t> };
+            return & tr_obj;
+        }
+        case strf::encoding_id::eid_iso_8859_15: {
+            static const transcoder_type tr_obj =
+                { from_single_byte<impl_iso8859_15>, detail::same_size<std::uint8_t> };
+            return & tr_obj;
+        }
+        case strf::encoding_id::eid_windows_1252: {
+            static const transcoder_type tr_obj =
+                { from_single_byte<impl_windows_1252>, detail::same_size<std::uint8_t> };
+            return & tr_obj;
+        }
+        default:
+            return nullptr;
+    }
+}
+
+template <class Impl>
+STRF_HD const strf::detail::transcoder_impl<std::uint8_t, std::uint8_t>*
+single_byte_encoding<Impl>::to8(const strf::detail::encoding_impl<std::uint8_t>& other)
+{
+    // The transcoding to another single-byte encoding is provided by the
+    // from8 function of the destination encoding, which is tried first.
+    if (other.id == strf::encoding_id::eid_utf8) {
+        static const strf::detail::transcoder_impl<std::uint8_t, std::uint8_t> tr_obj =
+            { to_utf8, to_utf8_size };
+        return & tr_obj;
+    }
+    return nullptr;
+}
+
+template <class Impl>
+STRF_HD const strf::detail::transcoder_impl<char16_t, std::uint8_t>*
+single_byte_encoding<Impl>::from16(const strf::detail::encoding_impl<char16_t>& other)
+{
+    if (other.id == strf::encoding_id::eid_utf16) {
+        static const strf::detail::transcoder_impl<char16_t, std::uint8_t> tr_obj =
+            { from_utf16, strf::detail::utf16_to_utf32_size };
+        return & tr_obj;
+    }
+    return nullptr;
+}
+
+template <class Impl>
+STRF_HD const strf::detail::transcoder_impl<std::uint8_t, char16_t>*
+single_byte_encoding<Impl>::to16(const strf::detail::encoding_impl<char16_t>& other)
+{
+    if (other.id == strf::encoding_id::eid_utf16) {
+        static const strf::detail::transcoder_impl<std::uint8_t, char16_t> tr_obj =
+            { to_utf16, detail::same_size<std::uint8_t> };
+        return & tr_obj;
+    }
+    return nullptr;
 }
 
 STRF_INLINE
@@ -557,7 +1023,9 @@ STRF_HD const strf::detail::encoding_impl<std::uint8_t>& windows_1252_impl()
          , impl::codepoints_count
          , impl::write_replacement_char
          , impl::decode_single_char
-         , nullptr, nullptr, nullptr, nullptr, nullptr, nullptr
+         , impl::from8, impl::to8
+         , impl::from16, impl::to16
+         , nullptr, nullptr
          , "windows-1252"
          , strf::encoding_id::eid_windows_1252
          , 1, 0x0, 0x7F };
@@ -578,7 +1046,9 @@ STRF_HD const strf::detail::encoding_impl<std::uint8_t>& iso_8859_1_impl()
          , impl::codepoints_count
          , impl::write_replacement_char
          , impl::decode_single_char
-         , nullptr, nullptr, nullptr, nullptr, nullptr, nullptr
+         , impl::from8, impl::to8
+         , impl::from16, impl::to16
+         , nullptr, nullptr
          , "ISO-8859-1"
          , strf::encoding_id::eid_iso_8859_1
          , 1, 0x0, 0xFF };
@@ -599,7 +1069,9 @@ STRF_HD const strf::detail::encoding_impl<std::uint8_t>& iso_8859_3_impl()
          , impl::codepoints_count
          , impl::write_replacement_char
          , impl::decode_single_char
-         , nullptr, nullptr, nullptr, nullptr, nullptr, nullptr
+         , impl::from8, impl::to8
+         , impl::from16, impl::to16
+         , nullptr, nullptr
          , "ISO-8859-3"
          , strf::encoding_id::eid_iso_8859_3
          , 1, 0x0, 0xA0 };
@@ -622,7 +1094,9 @@ STRF_HD const strf::detail::encoding_impl<std::uint8_t>& iso_8859_15_impl()
          , impl::codepoints_count
          , impl::write_replacement_char
          , impl::decode_single_char
-         , nullptr, nullptr, nullptr, nullptr, nullptr, nullptr
+         , impl::from8, impl::to8
+         , impl::from16, impl::to16
+         , nullptr, nullptr
          , "ISO-8859-15"
          , strf::encoding_id::eid_iso_8859_15
          , 1, 0x0, 0xA3 };
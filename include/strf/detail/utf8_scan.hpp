@@ -0,0 +1,221 @@
+#ifndef STRF_DETAIL_UTF8_SCAN_HPP
+#define STRF_DETAIL_UTF8_SCAN_HPP
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+// Validation and counting of UTF-8 in blocks of bytes, shared by the
+// UTF-8 sanitizer, the size calculators and utf8_codepoints_count.
+// With SSE2, utf8_valid_prefix checks 16 bytes per iteration by
+// comparing each byte against the one to three bytes that precede it.
+// Otherwise it only skips ASCII, 8 bytes per iteration. In both cases
+// the invalid sequences are left to the scalar code, so that the
+// result is the same as if the whole input were processed byte by byte.
+
+#include <strf/detail/ascii_run.hpp>
+
+namespace strf {
+
+namespace detail {
+
+#if defined(STRF_ASCII_RUN_SSE2)
+
+inline __m128i utf8_scan_ge(__m128i bytes, std::uint8_t value) noexcept
+{
+    const __m128i v = _mm_set1_epi8(static_cast<char>(value));
+    return _mm_cmpeq_epi8(_mm_max_epu8(bytes, v), bytes);
+}
+
+inline __m128i utf8_scan_eq(__m128i bytes, std::uint8_t value) noexcept
+{
+    return _mm_cmpeq_epi8(bytes, _mm_set1_epi8(static_cast<char>(value)));
+}
+
+// Returns a mask of the bytes that are continuation bytes ( 0x80 to 0xBF )
+inline __m128i utf8_scan_continuations(__m128i bytes) noexcept
+{
+    return _mm_cmplt_epi8(bytes, _mm_set1_epi8(-0x40));
+}
+
+// Tests whether the 16 bytes in cur are valid UTF-8, given that prev
+// contains the 16 bytes that precede them, which are already known to be
+// valid. Multi-byte sequences that begin in prev are checked here,
+// while those that end after cur are checked with the next block.
+inline bool utf8_valid_block
+    ( __m128i cur
+    , __m128i prev
+    , strf::surrogate_policy allow_surr ) noexcept
+{
+    using strf::detail::utf8_scan_eq;
+    using strf::detail::utf8_scan_ge;
+
+    const __m128i prev1 = _mm_or_si128(_mm_slli_si128(cur, 1), _mm_srli_si128(prev, 15));
+    const __m128i prev2 = _mm_or_si128(_mm_slli_si128(cur, 2), _mm_srli_si128(prev, 14));
+    const __m128i prev3 = _mm_or_si128(_mm_slli_si128(cur, 3), _mm_srli_si128(prev, 13));
+
+    // A byte must be a continuation byte if and only if
+    // it is within the length announced by a leading byte
+    const __m128i expected_continuations = _mm_or_si128
+        ( _mm_or_si128(utf8_scan_ge(prev1, 0xC0), utf8_scan_ge(prev2, 0xE0))
+        , utf8_scan_ge(prev3, 0xF0) );
+    __m128i error = _mm_xor_si128
+        ( expected_continuations
+        , strf::detail::utf8_scan_continuations(cur) );
+
+    // Bytes that never appear in UTF-8
+    error = _mm_or_si128(error, utf8_scan_ge(cur, 0xF5));
+    error = _mm_or_si128
+        ( error
+        , utf8_scan_eq(_mm_and_si128(cur, _mm_set1_epi8(static_cast<char>(0xFE))), 0xC0) );
+
+    // Overlong sequences and code points above 0x10FFFF
+    error = _mm_or_si128
+        ( error
+        , _mm_andnot_si128(utf8_scan_ge(cur, 0xA0), utf8_scan_eq(prev1, 0xE0)) );
+    error = _mm_or_si128
+        ( error
+        , _mm_andnot_si128(utf8_scan_ge(cur, 0x90), utf8_scan_eq(prev1, 0xF0)) );
+    error = _mm_or_si128
+        ( error
+        , _mm_and_si128(utf8_scan_ge(cur, 0x90), utf8_scan_eq(prev1, 0xF4)) );
+
+    if (allow_surr == strf::surrogate_policy::strict) {
+        error = _mm_or_si128
+            ( error
+            , _mm_and_si128(utf8_scan_ge(cur, 0xA0), utf8_scan_eq(prev1, 0xED)) );
+    }
+    return _mm_movemask_epi8(error) == 0;
+}
+
+#endif // defined(STRF_ASCII_RUN_SSE2)
+
+// Returns the length of a prefix of [src, src + len) that is valid UTF-8
+// and that does not end in the middle of a multi-byte sequence.
+// src must not point to the middle of a multi-byte sequence.
+// The prefix is made of whole blocks of ascii_run_block_size bytes,
+// except that an incomplete sequence at its end is excluded from it.
+// Hence the returned value may be less than the length of the longest
+// valid prefix, and the remaining bytes are left to the caller.
+inline STRF_HD std::size_t utf8_valid_prefix
+    ( const std::uint8_t* src
+    , std::size_t len
+    , strf::surrogate_policy allow_surr ) noexcept
+{
+    std::size_t i = 0;
+
+#if defined(STRF_ASCII_RUN_SSE2)
+
+    __m128i prev = _mm_setzero_si128();
+    int prev_mask = 0;
+    for (; i + 16 <= len; i += 16) {
+        const __m128i cur = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        const int cur_mask = _mm_movemask_epi8(cur);
+        // An ASCII block is valid unless a sequence in the previous one is incomplete
+        if ( (cur_mask | (prev_mask >> 13)) != 0
+          && ! strf::detail::utf8_valid_block(cur, prev, allow_surr) ) {
+            break;
+        }
+        prev = cur;
+        prev_mask = cur_mask;
+    }
+    if (i != 0) {
+        if (src[i - 3] >= 0xF0) {
+            i -= 3;
+        } else if (src[i - 2] >= 0xE0) {
+            i -= 2;
+        } else if (src[i - 1] >= 0xC0) {
+            i -= 1;
+        }
+    }
+
+#else
+
+    (void) allow_surr;
+    for (; i + 8 <= len; i += 8) {
+        std::uint64_t word;
+        std::memcpy(&word, src + i, 8);
+        if (word & 0x8080808080808080ULL) {
+            break;
+        }
+    }
+
+#endif // defined(STRF_ASCII_RUN_SSE2)
+
+    return i;
+}
+
+// The number of code points and of supplementary code points
+// ( those encoded in four bytes ) in a valid UTF-8 string
+struct utf8_counts
+{
+    std::size_t codepoints;
+    std::size_t supplementary_codepoints;
+};
+
+// Counts the bytes in [src, src + len) that are not continuation bytes,
+// and those that are greater than or equal to 0xF0. For valid UTF-8,
+// these are the numbers of code points and supplementary code points.
+inline STRF_HD strf::detail::utf8_counts count_utf8
+    ( const std::uint8_t* src
+    , std::size_t len ) noexcept
+{
+    std::size_t i = 0;
+    std::size_t continuations = 0;
+    std::size_t four_bytes_leads = 0;
+
+#if defined(STRF_ASCII_RUN_SSE2)
+
+    const __m128i zero = _mm_setzero_si128();
+    while (i + 16 <= len) {
+        // Each byte of the accumulators counts up to 255 blocks
+        std::size_t blocks = (len - i) / 16;
+        if (blocks > 255) {
+            blocks = 255;
+        }
+        __m128i acc_cont = zero;
+        __m128i acc_lead4 = zero;
+        for (; blocks != 0; --blocks, i += 16) {
+            const __m128i cur = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            acc_cont = _mm_sub_epi8(acc_cont, strf::detail::utf8_scan_continuations(cur));
+            acc_lead4 = _mm_sub_epi8(acc_lead4, strf::detail::utf8_scan_ge(cur, 0xF0));
+        }
+        const __m128i sum_cont = _mm_sad_epu8(acc_cont, zero);
+        const __m128i sum_lead4 = _mm_sad_epu8(acc_lead4, zero);
+        continuations += static_cast<std::size_t>
+            ( _mm_cvtsi128_si32(sum_cont) + _mm_cvtsi128_si32(_mm_srli_si128(sum_cont, 8)) );
+        four_bytes_leads += static_cast<std::size_t>
+            ( _mm_cvtsi128_si32(sum_lead4) + _mm_cvtsi128_si32(_mm_srli_si128(sum_lead4, 8)) );
+    }
+
+#else
+
+    for (; i + 8 <= len; i += 8) {
+        std::uint64_t word;
+        std::memcpy(&word, src + i, 8);
+        // The highest bit of each byte tells whether that byte
+        // is a continuation byte ( 10xxxxxx ) or 11110xxx or above
+        const std::uint64_t cont = word & ~(word << 1) & 0x8080808080808080ULL;
+        const std::uint64_t lead4 = word & (word << 1) & (word << 2) & (word << 3)
+                                  & 0x8080808080808080ULL;
+        continuations += static_cast<std::size_t>
+            (((cont >> 7) * 0x0101010101010101ULL) >> 56);
+        four_bytes_leads += static_cast<std::size_t>
+            (((lead4 >> 7) * 0x0101010101010101ULL) >> 56);
+    }
+
+#endif // defined(STRF_ASCII_RUN_SSE2)
+
+    for (; i < len; ++i) {
+        continuations += (src[i] & 0xC0) == 0x80;
+        four_bytes_leads += src[i] >= 0xF0;
+    }
+    return {len - continuations, four_bytes_leads};
+}
+
+} // namespace detail
+
+} // namespace strf
+
+#endif  // STRF_DETAIL_UTF8_SCAN_HPP
+
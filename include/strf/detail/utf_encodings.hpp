@@ -6,6 +6,8 @@
 //  http://www.boost.org/LICENSE_1_0.txt)
 
 #include <strf/printer.hpp>
+#include <strf/detail/ascii_run.hpp>
+#include <strf/detail/utf8_scan.hpp>
 #include <cstdint>
 #include <cstddef> // for std::size_t
 
@@ -86,7 +88,7 @@ inline STRF_HD void repeat_sequence
     , std::size_t count
     , simple_array<CharT, N> seq )
 {
-    if (count * N <= ob.size()) {
+    if (count * N <= ob.size() || ob.reserve_contiguous(count * N)) {
         strf::detail::do_repeat_sequence(ob.pos(), count, seq);
         ob.advance(count * N);
     } else {
@@ -206,13 +208,29 @@ STRF_HD void utf8_to_utf32_transcode
     auto dest_it = ob.pos();
     auto dest_end = ob.end();
     char32_t ch32;
+    unsigned ascii_count = 0;
 
     while(src_it != src_end) {
         ch0 = (*src_it);
         ++src_it;
         if (ch0 < 0x80) {
-            ch32 = ch0;
-        } else if (0xC0 == (ch0 & 0xE0)) {
+            STRF_CHECK_DEST;
+            *dest_it = ch0;
+            ++dest_it;
+            if (++ascii_count == 8) {
+                // probably a long run of ASCII characters
+                std::size_t src_left = src_end - src_it;
+                std::size_t dest_left = dest_end - dest_it;
+                auto n = strf::detail::copy_ascii_run
+                    ( src_it, src_left < dest_left ? src_left : dest_left, dest_it );
+                src_it += n;
+                dest_it += n;
+                ascii_count = 0;
+            }
+            continue;
+        }
+        ascii_count = 0;
+        if (0xC0 == (ch0 & 0xE0)) {
             if(ch0 > 0xC1 && src_it != src_end && is_utf8_continuation(ch1 = * src_it)) {
                 ch32 = utf8_decode(ch0, ch1);
                 ++src_it;
@@ -266,34 +284,42 @@ STRF_STATIC_LINKAGE STRF_HD std::size_t utf8_to_utf32_size
     std::uint8_t ch0, ch1;
     const std::uint8_t* src_it = src;
     std::size_t size = 0;
-    while (src_it != src_end) {
-        ch0 = (*src_it);
-        ++src_it;
-        ++size;
-        if (0xC0 == (ch0 & 0xE0)) {
-            if (ch0 > 0xC1 && src_it != src_end && is_utf8_continuation(*src_it)) {
-                ++src_it;
-            }
-        } else if (0xE0 == ch0) {
-            if (   src_it != src_end && ((*src_it & 0xE0) == 0xA0)
-              && ++src_it != src_end && is_utf8_continuation(*src_it) )
-            {
-                ++src_it;
-            }
-        } else if (0xE0 == (ch0 & 0xF0)) {
-            if ( src_it != src_end && is_utf8_continuation(ch1 = *src_it)
-              && first_2_of_3_are_valid( ch0, ch1, allow_surr )
-              && ++src_it != src_end && is_utf8_continuation(*src_it) )
-            {
-                ++src_it;
-            }
-        } else if(0xEF < ch0) {
-            if (   src_it != src_end && is_utf8_continuation(ch1 = * src_it)
-              && first_2_of_4_are_valid(ch0, ch1)
-              && ++src_it != src_end && is_utf8_continuation(*src_it)
-              && ++src_it != src_end && is_utf8_continuation(*src_it) )
-            {
-                ++src_it;
+    while (src_it < src_end) {
+        auto valid_len = strf::detail::utf8_valid_prefix(src_it, src_end - src_it, allow_surr);
+        size += strf::detail::count_utf8(src_it, valid_len).codepoints;
+        src_it += valid_len;
+        auto scalar_end = ( src_end - src_it > (std::ptrdiff_t)(2 * ascii_run_block_size)
+                          ? src_it + 2 * ascii_run_block_size
+                          : src_end );
+        while (src_it < scalar_end) {
+            ch0 = (*src_it);
+            ++src_it;
+            ++size;
+            if (0xC0 == (ch0 & 0xE0)) {
+                if (ch0 > 0xC1 && src_it != src_end && is_utf8_continuation(*src_it)) {
+                    ++src_it;
+                }
+            } else if (0xE0 == ch0) {
+                if (   src_it != src_end && ((*src_it & 0xE0) == 0xA0)
+                  && ++src_it != src_end && is_utf8_continuation(*src_it) )
+                {
+                    ++src_it;
+                }
+            } else if (0xE0 == (ch0 & 0xF0)) {
+                if ( src_it != src_end && is_utf8_continuation(ch1 = *src_it)
+                  && first_2_of_3_are_valid( ch0, ch1, allow_surr )
+                  && ++src_it != src_end && is_utf8_continuation(*src_it) )
+                {
+                    ++src_it;
+                }
+            } else if(0xEF < ch0) {
+                if (   src_it != src_end && is_utf8_continuation(ch1 = * src_it)
+                  && first_2_of_4_are_valid(ch0, ch1)
+                  && ++src_it != src_end && is_utf8_continuation(*src_it)
+                  && ++src_it != src_end && is_utf8_continuation(*src_it) )
+                {
+                    ++src_it;
+                }
             }
         }
     }
@@ -313,70 +339,84 @@ STRF_STATIC_LINKAGE STRF_HD void utf8_sanitize
     auto src_it = src;
     auto dest_it = ob.pos();
     auto dest_end = ob.end();
-    while(src_it != src_end) {
-        ch0 = (*src_it);
-        ++src_it;
-        if(ch0 < 0x80) {
-            STRF_CHECK_DEST;
-            *dest_it = ch0;
-            ++dest_it;
-        } else if(0xC0 == (ch0 & 0xE0)) {
-            if(ch0 > 0xC1 && src_it != src_end && is_utf8_continuation(ch1 = * src_it)) {
-                STRF_CHECK_DEST_SIZE(2);
-                ++src_it;
-                dest_it[0] = ch0;
-                dest_it[1] = ch1;
-                dest_it += 2;
-            } else goto invalid_sequence;
-        } else if (0xE0 == ch0) {
-            if (   src_it != src_end && (((ch1 = * src_it) & 0xE0) == 0xA0)
-              && ++src_it != src_end && is_utf8_continuation(ch2 = * src_it) )
-            {
-                STRF_CHECK_DEST_SIZE(3);
-                ++src_it;
-                dest_it[0] = ch0;
-                dest_it[1] = ch1;
-                dest_it[2] = ch2;
-                dest_it += 3;
-            } else goto invalid_sequence;
-        } else if (0xE0 == (ch0 & 0xF0)) {
-            if (   src_it != src_end && is_utf8_continuation(ch1 = * src_it)
-              && first_2_of_3_are_valid(ch0, ch1, allow_surr)
-              && ++src_it != src_end && is_utf8_continuation(ch2 = * src_it) )
-            {
-                STRF_CHECK_DEST_SIZE(3);
-                ++src_it;
-                dest_it[0] = ch0;
-                dest_it[1] = ch1;
-                dest_it[2] = ch2;
-                dest_it += 3;
-            } else goto invalid_sequence;
-        } else if (0xF0 == (ch0 & 0xF8)) {
-            if ( src_it != src_end && is_utf8_continuation(ch1 = * src_it)
-              && first_2_of_4_are_valid(ch0, ch1)
-              && ++src_it != src_end && is_utf8_continuation(ch2 = * src_it)
-              && ++src_it != src_end && is_utf8_continuation(ch3 = * src_it) )
-            {
-                STRF_CHECK_DEST_SIZE(4);
-                ++src_it;
-                dest_it[0] = ch0;
-                dest_it[1] = ch1;
-                dest_it[2] = ch2;
-                dest_it[3] = ch3;
-                dest_it += 4;
-            } else goto invalid_sequence;
-        } else {
-            invalid_sequence:
-            if (err_hdl == strf::encoding_error::replace) {
-                STRF_CHECK_DEST_SIZE(3);
-                dest_it[0] = 0xEF;
-                dest_it[1] = 0xBF;
-                dest_it[2] = 0xBD;
-                dest_it += 3;
+    while(src_it < src_end) {
+        {
+            std::size_t dest_left = dest_end - dest_it;
+            std::size_t src_left = src_end - src_it;
+            auto valid_len = strf::detail::utf8_valid_prefix
+                ( src_it, (src_left < dest_left ? src_left : dest_left), allow_surr );
+            strf::detail::str_copy_n(dest_it, src_it, valid_len);
+            src_it += valid_len;
+            dest_it += valid_len;
+        }
+        auto scalar_end = ( src_end - src_it > (std::ptrdiff_t)(2 * ascii_run_block_size)
+                          ? src_it + 2 * ascii_run_block_size
+                          : src_end );
+        while (src_it < scalar_end) {
+            ch0 = (*src_it);
+            ++src_it;
+            if(ch0 < 0x80) {
+                STRF_CHECK_DEST;
+                *dest_it = ch0;
+                ++dest_it;
+            } else if(0xC0 == (ch0 & 0xE0)) {
+                if(ch0 > 0xC1 && src_it != src_end && is_utf8_continuation(ch1 = * src_it)) {
+                    STRF_CHECK_DEST_SIZE(2);
+                    ++src_it;
+                    dest_it[0] = ch0;
+                    dest_it[1] = ch1;
+                    dest_it += 2;
+                } else goto invalid_sequence;
+            } else if (0xE0 == ch0) {
+                if (   src_it != src_end && (((ch1 = * src_it) & 0xE0) == 0xA0)
+                  && ++src_it != src_end && is_utf8_continuation(ch2 = * src_it) )
+                {
+                    STRF_CHECK_DEST_SIZE(3);
+                    ++src_it;
+                    dest_it[0] = ch0;
+                    dest_it[1] = ch1;
+                    dest_it[2] = ch2;
+                    dest_it += 3;
+                } else goto invalid_sequence;
+            } else if (0xE0 == (ch0 & 0xF0)) {
+                if (   src_it != src_end && is_utf8_continuation(ch1 = * src_it)
+                  && first_2_of_3_are_valid(ch0, ch1, allow_surr)
+                  && ++src_it != src_end && is_utf8_continuation(ch2 = * src_it) )
+                {
+                    STRF_CHECK_DEST_SIZE(3);
+                    ++src_it;
+                    dest_it[0] = ch0;
+                    dest_it[1] = ch1;
+                    dest_it[2] = ch2;
+                    dest_it += 3;
+                } else goto invalid_sequence;
+            } else if (0xF0 == (ch0 & 0xF8)) {
+                if ( src_it != src_end && is_utf8_continuation(ch1 = * src_it)
+                  && first_2_of_4_are_valid(ch0, ch1)
+                  && ++src_it != src_end && is_utf8_continuation(ch2 = * src_it)
+                  && ++src_it != src_end && is_utf8_continuation(ch3 = * src_it) )
+                {
+                    STRF_CHECK_DEST_SIZE(4);
+                    ++src_it;
+                    dest_it[0] = ch0;
+                    dest_it[1] = ch1;
+                    dest_it[2] = ch2;
+                    dest_it[3] = ch3;
+                    dest_it += 4;
+                } else goto invalid_sequence;
             } else {
-                STRF_ASSERT(err_hdl == strf::encoding_error::stop);
-                ob.advance_to(dest_it);
-                strf::detail::handle_encoding_failure();
+                invalid_sequence:
+                if (err_hdl == strf::encoding_error::replace) {
+                    STRF_CHECK_DEST_SIZE(3);
+                    dest_it[0] = 0xEF;
+                    dest_it[1] = 0xBF;
+                    dest_it[2] = 0xBD;
+                    dest_it += 3;
+                } else {
+                    STRF_ASSERT(err_hdl == strf::encoding_error::stop);
+                    ob.advance_to(dest_it);
+                    strf::detail::handle_encoding_failure();
+                }
             }
         }
     }
@@ -392,45 +432,53 @@ STRF_STATIC_LINKAGE STRF_HD std::size_t utf8_sanitize_size
     std::uint8_t ch0, ch1;
     const std::uint8_t* src_it = src;
     std::size_t size = 0;
-    while(src_it != src_end) {
-        ch0 = *src_it;
-        ++src_it;
-        if(ch0 < 0x80) {
-            ++size;
-        } else if (0xC0 == (ch0 & 0xE0)) {
-            if (ch0 > 0xC1 && src_it != src_end && is_utf8_continuation(*src_it)) {
-                size += 2;
-                ++src_it;
-            } else {
+    while(src_it < src_end) {
+        auto valid_len = strf::detail::utf8_valid_prefix(src_it, src_end - src_it, allow_surr);
+        size += valid_len;
+        src_it += valid_len;
+        auto scalar_end = ( src_end - src_it > (std::ptrdiff_t)(2 * ascii_run_block_size)
+                          ? src_it + 2 * ascii_run_block_size
+                          : src_end );
+        while (src_it < scalar_end) {
+            ch0 = *src_it;
+            ++src_it;
+            if(ch0 < 0x80) {
+                ++size;
+            } else if (0xC0 == (ch0 & 0xE0)) {
+                if (ch0 > 0xC1 && src_it != src_end && is_utf8_continuation(*src_it)) {
+                    size += 2;
+                    ++src_it;
+                } else {
+                    size += 3;
+                }
+            } else if (0xE0 == ch0) {
+                if (   src_it != src_end && (((ch1 = * src_it) & 0xE0) == 0xA0)
+                  && ++src_it != src_end && is_utf8_continuation(* src_it) )
+                {
+                    size += 3;
+                    ++src_it;
+                } else {
+                    size += 3;
+                }
+            } else if (0xE0 == (ch0 & 0xF0)) {
                 size += 3;
-            }
-        } else if (0xE0 == ch0) {
-            if (   src_it != src_end && (((ch1 = * src_it) & 0xE0) == 0xA0)
-              && ++src_it != src_end && is_utf8_continuation(* src_it) )
+                if ( src_it != src_end && is_utf8_continuation(ch1 = * src_it)
+                  && first_2_of_3_are_valid( ch0, ch1, allow_surr )
+                  && ++src_it != src_end && is_utf8_continuation(* src_it) )
+                {
+                    ++src_it;
+                }
+            } else if( 0xEF < ch0
+                  &&   src_it != src_end && is_utf8_continuation(ch1 = * src_it)
+                  && first_2_of_4_are_valid(ch0, ch1)
+                  && ++src_it != src_end && is_utf8_continuation(*src_it)
+                  && ++src_it != src_end && is_utf8_continuation(*src_it) )
             {
-                size += 3;
+                size += 4;
                 ++src_it;
             } else {
                 size += 3;
             }
-        } else if (0xE0 == (ch0 & 0xF0)) {
-            size += 3;
-            if ( src_it != src_end && is_utf8_continuation(ch1 = * src_it)
-              && first_2_of_3_are_valid( ch0, ch1, allow_surr )
-              && ++src_it != src_end && is_utf8_continuation(* src_it) )
-            {
-                ++src_it;
-            }
-        } else if( 0xEF < ch0
-              &&   src_it != src_end && is_utf8_continuation(ch1 = * src_it)
-              && first_2_of_4_are_valid(ch0, ch1)
-              && ++src_it != src_end && is_utf8_continuation(*src_it)
-              && ++src_it != src_end && is_utf8_continuation(*src_it) )
-        {
-            size += 4;
-            ++src_it;
-        } else {
-            size += 3;
         }
     }
     return size;
@@ -442,7 +490,22 @@ STRF_STATIC_LINKAGE STRF_HD std::size_t utf8_codepoints_count
         , std::size_t max_count )
 {
     std::size_t count = 0;
-    for(auto it = begin; it != end && count < max_count; ++it) {
+    auto it = begin;
+    // Each byte adds at most one to the count, so it does not exceed
+    // max_count as long as the bytes counted in bulk do not either
+    while (true) {
+        std::size_t len = end - it;
+        if (len > max_count - count) {
+            len = max_count - count;
+        }
+        len -= len % ascii_run_block_size;
+        if (len == 0) {
+            break;
+        }
+        count += strf::detail::count_utf8(it, len).codepoints;
+        it += len;
+    }
+    for(; it != end && count < max_count; ++it) {
         if (!is_utf8_continuation(*it)) {
             ++ count;
         }
@@ -536,6 +599,133 @@ STRF_STATIC_LINKAGE STRF_HD std::uint8_t* utf8_encode_char
     return dest + 3;
 }
 
+#if defined(STRF_ASCII_RUN_SSE2)
+
+constexpr std::size_t utf8_bmp_block_size = 8;
+
+// Loads 8 code units into the 32-bit lanes of lo and hi
+inline void load_bmp_block(const char16_t* src, __m128i& lo, __m128i& hi) noexcept
+{
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+    lo = _mm_unpacklo_epi16(v, _mm_setzero_si128());
+    hi = _mm_unpackhi_epi16(v, _mm_setzero_si128());
+}
+
+inline void load_bmp_block(const char32_t* src, __m128i& lo, __m128i& hi) noexcept
+{
+    lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+    hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 4));
+}
+
+// Computes the UTF-8 sequences of four code points that are less
+// than 0x10000 and are not surrogates. Each sequence is placed in the
+// low bytes of a 32-bit lane, and its size in the same lane of sizes.
+inline __m128i bmp_to_utf8_words(__m128i ch, __m128i& sizes) noexcept
+{
+    const __m128i low6 = _mm_set1_epi32(0x3F);
+    const __m128i cont = _mm_set1_epi32(0x80);
+    const __m128i last = _mm_or_si128(_mm_and_si128(ch, low6), cont);
+    const __m128i middle = _mm_or_si128(_mm_and_si128(_mm_srli_epi32(ch, 6), low6), cont);
+    const __m128i two = _mm_or_si128
+        ( _mm_or_si128(_mm_srli_epi32(ch, 6), _mm_set1_epi32(0xC0))
+        , _mm_slli_epi32(last, 8) );
+    const __m128i three = _mm_or_si128
+        ( _mm_or_si128(_mm_srli_epi32(ch, 12), _mm_set1_epi32(0xE0))
+        , _mm_or_si128(_mm_slli_epi32(middle, 8), _mm_slli_epi32(last, 16)) );
+    const __m128i ge2 = _mm_cmpgt_epi32(ch, _mm_set1_epi32(0x7F));
+    const __m128i ge3 = _mm_cmpgt_epi32(ch, _mm_set1_epi32(0x7FF));
+    const __m128i w = _mm_or_si128(_mm_and_si128(ge2, two), _mm_andnot_si128(ge2, ch));
+    sizes = _mm_sub_epi32(_mm_sub_epi32(_mm_set1_epi32(1), ge2), ge3);
+    return _mm_or_si128(_mm_and_si128(ge3, three), _mm_andnot_si128(ge3, w));
+}
+
+// Writes each sequence with a 4 bytes store, and advances
+// dest by its actual size. Hence there are no branches.
+inline std::uint8_t* write_utf8_words
+    ( __m128i words
+    , __m128i sizes
+    , std::uint8_t* dest ) noexcept
+{
+    for (int i = 0; i < 4; ++i) {
+        const std::uint32_t w = static_cast<std::uint32_t>(_mm_cvtsi128_si32(words));
+        std::memcpy(dest, &w, 4);
+        dest += _mm_cvtsi128_si32(sizes);
+        words = _mm_srli_si128(words, 4);
+        sizes = _mm_srli_si128(sizes, 4);
+    }
+    return dest;
+}
+
+// Encodes in bulk the blocks of utf8_bmp_block_size code units that
+// contain neither surrogates nor supplementary code points, until it
+// reaches one that does, or the end of the input, or the end of dest.
+// The runs of ASCII characters are narrowed by narrow_ascii_run.
+// Updates src_it and dest_it.
+template <typename CharT>
+inline void utf8_encode_bmp_run
+    ( const CharT*& src_it
+    , const CharT* src_end
+    , std::uint8_t*& dest_it
+    , std::uint8_t* dest_end ) noexcept
+{
+    const __m128i zero = _mm_setzero_si128();
+    while ( src_end - src_it >= (std::ptrdiff_t)utf8_bmp_block_size
+         && dest_end - dest_it >= (std::ptrdiff_t)(3 * utf8_bmp_block_size + 1) )
+    {
+        __m128i lo, hi;
+        strf::detail::load_bmp_block(src_it, lo, hi);
+        const __m128i all = _mm_or_si128(lo, hi);
+        const __m128i ascii = _mm_cmpeq_epi32(_mm_and_si128(all, _mm_set1_epi32(-0x80)), zero);
+        if (_mm_movemask_epi8(ascii) == 0xFFFF) {
+            const __m128i bytes = _mm_packus_epi16(_mm_packs_epi32(lo, hi), zero);
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(dest_it), bytes);
+            src_it += utf8_bmp_block_size;
+            dest_it += utf8_bmp_block_size;
+            std::size_t src_left = src_end - src_it;
+            std::size_t dest_left = dest_end - dest_it;
+            auto n = strf::detail::narrow_ascii_run
+                ( src_it, src_left < dest_left ? src_left : dest_left, dest_it );
+            src_it += n;
+            dest_it += n;
+            continue;
+        }
+        const __m128i mask = _mm_set1_epi32(0xF800);
+        const __m128i surr = _mm_set1_epi32(0xD800);
+        const __m128i surrogates = _mm_or_si128
+            ( _mm_cmpeq_epi32(_mm_and_si128(lo, mask), surr)
+            , _mm_cmpeq_epi32(_mm_and_si128(hi, mask), surr) );
+        const __m128i bmp = _mm_cmpeq_epi32(_mm_srli_epi32(all, 16), zero);
+        if ( _mm_movemask_epi8(surrogates) != 0 || _mm_movemask_epi8(bmp) != 0xFFFF) {
+            return;
+        }
+        __m128i lo_sizes, hi_sizes;
+        const __m128i lo_words = strf::detail::bmp_to_utf8_words(lo, lo_sizes);
+        const __m128i hi_words = strf::detail::bmp_to_utf8_words(hi, hi_sizes);
+        dest_it = strf::detail::write_utf8_words(lo_words, lo_sizes, dest_it);
+        dest_it = strf::detail::write_utf8_words(hi_words, hi_sizes, dest_it);
+        src_it += utf8_bmp_block_size;
+    }
+}
+
+#else
+
+template <typename CharT>
+inline STRF_HD void utf8_encode_bmp_run
+    ( const CharT*& src_it
+    , const CharT* src_end
+    , std::uint8_t*& dest_it
+    , std::uint8_t* dest_end ) noexcept
+{
+    std::size_t src_left = src_end - src_it;
+    std::size_t dest_left = dest_end - dest_it;
+    auto n = strf::detail::narrow_ascii_run
+        ( src_it, src_left < dest_left ? src_left : dest_left, dest_it );
+    src_it += n;
+    dest_it += n;
+}
+
+#endif // defined(STRF_ASCII_RUN_SSE2)
+
 STRF_STATIC_LINKAGE STRF_HD void utf32_to_utf8_transcode
     ( strf::underlying_outbuf<1>& ob
     , const char32_t* src
@@ -546,49 +736,57 @@ STRF_STATIC_LINKAGE STRF_HD void utf32_to_utf8_transcode
     auto src_it = src;
     auto dest_it = ob.pos();
     auto dest_end = ob.end();
-    for(;src_it != src_end; ++src_it) {
-        auto ch = *src_it;
-        if(ch < 0x80) {
-            STRF_CHECK_DEST;
-            *dest_it = static_cast<std::uint8_t>(ch);
-            ++dest_it;
-        } else if (ch < 0x800) {
-            STRF_CHECK_DEST_SIZE(2);
-            dest_it[0] = static_cast<std::uint8_t>(0xC0 | ((ch & 0x7C0) >> 6));
-            dest_it[1] = static_cast<std::uint8_t>(0x80 |  (ch &  0x3F));
-            dest_it += 2;
-        } else if (ch < 0x10000) {
-            if ( allow_surr == strf::surrogate_policy::lax
-              || strf::detail::not_surrogate(ch))
-            {
-                STRF_CHECK_DEST_SIZE(3);
-                dest_it[0] = static_cast<std::uint8_t>(0xE0 | ((ch & 0xF000) >> 12));
-                dest_it[1] = static_cast<std::uint8_t>(0x80 | ((ch &  0xFC0) >> 6));
-                dest_it[2] = static_cast<std::uint8_t>(0x80 |  (ch &   0x3F));
-                dest_it += 3;
-            } else goto invalid_sequence;
-        } else if (ch < 0x110000) {
-            STRF_CHECK_DEST_SIZE(4);
-            dest_it[0] = static_cast<std::uint8_t>(0xF0 | ((ch & 0x1C0000) >> 18));
-            dest_it[1] = static_cast<std::uint8_t>(0x80 | ((ch &  0x3F000) >> 12));
-            dest_it[2] = static_cast<std::uint8_t>(0x80 | ((ch &    0xFC0) >> 6));
-            dest_it[3] = static_cast<std::uint8_t>(0x80 |  (ch &     0x3F));
-            dest_it += 4;
-        } else {
-            invalid_sequence:
-            switch (err_hdl) {
-                case strf::encoding_error::replace:
+    while (src_it != src_end) {
+        strf::detail::utf8_encode_bmp_run(src_it, src_end, dest_it, dest_end);
+        // What can not be encoded in bulk is encoded here one by one,
+        // along with the few code units that follow it
+        auto scalar_end = ( src_end - src_it > (std::ptrdiff_t)(2 * ascii_run_block_size)
+                          ? src_it + 2 * ascii_run_block_size
+                          : src_end );
+        for(;src_it != scalar_end; ++src_it) {
+            auto ch = *src_it;
+            if(ch < 0x80) {
+                STRF_CHECK_DEST;
+                *dest_it = static_cast<std::uint8_t>(ch);
+                ++dest_it;
+            } else if (ch < 0x800) {
+                STRF_CHECK_DEST_SIZE(2);
+                dest_it[0] = static_cast<std::uint8_t>(0xC0 | ((ch & 0x7C0) >> 6));
+                dest_it[1] = static_cast<std::uint8_t>(0x80 |  (ch &  0x3F));
+                dest_it += 2;
+            } else if (ch < 0x10000) {
+                if ( allow_surr == strf::surrogate_policy::lax
+                  || strf::detail::not_surrogate(ch))
+                {
                     STRF_CHECK_DEST_SIZE(3);
-                    dest_it[0] = 0xEF;
-                    dest_it[1] = 0xBF;
-                    dest_it[2] = 0xBD;
+                    dest_it[0] = static_cast<std::uint8_t>(0xE0 | ((ch & 0xF000) >> 12));
+                    dest_it[1] = static_cast<std::uint8_t>(0x80 | ((ch &  0xFC0) >> 6));
+                    dest_it[2] = static_cast<std::uint8_t>(0x80 |  (ch &   0x3F));
                     dest_it += 3;
-                    break;
-
-                default:
-                    STRF_ASSERT(err_hdl == strf::encoding_error::stop);
-                    ob.advance_to(dest_it);
-                    strf::detail::handle_encoding_failure();
+                } else goto invalid_sequence;
+            } else if (ch < 0x110000) {
+                STRF_CHECK_DEST_SIZE(4);
+                dest_it[0] = static_cast<std::uint8_t>(0xF0 | ((ch & 0x1C0000) >> 18));
+                dest_it[1] = static_cast<std::uint8_t>(0x80 | ((ch &  0x3F000) >> 12));
+                dest_it[2] = static_cast<std::uint8_t>(0x80 | ((ch &    0xFC0) >> 6));
+                dest_it[3] = static_cast<std::uint8_t>(0x80 |  (ch &     0x3F));
+                dest_it += 4;
+            } else {
+                invalid_sequence:
+                switch (err_hdl) {
+                    case strf::encoding_error::replace:
+                        STRF_CHECK_DEST_SIZE(3);
+                        dest_it[0] = 0xEF;
+                        dest_it[1] = 0xBF;
+                        dest_it[2] = 0xBD;
+                        dest_it += 3;
+                        break;
+
+                    default:
+                        STRF_ASSERT(err_hdl == strf::encoding_error::stop);
+                        ob.advance_to(dest_it);
+                        strf::detail::handle_encoding_failure();
+                }
             }
         }
     }
@@ -1032,6 +1230,7 @@ STRF_STATIC_LINKAGE STRF_HD void utf8_to_utf16_transcode
     auto src_it = src;
     auto dest_it = ob.pos();
     auto dest_end = ob.end();
+    unsigned ascii_count = 0;
 
     for (;src_it != src_end; ++dest_it) {
         ch0 = (*src_it);
@@ -1039,7 +1238,20 @@ STRF_STATIC_LINKAGE STRF_HD void utf8_to_utf16_transcode
         if (ch0 < 0x80) {
             STRF_CHECK_DEST;
             *dest_it = ch0;
-        } else if (0xC0 == (ch0 & 0xE0)) {
+            if (++ascii_count == 8) {
+                // probably a long run of ASCII characters
+                std::size_t src_left = src_end - src_it;
+                std::size_t dest_left = dest_end - dest_it - 1;
+                auto n = strf::detail::copy_ascii_run
+                    ( src_it, src_left < dest_left ? src_left : dest_left, dest_it + 1 );
+                src_it += n;
+                dest_it += n;
+                ascii_count = 0;
+            }
+            continue;
+        }
+        ascii_count = 0;
+        if (0xC0 == (ch0 & 0xE0)) {
             if ( ch0 > 0xC1
               && src_it != src_end && is_utf8_continuation(ch1 = * src_it))
             {
@@ -1103,37 +1315,46 @@ STRF_STATIC_LINKAGE STRF_HD std::size_t utf8_to_utf16_size
     std::uint8_t ch0, ch1;
     auto src_it = src_begin;
     while(src_it < src_end) {
-        ch0 = *src_it;
-        ++src_it;
-        ++size;
-        if (0xC0 == (ch0 & 0xE0)) {
-            if (ch0 > 0xC1 && src_it != src_end && is_utf8_continuation(*src_it)) {
-                ++src_it;
-            }
-        } else if (0xE0 == ch0) {
-            if (   src_it != src_end && (((ch1 = * src_it) & 0xE0) == 0xA0)
-              && ++src_it != src_end && is_utf8_continuation(* src_it) )
-            {
-                ++src_it;
-            }
-        } else if (0xE0 == (ch0 & 0xF0)) {
-            if ( src_it != src_end && is_utf8_continuation(ch1 = * src_it)
-              && first_2_of_3_are_valid( ch0, ch1, allow_surr )
-              && ++src_it != src_end && is_utf8_continuation(* src_it) )
-            {
-                ++src_it;
-            }
-        } else if(0xEF < ch0) {
-            if (   src_it != src_end && is_utf8_continuation(ch1 = * src_it)
-              && first_2_of_4_are_valid(ch0, ch1)
-              && ++src_it != src_end && is_utf8_continuation(*src_it)
-              && ++src_it != src_end && is_utf8_continuation(*src_it) )
-            {
-                ++src_it;
-                ++size;
+        auto valid_len = strf::detail::utf8_valid_prefix(src_it, src_end - src_it, allow_surr);
+        auto counts = strf::detail::count_utf8(src_it, valid_len);
+        size += counts.codepoints + counts.supplementary_codepoints;
+        src_it += valid_len;
+        auto scalar_end = ( src_end - src_it > (std::ptrdiff_t)(2 * ascii_run_block_size)
+                          ? src_it + 2 * ascii_run_block_size
+                          : src_end );
+        while (src_it < scalar_end) {
+            ch0 = *src_it;
+            ++src_it;
+            ++size;
+            if (0xC0 == (ch0 & 0xE0)) {
+                if (ch0 > 0xC1 && src_it != src_end && is_utf8_continuation(*src_it)) {
+                    ++src_it;
+                }
+            } else if (0xE0 == ch0) {
+                if (   src_it != src_end && (((ch1 = * src_it) & 0xE0) == 0xA0)
+                  && ++src_it != src_end && is_utf8_continuation(* src_it) )
+                {
+                    ++src_it;
+                }
+            } else if (0xE0 == (ch0 & 0xF0)) {
+                if ( src_it != src_end && is_utf8_continuation(ch1 = * src_it)
+                  && first_2_of_3_are_valid( ch0, ch1, allow_surr )
+                  && ++src_it != src_end && is_utf8_continuation(* src_it) )
+                {
+                    ++src_it;
+                }
+            } else if(0xEF < ch0) {
+                if (   src_it != src_end && is_utf8_continuation(ch1 = * src_it)
+                  && first_2_of_4_are_valid(ch0, ch1)
+                  && ++src_it != src_end && is_utf8_continuation(*src_it)
+                  && ++src_it != src_end && is_utf8_continuation(*src_it) )
+                {
+                    ++src_it;
+                    ++size;
+                }
             }
-        }
 
+        }
     }
     return size;
 }
@@ -1150,48 +1371,56 @@ STRF_STATIC_LINKAGE STRF_HD void utf16_to_utf8_transcode
     auto dest_it = ob.pos();
     auto dest_end = ob.end();
 
-    for( ; src_it < src_end; ++src_it) {
-        auto ch = *src_it;
-        if (ch < 0x80) {
-            STRF_CHECK_DEST;
-            *dest_it = static_cast<std::uint8_t>(ch);
-            ++dest_it;
-        } else if (ch < 0x800) {
-            STRF_CHECK_DEST_SIZE(2);
-            dest_it[0] = static_cast<std::uint8_t>(0xC0 | ((ch & 0x7C0) >> 6));
-            dest_it[1] = static_cast<std::uint8_t>(0x80 |  (ch &  0x3F));
-            dest_it += 2;
-        } else if (not_surrogate(ch)) {
-            three_bytes:
-            STRF_CHECK_DEST_SIZE(3);
-            dest_it[0] = static_cast<std::uint8_t>(0xE0 | ((ch & 0xF000) >> 12));
-            dest_it[1] = static_cast<std::uint8_t>(0x80 | ((ch &  0xFC0) >> 6));
-            dest_it[2] = static_cast<std::uint8_t>(0x80 |  (ch &   0x3F));
-            dest_it += 3;
-        } else if ( strf::detail::is_high_surrogate(ch)
-               && src_it != src_end
-               && strf::detail::is_low_surrogate(*(src_it + 1)))
-        {
-            STRF_CHECK_DEST_SIZE(4);
-            unsigned long ch2 = *++src_it;
-            unsigned long codepoint = 0x10000 + (((ch & 0x3FF) << 10) | (ch2 & 0x3FF));
-            dest_it[0] = static_cast<std::uint8_t>(0xF0 | ((codepoint & 0x1C0000) >> 18));
-            dest_it[1] = static_cast<std::uint8_t>(0x80 | ((codepoint &  0x3F000) >> 12));
-            dest_it[2] = static_cast<std::uint8_t>(0x80 | ((codepoint &    0xFC0) >> 6));
-            dest_it[3] = static_cast<std::uint8_t>(0x80 |  (codepoint &     0x3F));
-            dest_it += 4;
-        } else if (allow_surr == strf::surrogate_policy::lax) {
-            goto three_bytes;
-        } else { // invalid sequece
-            if (err_hdl == strf::encoding_error::stop) {
-                ob.advance_to(dest_it);
-                strf::detail::handle_encoding_failure();
+    while (src_it < src_end) {
+        strf::detail::utf8_encode_bmp_run(src_it, src_end, dest_it, dest_end);
+        // What can not be encoded in bulk is encoded here one by one,
+        // along with the few code units that follow it
+        auto scalar_end = ( src_end - src_it > (std::ptrdiff_t)(2 * ascii_run_block_size)
+                          ? src_it + 2 * ascii_run_block_size
+                          : src_end );
+        for( ; src_it < scalar_end; ++src_it) {
+            auto ch = *src_it;
+            if (ch < 0x80) {
+                STRF_CHECK_DEST;
+                *dest_it = static_cast<std::uint8_t>(ch);
+                ++dest_it;
+            } else if (ch < 0x800) {
+                STRF_CHECK_DEST_SIZE(2);
+                dest_it[0] = static_cast<std::uint8_t>(0xC0 | ((ch & 0x7C0) >> 6));
+                dest_it[1] = static_cast<std::uint8_t>(0x80 |  (ch &  0x3F));
+                dest_it += 2;
+            } else if (not_surrogate(ch)) {
+                three_bytes:
+                STRF_CHECK_DEST_SIZE(3);
+                dest_it[0] = static_cast<std::uint8_t>(0xE0 | ((ch & 0xF000) >> 12));
+                dest_it[1] = static_cast<std::uint8_t>(0x80 | ((ch &  0xFC0) >> 6));
+                dest_it[2] = static_cast<std::uint8_t>(0x80 |  (ch &   0x3F));
+                dest_it += 3;
+            } else if ( strf::detail::is_high_surrogate(ch)
+                   && src_it + 1 != src_end
+                   && strf::detail::is_low_surrogate(*(src_it + 1)))
+            {
+                STRF_CHECK_DEST_SIZE(4);
+                unsigned long ch2 = *++src_it;
+                unsigned long codepoint = 0x10000 + (((ch & 0x3FF) << 10) | (ch2 & 0x3FF));
+                dest_it[0] = static_cast<std::uint8_t>(0xF0 | ((codepoint & 0x1C0000) >> 18));
+                dest_it[1] = static_cast<std::uint8_t>(0x80 | ((codepoint &  0x3F000) >> 12));
+                dest_it[2] = static_cast<std::uint8_t>(0x80 | ((codepoint &    0xFC0) >> 6));
+                dest_it[3] = static_cast<std::uint8_t>(0x80 |  (codepoint &     0x3F));
+                dest_it += 4;
+            } else if (allow_surr == strf::surrogate_policy::lax) {
+                goto three_bytes;
+            } else { // invalid sequece
+                if (err_hdl == strf::encoding_error::stop) {
+                    ob.advance_to(dest_it);
+                    strf::detail::handle_encoding_failure();
+                }
+                STRF_CHECK_DEST_SIZE(3);
+                dest_it[0] = 0xEF;
+                dest_it[1] = 0xBF;
+                dest_it[2] = 0xBD;
+                dest_it += 3;
             }
-            STRF_CHECK_DEST_SIZE(3);
-            dest_it[0] = 0xEF;
-            dest_it[1] = 0xBF;
-            dest_it[2] = 0xBD;
-            dest_it += 3;
         }
     }
     ob.advance_to(dest_it);
@@ -97,8 +97,31 @@ public:
         require(s);
     }
 
+    // Unlike require, accepts any value of s. Returns true if, after
+    // this call, there is room for at least s contiguous characters.
+    // Otherwise nothing is changed, and the caller has to write
+    // the content piecewise.
+    STRF_HD bool reserve_contiguous(std::size_t s)
+    {
+        return pos() + s <= end() || do_reserve_contiguous(s);
+    }
+
     STRF_HD virtual void recycle() = 0;
 
+    // Called by reserve_contiguous when the remaining space is not
+    // enough. The default implementation only recycles the buffer
+    // if s is not greater than min_size_after_recycle. Classes that
+    // can provide more space ( like the ones that write into a growing
+    // string ) may override it.
+    STRF_HD virtual bool do_reserve_contiguous(std::size_t s);
+
+    // Writes the given content, possibly without copying it into the
+    // buffer. The default implementation copies it, recycling the buffer
+    // as many times as needed. Classes whose destination can receive
+    // a separate memory area ( like a file descriptor with writev )
+    // may override it to avoid such copy.
+    STRF_HD virtual void write_direct(const char_type* str, std::size_t len);
+
 protected:
 
     STRF_HD underlying_outbuf(char_type* pos_, char_type* end_) noexcept
@@ -170,6 +193,7 @@ public:
     using _underlying_impl::good;
     using _underlying_impl::require;
     using _underlying_impl::ensure;
+    using _underlying_impl::reserve_contiguous;
     using _underlying_impl::recycle;
 
 protected:
@@ -268,6 +292,23 @@ STRF_HD void outbuf_write_continuation(Outbuf& ob, const CharT* str, std::size_t
 #  pragma GCC diagnostic pop
 #endif
 
+template <typename CharT>
+STRF_HD void outbuf_write_direct
+    ( strf::basic_outbuf<CharT>& ob, const CharT* str, std::size_t len )
+{
+    using uchar_t = strf::underlying_outbuf_char_type<sizeof(CharT)>;
+    ob.as_underlying().write_direct(reinterpret_cast<const uchar_t*>(str), len);
+}
+
+template <std::size_t CharSize>
+STRF_HD void outbuf_write_direct
+    ( strf::underlying_outbuf<CharSize>& ob
+    , const strf::underlying_outbuf_char_type<CharSize>* str
+    , std::size_t len )
+{
+    ob.write_direct(str, len);
+}
+
 template <typename Outbuf, typename CharT = typename Outbuf::char_type>
 STRF_HD void outbuf_write(Outbuf& ob, const CharT* str, std::size_t len)
 {
@@ -276,7 +317,9 @@ STRF_HD void outbuf_write(Outbuf& ob, const CharT* str, std::size_t len)
         strf::detail::str_copy_n(p, str, len);
         ob.advance(len);
     } else {
-        detail::outbuf_write_continuation<Outbuf, CharT>(ob, str, len);
+        // Let the outbuf decide whether the content is copied
+        // into the buffer or sent directly to the destination
+        strf::detail::outbuf_write_direct(ob, str, len);
     }
 }
 
@@ -296,6 +339,28 @@ STRF_HD void outbuf_put(Outbuf& ob, CharT c)
 
 } // namespace detail
 
+template <std::size_t CharSize>
+STRF_HD bool underlying_outbuf<CharSize>::do_reserve_contiguous(std::size_t s)
+{
+    if (s <= strf::min_size_after_recycle<char_type>()) {
+        recycle();
+        return true;
+    }
+    return false;
+}
+
+template <std::size_t CharSize>
+STRF_HD void underlying_outbuf<CharSize>::write_direct
+    ( const char_type* str, std::size_t len )
+{
+    if (pos() + len <= end()) {
+        strf::detail::str_copy_n(pos(), str, len);
+        advance(len);
+    } else {
+        strf::detail::outbuf_write_continuation(*this, str, len);
+    }
+}
+
 template <std::size_t CharSize>
 inline STRF_HD void write
     ( strf::underlying_outbuf<CharSize>& ob
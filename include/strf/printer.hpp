@@ -96,7 +96,7 @@ inline STRF_HD void write_fill
     , typename strf::underlying_outbuf<CharSize>::char_type ch )
 {
     using char_type = typename strf::underlying_outbuf<CharSize>::char_type;
-    if (count <= ob.size()) { // the common case
+    if (count <= ob.size() || ob.reserve_contiguous(count)) {
         strf::detail::char_assign<char_type>(ob.pos(), count, ch);
         ob.advance(count);
     } else {
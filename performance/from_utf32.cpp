@@ -12,6 +12,7 @@
 
 #include <strf.hpp>
 #include "loop_timer.hpp"
+#include "multilingual_samples.hpp"
 
 int main()
 {
@@ -28,11 +29,11 @@ int main()
 
     PRINT_BENCHMARK("strf::to(u16dest) (u32sample1)")
     {
-        (void)strf::to(u16dest) (u32sample1);
+        (void)strf::to(u16dest) (strf::cv(u32sample1));
     }
     PRINT_BENCHMARK("strf::to(u16dest) (u32sample4)")
     {
-        (void)strf::to(u16dest) (u32sample4);
+        (void)strf::to(u16dest) (strf::cv(u32sample4));
     }
 
     std::cout << "\nUTF-32 to UTF-8\n";
@@ -43,19 +44,50 @@ int main()
 
     PRINT_BENCHMARK("strf::to(u8dest) (u32sample1)")
     {
-        (void)strf::to(u8dest) (u32sample1);
+        (void)strf::to(u8dest) (strf::cv(u32sample1));
     }
     PRINT_BENCHMARK("strf::to(u8dest) (u32sample2)")
     {
-        (void)strf::to(u8dest) (u32sample2);
+        (void)strf::to(u8dest) (strf::cv(u32sample2));
     }
     PRINT_BENCHMARK("strf::to(u8dest) (u32sample3)")
     {
-        (void)strf::to(u8dest) (u32sample3);
+        (void)strf::to(u8dest) (strf::cv(u32sample3));
     }
     PRINT_BENCHMARK("strf::to(u8dest) (u32sample4)")
     {
-        (void)strf::to(u8dest) (u32sample4);
+        (void)strf::to(u8dest) (strf::cv(u32sample4));
+    }
+
+    // Larger samples, to measure the throughput
+    const multilingual_samples samples(30000);
+
+    std::cout << "\nUTF-32 to UTF-8 ( random words, 30000 code points )\n";
+
+    PRINT_BENCHMARK_THROUGHPUT(samples.ascii.size() * 4, "strf::to(u8dest)(strf::cv(samples.ascii))")
+    {
+        (void) strf::to(u8dest)(strf::cv(samples.ascii));
+        clobber();
+    }
+    PRINT_BENCHMARK_THROUGHPUT(samples.latin.size() * 4, "strf::to(u8dest)(strf::cv(samples.latin))")
+    {
+        (void) strf::to(u8dest)(strf::cv(samples.latin));
+        clobber();
+    }
+    PRINT_BENCHMARK_THROUGHPUT(samples.cyrillic.size() * 4, "strf::to(u8dest)(strf::cv(samples.cyrillic))")
+    {
+        (void) strf::to(u8dest)(strf::cv(samples.cyrillic));
+        clobber();
+    }
+    PRINT_BENCHMARK_THROUGHPUT(samples.cjk.size() * 4, "strf::to(u8dest)(strf::cv(samples.cjk))")
+    {
+        (void) strf::to(u8dest)(strf::cv(samples.cjk));
+        clobber();
+    }
+    PRINT_BENCHMARK_THROUGHPUT(samples.emoji.size() * 4, "strf::to(u8dest)(strf::cv(samples.emoji))")
+    {
+        (void) strf::to(u8dest)(strf::cv(samples.emoji));
+        clobber();
     }
 
 #if ! defined(_MSC_VER)
@@ -51,6 +51,37 @@ public:
         std::string m_label;
     };
 
+    // Also reports the throughput, given the number of bytes
+    // processed in each iteration
+    struct throughput_reporter
+    {
+        throughput_reporter(const std::string& label, std::size_t bytes)
+            : m_label(label)
+            , m_bytes(bytes)
+        {
+        }
+
+        void operator()(result r)
+        {
+            std::chrono::duration<double, std::nano>  total_ns = r.total_duration;
+            double ns = total_ns.count() / (double)r.iterations_count;
+            std::cout
+                << std::setprecision(2)
+                << std::fixed
+                << std::setw(9)
+                << ns
+                << " ns | "
+                << std::setw(6)
+                << (double)m_bytes / ns
+                << " GB/s | "
+                << m_label
+                << std::endl;
+        }
+
+        std::string m_label;
+        std::size_t m_bytes;
+    };
+
 
     /**
        \param loop_relative_size duration of loop / resolution of the clock
@@ -151,6 +182,12 @@ private:
 
 #define PRINT_BENCHMARK(LABEL) LOOP_TIMER((LABEL), std::chrono::seconds{10})
 
+#define PRINT_BENCHMARK_THROUGHPUT(BYTES, LABEL)                         \
+    for( loop_timer loop_timer_obj                                       \
+             ( loop_timer::throughput_reporter((LABEL), (BYTES))         \
+             , std::chrono::seconds{10} )                                \
+       ; loop_timer_obj.shall_continue(); )
+
 #define PRINT_BENCHMARK_N(N, LABEL) LOOP_TIMER_N((N), (LABEL), std::chrono::seconds{10})
 
 
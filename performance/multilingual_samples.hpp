@@ -0,0 +1,72 @@
+#ifndef STRF_PERFORMANCE_MULTILINGUAL_SAMPLES_HPP
+#define STRF_PERFORMANCE_MULTILINGUAL_SAMPLES_HPP
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <initializer_list>
+#include <random>
+#include <string>
+#include <vector>
+
+// Text made of words chosen at random ( with a fixed seed ) from a
+// small vocabulary. Unlike a repeated phrase, it does not allow the
+// branch predictor to learn the sequence of character sizes, which
+// would make the transcoding look faster than it is for real text.
+inline std::u32string random_words_text
+    ( std::initializer_list<const char32_t*> vocabulary
+    , std::size_t size )
+{
+    std::vector<const char32_t*> words(vocabulary);
+    std::mt19937 rng(12345);
+    std::u32string str;
+    while (str.size() < size) {
+        str.append(words[rng() % words.size()]);
+        str.append(rng() % 8 == 0 ? U", " : U" ");
+    }
+    str.resize(size);
+    return str;
+}
+
+struct multilingual_samples
+{
+    explicit multilingual_samples(std::size_t size)
+        : ascii(random_words_text
+            ( { U"the", U"quick", U"brown", U"fox", U"jumps", U"over", U"lazy"
+              , U"dog", U"and", U"then", U"runs", U"away", U"2019", U"(ok)" }
+            , size ))
+        , latin(random_words_text
+            ( { U"voilà", U"où", U"ça", U"coûte", U"très"
+              , U"cher", U"n'est-ce", U"pas", U"le", U"cœur", U"raison"
+              , U"été", U"la", U"de" }
+            , size ))
+        , cyrillic(random_words_text
+            ( { U"съешь", U"же"
+              , U"ещё", U"этих"
+              , U"мягких", U"булок"
+              , U"да", U"выпей", U"чаю"
+              , U"и", U"в", U"2019" }
+            , size ))
+        , cjk(random_words_text
+            ( { U"文字化け", U"字符集", U"中文"
+              , U"日本語", U"テキスト", U"123"
+              , U"漢字", U"の", U"は", U"です"
+              , U"、", U"。" }
+            , size ))
+        , emoji(random_words_text
+            ( { U"emoji", U"\U0001F600", U"text", U"\U0001F680", U"ok"
+              , U"\U0001F600\U0001F44D", U"fine", U"café", U"ж"
+              , U"中" }
+            , size ))
+    {
+    }
+
+    std::u32string ascii;
+    std::u32string latin;
+    std::u32string cyrillic;
+    std::u32string cjk;
+    std::u32string emoji;
+};
+
+#endif  // STRF_PERFORMANCE_MULTILINGUAL_SAMPLES_HPP
@@ -0,0 +1,79 @@
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#define  _CRT_SECURE_NO_WARNINGS
+
+#include <iostream>
+#include <string>
+
+#include <strf.hpp>
+#include "loop_timer.hpp"
+#include "multilingual_samples.hpp"
+
+int main()
+{
+    const multilingual_samples samples(30000);
+    const auto cp1252 = strf::windows_1252<char>();
+    const auto latin1 = strf::iso_8859_1<char>();
+    const std::string ascii = strf::to_string.with(cp1252)(strf::cv(samples.ascii));
+    const std::string latin = strf::to_string.with(cp1252)(strf::cv(samples.latin));
+    const std::string u8latin = strf::to_string(strf::cv(samples.latin));
+
+    char u8dest[100000];
+    char16_t u16dest[100000];
+    escape(u8dest);
+    escape(u16dest);
+
+    std::cout << "\nWindows-1252 to UTF-8 ( random words, 30000 code points )\n";
+
+    PRINT_BENCHMARK_THROUGHPUT(ascii.size(), "strf::to(u8dest)(strf::cv(ascii, cp1252))")
+    {
+        (void) strf::to(u8dest)(strf::cv(ascii, cp1252));
+        clobber();
+    }
+    PRINT_BENCHMARK_THROUGHPUT(latin.size(), "strf::to(u8dest)(strf::cv(latin, cp1252))")
+    {
+        (void) strf::to(u8dest)(strf::cv(latin, cp1252));
+        clobber();
+    }
+    PRINT_BENCHMARK_THROUGHPUT(latin.size(), "strf::to_string.reserve_calc()(strf::cv(latin, cp1252))")
+    {
+        auto str = strf::to_string.reserve_calc()(strf::cv(latin, cp1252));
+        escape(str);
+    }
+
+    std::cout << "\nUTF-8 to Windows-1252\n";
+
+    PRINT_BENCHMARK_THROUGHPUT(u8latin.size(), "strf::to(u8dest).with(cp1252)(strf::cv(u8latin, strf::utf8<char>()))")
+    {
+        (void) strf::to(u8dest).with(cp1252)(strf::cv(u8latin, strf::utf8<char>()));
+        clobber();
+    }
+
+    std::cout << "\nUTF-32 to single-byte encodings\n";
+
+    PRINT_BENCHMARK_THROUGHPUT(samples.latin.size() * 4, "strf::to(u8dest).with(cp1252)(strf::cv(samples.latin))")
+    {
+        (void) strf::to(u8dest).with(cp1252)(strf::cv(samples.latin));
+        clobber();
+    }
+    PRINT_BENCHMARK_THROUGHPUT(samples.latin.size() * 4, "strf::to(u8dest).with(strf::iso_8859_3<char>())(strf::cv(samples.latin))")
+    {
+        (void) strf::to(u8dest).with(strf::iso_8859_3<char>())(strf::cv(samples.latin));
+        clobber();
+    }
+
+    std::cout << "\nOther pairs\n";
+
+    PRINT_BENCHMARK_THROUGHPUT(latin.size(), "strf::to(u16dest)(strf::cv(latin, latin1))")
+    {
+        (void) strf::to(u16dest)(strf::cv(latin, latin1));
+        clobber();
+    }
+    PRINT_BENCHMARK_THROUGHPUT(latin.size(), "strf::to(u8dest).with(strf::iso_8859_15<char>())(strf::cv(latin, cp1252))")
+    {
+        (void) strf::to(u8dest).with(strf::iso_8859_15<char>())(strf::cv(latin, cp1252));
+        clobber();
+    }
+}
@@ -0,0 +1,117 @@
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#define  _CRT_SECURE_NO_WARNINGS
+
+#include <cstdio>
+#include <cwchar>
+#include <string>
+#include <strf.hpp>
+#include "loop_timer.hpp"
+
+// The implementation of strf::wide_cfile_writer before it started to
+// use std::fputws: one call to std::fputwc per character.
+class per_char_wide_cfile_writer final
+    : public strf::basic_outbuf_noexcept<wchar_t>
+{
+public:
+
+    explicit per_char_wide_cfile_writer(std::FILE* dest_)
+        : strf::basic_outbuf_noexcept<wchar_t>(_buf, _buf_size)
+        , _dest(dest_)
+    {
+    }
+
+    void recycle() noexcept override
+    {
+        auto p = this->pos();
+        this->set_pos(_buf);
+        if (this->good()) {
+            for (auto it = _buf; it != p; ++it, ++_count) {
+                if(std::fputwc(*it, _dest) == WEOF) {
+                    this->set_good(false);
+                    break;
+                }
+            }
+        }
+    }
+
+    std::size_t finish()
+    {
+        recycle();
+        this->set_good(false);
+        return _count;
+    }
+
+private:
+
+    std::FILE* _dest;
+    std::size_t _count = 0;
+    static constexpr std::size_t _buf_size
+        = strf::min_size_after_recycle<wchar_t>();
+    wchar_t _buf[_buf_size];
+};
+
+int main()
+{
+#if defined(_WIN32)
+    std::FILE* narrow_dest = std::fopen("NUL", "w");
+    std::FILE* wide_dest = std::fopen("NUL", "w");
+#else
+    std::FILE* narrow_dest = std::fopen("/dev/null", "w");
+    std::FILE* wide_dest = std::fopen("/dev/null", "w");
+#endif
+    std::fwide(wide_dest, 1);
+
+    const std::string short_str = "Hello World!";
+    const std::string long_str(4000, 'x');
+    const std::wstring short_wstr = L"Hello World!";
+    const std::wstring long_wstr(4000, L'x');
+
+    std::cout << "\nShort string ( " << short_str.size() << " characters )\n";
+
+    PRINT_BENCHMARK("strf::to(narrow_dest)        (short_str, 123456, '\\n')")
+    {
+        strf::to(narrow_dest)(short_str, 123456, '\n');
+    }
+    PRINT_BENCHMARK("strf::to_locked(narrow_dest) (short_str, 123456, '\\n')")
+    {
+        strf::to_locked(narrow_dest)(short_str, 123456, '\n');
+    }
+    PRINT_BENCHMARK("strf::wto(wide_dest)         (short_wstr, 123456, L'\\n')")
+    {
+        strf::wto(wide_dest)(short_wstr, 123456, L'\n');
+    }
+    PRINT_BENCHMARK("per_char_wide_cfile_writer   (short_wstr, 123456, L'\\n')")
+    {
+        per_char_wide_cfile_writer ob(wide_dest);
+        strf::to(ob)(short_wstr, 123456, L'\n');
+        ob.finish();
+    }
+
+    std::cout << "\nLong string ( " << long_str.size() << " characters )\n";
+
+    PRINT_BENCHMARK("strf::to(narrow_dest)        (long_str, '\\n')")
+    {
+        strf::to(narrow_dest)(long_str, '\n');
+    }
+    PRINT_BENCHMARK("strf::to_locked(narrow_dest) (long_str, '\\n')")
+    {
+        strf::to_locked(narrow_dest)(long_str, '\n');
+    }
+    PRINT_BENCHMARK("strf::wto(wide_dest)         (long_wstr, L'\\n')")
+    {
+        strf::wto(wide_dest)(long_wstr, L'\n');
+    }
+    PRINT_BENCHMARK("per_char_wide_cfile_writer   (long_wstr, L'\\n')")
+    {
+        per_char_wide_cfile_writer ob(wide_dest);
+        strf::to(ob)(long_wstr, L'\n');
+        ob.finish();
+    }
+
+    std::fclose(narrow_dest);
+    std::fclose(wide_dest);
+    return 0;
+}
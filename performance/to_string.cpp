@@ -145,6 +145,21 @@ int main()
         auto str = strf::to_string .no_reserve() ("ten = ", 10, ", twenty = ", 20);
         escape(str.data());
     }
+    PRINT_BENCHMARK("strf::to_small_string<64>       (\"ten = \", 10, \", twenty = \", 20)")
+    {
+        auto str = strf::to_small_string<64> ("ten = ", 10, ", twenty = ", 20);
+        escape(str.data());
+    }
+    PRINT_BENCHMARK("strf::to_pooled_string          (\"ten = \", 10, \", twenty = \", 20)")
+    {
+        auto str = strf::to_pooled_string ("ten = ", 10, ", twenty = ", 20);
+        escape(str.data());
+    }
+    PRINT_BENCHMARK("strf::to_tls_view               (\"ten = \", 10, \", twenty = \", 20)")
+    {
+        auto str = strf::to_tls_view ("ten = ", 10, ", twenty = ", 20);
+        escape(&*str.begin());
+    }
     PRINT_BENCHMARK("strf::to_string .reserve_calc() .tr(\"ten = {}, twenty = {}\", 10, 20)")
     {
         auto str = strf::to_string .reserve_calc() .tr("ten = {}, twenty = {}", 10, 20);
@@ -166,6 +181,31 @@ int main()
         escape(str.data());
     }
 
+    std::cout << "\n";
+
+    PRINT_BENCHMARK("strf::to_string .reserve_calc()         (\"key: \", right(x, 30), ...)")
+    {
+        auto str = strf::to_string .reserve_calc()
+            ( "key: ", strf::right(1234567, 30), ", value: ", strf::fixed(3.25, 40)
+            , ", label: ", strf::center("abc", 30, '.') );
+        escape(str.data());
+    }
+    PRINT_BENCHMARK("strf::to_string .reserve_predicted(pred) (\"key: \", right(x, 30), ...)")
+    {
+        static strf::size_predictor pred;
+        auto str = strf::to_string .reserve_predicted(pred)
+            ( "key: ", strf::right(1234567, 30), ", value: ", strf::fixed(3.25, 40)
+            , ", label: ", strf::center("abc", 30, '.') );
+        escape(str.data());
+    }
+    PRINT_BENCHMARK("strf::to_string .no_reserve()           (\"key: \", right(x, 30), ...)")
+    {
+        auto str = strf::to_string .no_reserve()
+            ( "key: ", strf::right(1234567, 30), ", value: ", strf::fixed(3.25, 40)
+            , ", label: ", strf::center("abc", 30, '.') );
+        escape(str.data());
+    }
+
     PRINT_BENCHMARK("oss << \"ten = \" << 10 << \", twenty = \" << 20")
     {
         std::ostringstream oss;
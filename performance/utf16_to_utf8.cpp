@@ -13,6 +13,7 @@
 
 #include <strf.hpp>
 #include "loop_timer.hpp"
+#include "multilingual_samples.hpp"
 
 int main()
 {
@@ -55,6 +56,42 @@ int main()
         clobber();
     }
 
+    // Larger samples, to measure the throughput
+    const multilingual_samples samples(30000);
+    const std::u16string u16ascii = strf::to_u16string(strf::cv(samples.ascii));
+    const std::u16string u16latin = strf::to_u16string(strf::cv(samples.latin));
+    const std::u16string u16cyrillic = strf::to_u16string(strf::cv(samples.cyrillic));
+    const std::u16string u16cjk = strf::to_u16string(strf::cv(samples.cjk));
+    const std::u16string u16emoji = strf::to_u16string(strf::cv(samples.emoji));
+
+    std::cout << "\nUTF-16 to UTF-8 ( random words, 30000 code points )\n";
+
+    PRINT_BENCHMARK_THROUGHPUT(u16ascii.size() * 2, "strf::to(u8dest)(strf::cv(u16ascii))")
+    {
+        (void) strf::to(u8dest)(strf::cv(u16ascii));
+        clobber();
+    }
+    PRINT_BENCHMARK_THROUGHPUT(u16latin.size() * 2, "strf::to(u8dest)(strf::cv(u16latin))")
+    {
+        (void) strf::to(u8dest)(strf::cv(u16latin));
+        clobber();
+    }
+    PRINT_BENCHMARK_THROUGHPUT(u16cyrillic.size() * 2, "strf::to(u8dest)(strf::cv(u16cyrillic))")
+    {
+        (void) strf::to(u8dest)(strf::cv(u16cyrillic));
+        clobber();
+    }
+    PRINT_BENCHMARK_THROUGHPUT(u16cjk.size() * 2, "strf::to(u8dest)(strf::cv(u16cjk))")
+    {
+        (void) strf::to(u8dest)(strf::cv(u16cjk));
+        clobber();
+    }
+    PRINT_BENCHMARK_THROUGHPUT(u16emoji.size() * 2, "strf::to(u8dest)(strf::cv(u16emoji))")
+    {
+        (void) strf::to(u8dest)(strf::cv(u16emoji));
+        clobber();
+    }
+
 #if defined(_MSC_VER)
 // disable warning that std::codecvt_utf8_utf16 is deprecated
 #pragma warning (disable:4996)
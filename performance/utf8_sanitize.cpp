@@ -0,0 +1,101 @@
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#define  _CRT_SECURE_NO_WARNINGS
+
+#include <iostream>
+#include <string>
+
+#include <strf.hpp>
+#include "loop_timer.hpp"
+#include "multilingual_samples.hpp"
+
+int main()
+{
+    const multilingual_samples samples(30000);
+    const std::string u8ascii = strf::to_string(strf::cv(samples.ascii));
+    const std::string u8latin = strf::to_string(strf::cv(samples.latin));
+    const std::string u8cyrillic = strf::to_string(strf::cv(samples.cyrillic));
+    const std::string u8cjk = strf::to_string(strf::cv(samples.cjk));
+    const std::string u8emoji = strf::to_string(strf::cv(samples.emoji));
+
+    char u8dest[200000];
+    escape(u8dest);
+
+    std::cout << "\nSanitizing UTF-8 ( random words, 30000 code points )\n";
+
+    PRINT_BENCHMARK_THROUGHPUT(u8ascii.size(), "strf::to(u8dest)(strf::sani(u8ascii))")
+    {
+        (void) strf::to(u8dest)(strf::sani(u8ascii));
+        clobber();
+    }
+    PRINT_BENCHMARK_THROUGHPUT(u8latin.size(), "strf::to(u8dest)(strf::sani(u8latin))")
+    {
+        (void) strf::to(u8dest)(strf::sani(u8latin));
+        clobber();
+    }
+    PRINT_BENCHMARK_THROUGHPUT(u8cyrillic.size(), "strf::to(u8dest)(strf::sani(u8cyrillic))")
+    {
+        (void) strf::to(u8dest)(strf::sani(u8cyrillic));
+        clobber();
+    }
+    PRINT_BENCHMARK_THROUGHPUT(u8cjk.size(), "strf::to(u8dest)(strf::sani(u8cjk))")
+    {
+        (void) strf::to(u8dest)(strf::sani(u8cjk));
+        clobber();
+    }
+    PRINT_BENCHMARK_THROUGHPUT(u8emoji.size(), "strf::to(u8dest)(strf::sani(u8emoji))")
+    {
+        (void) strf::to(u8dest)(strf::sani(u8emoji));
+        clobber();
+    }
+
+    std::cout << "\nSanitizing UTF-8 with reserve_calc() ( size pass and write pass )\n";
+
+    PRINT_BENCHMARK_THROUGHPUT(u8ascii.size(), "strf::to_string.reserve_calc()(strf::sani(u8ascii))")
+    {
+        auto str = strf::to_string.reserve_calc()(strf::sani(u8ascii));
+        escape(str);
+    }
+    PRINT_BENCHMARK_THROUGHPUT(u8cyrillic.size(), "strf::to_string.reserve_calc()(strf::sani(u8cyrillic))")
+    {
+        auto str = strf::to_string.reserve_calc()(strf::sani(u8cyrillic));
+        escape(str);
+    }
+    PRINT_BENCHMARK_THROUGHPUT(u8cjk.size(), "strf::to_string.reserve_calc()(strf::sani(u8cjk))")
+    {
+        auto str = strf::to_string.reserve_calc()(strf::sani(u8cjk));
+        escape(str);
+    }
+
+    std::cout << "\nUTF-8 to UTF-16 with reserve_calc()\n";
+
+    PRINT_BENCHMARK_THROUGHPUT(u8ascii.size(), "strf::to_u16string.reserve_calc()(strf::cv(u8ascii))")
+    {
+        auto str = strf::to_u16string.reserve_calc()(strf::cv(u8ascii));
+        escape(str);
+    }
+    PRINT_BENCHMARK_THROUGHPUT(u8cjk.size(), "strf::to_u16string.reserve_calc()(strf::cv(u8cjk))")
+    {
+        auto str = strf::to_u16string.reserve_calc()(strf::cv(u8cjk));
+        escape(str);
+    }
+
+    std::cout << "\nAlignment with width_as_u32len\n";
+
+    PRINT_BENCHMARK_THROUGHPUT(u8ascii.size(), "strf::to(u8dest).with(width_as_u32len)(strf::right(u8ascii, 40000))")
+    {
+        (void) strf::to(u8dest)
+            .with(strf::width_as_u32len<char>{})
+            (strf::right(u8ascii, 40000));
+        clobber();
+    }
+    PRINT_BENCHMARK_THROUGHPUT(u8cjk.size(), "strf::to(u8dest).with(width_as_u32len)(strf::right(u8cjk, 40000))")
+    {
+        (void) strf::to(u8dest)
+            .with(strf::width_as_u32len<char>{})
+            (strf::right(u8cjk, 40000));
+        clobber();
+    }
+}
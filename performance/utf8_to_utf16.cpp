@@ -13,6 +13,7 @@
 
 #include <strf.hpp>
 #include "loop_timer.hpp"
+#include "multilingual_samples.hpp"
 
 int main()
 {
@@ -57,6 +58,56 @@ int main()
         clobber();
     }
 
+    // Larger samples, to measure the throughput
+    const multilingual_samples samples(30000);
+    const std::string u8ascii = strf::to_string(strf::cv(samples.ascii));
+    const std::string u8latin = strf::to_string(strf::cv(samples.latin));
+    const std::string u8cyrillic = strf::to_string(strf::cv(samples.cyrillic));
+    const std::string u8cjk = strf::to_string(strf::cv(samples.cjk));
+    char32_t u32dest[100000];
+    escape(u32dest);
+
+    std::cout << "\nUTF-8 to UTF-16 ( random words, 30000 code points )\n";
+
+    PRINT_BENCHMARK_THROUGHPUT(u8ascii.size(), "strf::to(u16dest)(strf::cv(u8ascii))")
+    {
+        (void) strf::to(u16dest)(strf::cv(u8ascii));
+        clobber();
+    }
+    PRINT_BENCHMARK_THROUGHPUT(u8latin.size(), "strf::to(u16dest)(strf::cv(u8latin))")
+    {
+        (void) strf::to(u16dest)(strf::cv(u8latin));
+        clobber();
+    }
+    PRINT_BENCHMARK_THROUGHPUT(u8cyrillic.size(), "strf::to(u16dest)(strf::cv(u8cyrillic))")
+    {
+        (void) strf::to(u16dest)(strf::cv(u8cyrillic));
+        clobber();
+    }
+    PRINT_BENCHMARK_THROUGHPUT(u8cjk.size(), "strf::to(u16dest)(strf::cv(u8cjk))")
+    {
+        (void) strf::to(u16dest)(strf::cv(u8cjk));
+        clobber();
+    }
+
+    std::cout << "\nUTF-8 to UTF-32 ( random words, 30000 code points )\n";
+
+    PRINT_BENCHMARK_THROUGHPUT(u8ascii.size(), "strf::to(u32dest)(strf::cv(u8ascii))")
+    {
+        (void) strf::to(u32dest)(strf::cv(u8ascii));
+        clobber();
+    }
+    PRINT_BENCHMARK_THROUGHPUT(u8latin.size(), "strf::to(u32dest)(strf::cv(u8latin))")
+    {
+        (void) strf::to(u32dest)(strf::cv(u8latin));
+        clobber();
+    }
+    PRINT_BENCHMARK_THROUGHPUT(u8cjk.size(), "strf::to(u32dest)(strf::cv(u8cjk))")
+    {
+        (void) strf::to(u32dest)(strf::cv(u8cjk));
+        clobber();
+    }
+
 #if defined(_MSC_VER)
 // disable warning that std::codecvt_utf8_utf16 is deprecated
 #pragma warning (disable:4996)
@@ -0,0 +1,152 @@
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include "test_utils.hpp"
+#include <cstring>
+
+template <typename CharT>
+void test_arena_writer()
+{
+    auto tiny_str = test_utils::make_tiny_string<CharT>();
+    auto double_str = test_utils::make_double_string<CharT>();
+    std::basic_string<CharT> tiny_expected(tiny_str.begin(), tiny_str.end());
+    std::basic_string<CharT> double_expected(double_str.begin(), double_str.end());
+
+    strf::bump_arena arena(1000);
+    auto v1 = strf::to_arena<CharT>(arena)(tiny_str);
+    auto v2 = strf::to_arena<CharT>(arena)(double_str);
+    auto v3 = strf::to_arena<CharT>(arena).reserve_calc()(double_str, tiny_str);
+
+    TEST_TRUE(std::basic_string<CharT>(v1.begin(), v1.end()) == tiny_expected);
+    TEST_TRUE(std::basic_string<CharT>(v2.begin(), v2.end()) == double_expected);
+    TEST_TRUE(std::basic_string<CharT>(v3.begin(), v3.end()) == double_expected + tiny_expected);
+    TEST_TRUE(*(&*v1.begin() + v1.size()) == CharT());
+    TEST_TRUE(*(&*v2.begin() + v2.size()) == CharT());
+    TEST_TRUE(*(&*v3.begin() + v3.size()) == CharT());
+}
+
+void test_arena_locality()
+{
+    // Consecutive strings are contiguous in the arena,
+    // since the unused space is given back
+    char buff[500];
+    strf::bump_arena arena(buff, sizeof(buff));
+    auto v1 = strf::to_arena(arena)("Hello");
+    auto v2 = strf::to_arena(arena)("World");
+    TEST_TRUE(&*v1.begin() == buff);
+    TEST_TRUE(&*v2.begin() == buff + 6);
+    TEST_TRUE(std::string(buff, 12) == std::string("Hello\0World\0", 12));
+
+    // The string that does not fit in the initial buffer
+    // goes to a block allocated by the arena
+    auto v3 = strf::to_arena(arena)(strf::multi('x', 1000));
+    TEST_TRUE(std::string(v3.begin(), v3.end()) == std::string(1000, 'x'));
+    TEST_TRUE(&*v3.begin() < buff || &*v3.begin() >= buff + sizeof(buff));
+    TEST_TRUE(std::string(v1.begin(), v1.end()) == "Hello");
+
+    arena.release();
+    auto v4 = strf::to_arena(arena)("abc");
+    TEST_TRUE(&*v4.begin() == buff);
+}
+
+void test_arena_allocate()
+{
+    strf::bump_arena arena(256);
+    void* p1 = arena.allocate(10, 1);
+    void* p2 = arena.allocate(8, 8);
+    TEST_TRUE(reinterpret_cast<std::uintptr_t>(p2) % 8 == 0);
+    TEST_TRUE(static_cast<char*>(p2) >= static_cast<char*>(p1) + 10);
+    void* p3 = arena.allocate(1000);
+    TEST_TRUE(p3 != nullptr);
+    TEST_TRUE(reinterpret_cast<std::uintptr_t>(p3) % alignof(std::max_align_t) == 0);
+}
+
+void test_arena_reallocate_last()
+{
+    strf::bump_arena arena(256);
+    std::size_t obtained = 0;
+
+    // Extended in place when the block has room
+    char* p1 = static_cast<char*>(arena.allocate_at_least(10, 1, obtained));
+    std::memcpy(p1, "abcdefghij", 10);
+    arena.shrink_last(p1, 10);
+    char* p2 = static_cast<char*>(arena.reallocate_last_at_least(p1, 10, 100, 1, obtained));
+    TEST_TRUE(p2 == p1);
+    TEST_TRUE(obtained >= 100);
+
+    // Otherwise moved to a new block
+    char* p3 = static_cast<char*>(arena.reallocate_last_at_least(p2, 10, 1000, 1, obtained));
+    TEST_TRUE(p3 != p2);
+    TEST_TRUE(obtained >= 1000);
+    TEST_TRUE(std::string(p3, 10) == "abcdefghij");
+
+    // whose previous block is freed when it contains nothing else
+    char* p4 = static_cast<char*>(arena.reallocate_last_at_least(p3, 10, 5000, 1, obtained));
+    TEST_TRUE(obtained >= 5000);
+    TEST_TRUE(std::string(p4, 10) == "abcdefghij");
+
+    // A memory area that is not the last one is copied
+    arena.allocate(8);
+    char* p5 = static_cast<char*>(arena.reallocate_last_at_least(p4, 10, 20, 1, obtained));
+    TEST_TRUE(p5 != p4);
+    TEST_TRUE(std::string(p5, 10) == "abcdefghij");
+    TEST_TRUE(std::string(p4, 10) == "abcdefghij");
+}
+
+void test_arena_large_output()
+{
+    strf::bump_arena arena(64);
+    auto v = strf::to_arena(arena)(strf::multi('x', 100000), "abc");
+    TEST_EQ(v.size(), 100003);
+    TEST_TRUE(std::string(v.begin(), v.end()) == std::string(100000, 'x') + "abc");
+    TEST_TRUE(*(&*v.begin() + v.size()) == '\0');
+}
+
+#if defined(STRF_HAS_STD_PMR)
+
+void test_pmr_string()
+{
+    char buff[2000];
+    std::pmr::monotonic_buffer_resource mr(buff, sizeof(buff));
+    auto str = strf::to_pmr_string(&mr)("Hello ", strf::multi('x', 100));
+    TEST_TRUE(str == std::pmr::string("Hello ") + std::pmr::string(100, 'x'));
+    TEST_TRUE(str.get_allocator().resource() == &mr);
+    TEST_TRUE(str.data() >= buff && str.data() < buff + sizeof(buff));
+
+    auto str2 = strf::to_basic_pmr_string<char16_t>(&mr).reserve_calc()(u"abc", 123);
+    TEST_TRUE(str2 == u"abc123");
+    TEST_TRUE(str2.get_allocator().resource() == &mr);
+}
+
+#endif // defined(STRF_HAS_STD_PMR)
+
+void test_string_with_allocator()
+{
+    std::allocator<char16_t> a;
+    auto str = strf::to_basic_string_with_allocator(a)(u"abc", 123);
+    TEST_TRUE(str == u"abc123");
+    auto str2 = strf::to_basic_string_with_allocator(a).reserve(4)(u"abc", 123);
+    TEST_TRUE(str2 == u"abc123");
+}
+
+int main()
+{
+    test_arena_writer<char>();
+    test_arena_writer<char16_t>();
+    test_arena_writer<char32_t>();
+    test_arena_writer<wchar_t>();
+    test_arena_locality();
+    test_arena_allocate();
+    test_arena_reallocate_last();
+    test_arena_large_output();
+    test_string_with_allocator();
+
+#if defined(STRF_HAS_STD_PMR)
+
+    test_pmr_string();
+
+#endif // defined(STRF_HAS_STD_PMR)
+
+    return test_finish();
+}
@@ -0,0 +1,171 @@
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <chrono>
+#include <ctime>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include "test_utils.hpp"
+#include <strf/detail/output_types/async_fd.hpp>
+
+void test_successfull_writing()
+{
+    auto tiny_str = test_utils::make_tiny_string<char>();
+    auto double_str = test_utils::make_double_string<char>();
+
+    auto path = test_utils::unique_tmp_file_name();
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    TEST_TRUE(fd >= 0);
+    {
+        strf::async_fd_sink sink(fd, 100, 4);
+        strf::async_fd_writer writer(sink);
+        write(writer, tiny_str.begin(), tiny_str.size());
+        write(writer, double_str.begin(), double_str.size());
+        writer.finish();
+        sink.flush();
+        TEST_TRUE(sink.good());
+        TEST_EQ(sink.bytes_written(), tiny_str.size() + double_str.size());
+    }
+    ::close(fd);
+
+    auto obtained_content = test_utils::read_file<char>(path.c_str());
+    std::remove(path.c_str());
+
+    std::string expected(tiny_str.begin(), tiny_str.size());
+    expected.append(double_str.begin(), double_str.size());
+    TEST_TRUE(obtained_content == expected);
+}
+
+void test_unfinished_writer()
+{
+    // Content of a writer destroyed before finish() is discarded
+    auto path = test_utils::unique_tmp_file_name();
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    TEST_TRUE(fd >= 0);
+    {
+        strf::async_fd_sink sink(fd);
+        {
+            strf::async_fd_writer writer(sink);
+            strf::to(writer)("discarded");
+        }
+        strf::to(sink)("kept");
+    }
+    ::close(fd);
+
+    auto obtained_content = test_utils::read_file<char>(path.c_str());
+    std::remove(path.c_str());
+    TEST_TRUE(obtained_content == "kept");
+}
+
+void test_multiple_threads()
+{
+    constexpr int threads_count = 4;
+    constexpr int lines_per_thread = 2000;
+
+    auto path = test_utils::unique_tmp_file_name();
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    TEST_TRUE(fd >= 0);
+    {
+        strf::async_fd_sink sink(fd, 256, 8);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < threads_count; ++t) {
+            threads.emplace_back([&sink, t](){
+                for (int i = 0; i < lines_per_thread; ++i) {
+                    strf::to(sink)('[', t, ':', strf::right(i, 5, '0'), "]\n");
+                }
+            });
+        }
+        for (auto& th : threads) {
+            th.join();
+        }
+    }
+    ::close(fd);
+
+    auto obtained_content = test_utils::read_file<char>(path.c_str());
+    std::remove(path.c_str());
+
+    // Each line fits in a buffer, hence it is never split
+    const std::size_t line_size = 10;
+    TEST_EQ(obtained_content.size(), line_size * threads_count * lines_per_thread);
+    int next_line[threads_count] = {0};
+    for (std::size_t i = 0; i + line_size <= obtained_content.size(); i += line_size) {
+        auto line = obtained_content.substr(i, line_size);
+        int t = line[1] - '0';
+        TEST_TRUE(t >= 0 && t < threads_count);
+        if (t < 0 || t >= threads_count) {
+            break;
+        }
+        auto expected = strf::to_string('[', t, ':', strf::right(next_line[t], 5, '0'), "]\n");
+        TEST_TRUE(line == expected);
+        ++ next_line[t];
+    }
+}
+
+void test_flush()
+{
+    constexpr int threads_count = 4;
+    constexpr int lines_per_thread = 300;
+    const std::size_t line_size = 10;
+
+    auto path = test_utils::unique_tmp_file_name();
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    TEST_TRUE(fd >= 0);
+    {
+        strf::async_fd_sink sink(fd, 256, 8);
+
+        // after the consumer has gone to sleep
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        strf::to(sink)("[x:00000]\n");
+        sink.flush();
+        TEST_EQ(sink.bytes_written(), line_size);
+
+        // each thread flushes what it has just printed
+        std::vector<std::thread> threads;
+        std::vector<int> failures(threads_count, 0);
+        for (int t = 0; t < threads_count; ++t) {
+            threads.emplace_back([&sink, &failures, t](){
+                for (int i = 0; i < lines_per_thread; ++i) {
+                    strf::to(sink)('[', t, ':', strf::right(i, 5, '0'), "]\n");
+                    sink.flush();
+                    if (sink.bytes_written() < line_size * (i + 2)) {
+                        ++ failures[t];
+                    }
+                }
+            });
+        }
+        for (auto& th : threads) {
+            th.join();
+        }
+        for (int t = 0; t < threads_count; ++t) {
+            TEST_EQ(failures[t], 0);
+        }
+        TEST_EQ(sink.bytes_written(), line_size * (1 + threads_count * lines_per_thread));
+    }
+    ::close(fd);
+    std::remove(path.c_str());
+}
+
+void test_invalid_fd()
+{
+    strf::async_fd_sink sink(-1);
+    strf::to(sink)("Hello");
+    sink.flush();
+    TEST_TRUE(! sink.good());
+    TEST_EQ(sink.bytes_written(), 0);
+}
+
+int main()
+{
+    std::srand(static_cast<unsigned>(std::time(nullptr)));
+
+    test_successfull_writing();
+    test_unfinished_writer();
+    test_multiple_threads();
+    test_flush();
+    test_invalid_fd();
+
+    return test_finish();
+}
@@ -37,6 +37,97 @@ void test_narrow_successfull_writing()
                                            , double_str.size() ));
 }
 
+template <typename Writer, typename CharT = typename Writer::char_type>
+void test_direct_writing()
+{
+    // Strings that do not fit in the buffer are passed directly to fwrite
+    auto tiny_str = test_utils::make_tiny_string<CharT>();
+    auto big_str = test_utils::make_string<CharT>(1000);
+
+    std::FILE* file = std::tmpfile();
+    {
+        Writer writer(file);
+        write(writer, tiny_str.begin(), tiny_str.size());
+        write(writer, big_str.data(), big_str.size());
+        write(writer, tiny_str.begin(), tiny_str.size());
+        strf::to(writer)(big_str);
+        auto status = writer.finish();
+
+        TEST_TRUE(status.success);
+        TEST_EQ(status.count, 2 * (tiny_str.size() + big_str.size()));
+    }
+    std::fflush(file);
+    std::rewind(file);
+    auto obtained_content = test_utils::read_file<CharT>(file);
+    std::fclose(file);
+
+    std::basic_string<CharT> expected(tiny_str.begin(), tiny_str.size());
+    expected += big_str;
+    expected.append(tiny_str.begin(), tiny_str.size());
+    expected += big_str;
+    TEST_TRUE(obtained_content == expected);
+}
+
+template <typename CharT>
+void test_locked_successfull_writing()
+{
+    auto tiny_str = test_utils::make_tiny_string<CharT>();
+    auto double_str = test_utils::make_double_string<CharT>();
+
+    std::FILE* file = std::tmpfile();
+    {
+        strf::locked_cfile_writer<CharT, 80> writer(file);
+
+        write(writer, tiny_str.begin(), tiny_str.size());
+        write(writer, double_str.begin(), double_str.size());
+        auto status = writer.finish();
+
+        TEST_TRUE(status.success);
+        TEST_EQ(status.count, tiny_str.size() + double_str.size());
+    }
+    std::fflush(file);
+    std::rewind(file);
+    auto obtained_content = test_utils::read_file<CharT>(file);
+    std::fclose(file);
+
+    TEST_EQ(obtained_content.size(), tiny_str.size() + double_str.size());
+    TEST_TRUE(0 == obtained_content.compare( 0, tiny_str.size()
+                                           , tiny_str.begin()
+                                           , tiny_str.size() ));
+    TEST_TRUE(0 == obtained_content.compare( tiny_str.size()
+                                           , double_str.size()
+                                           , double_str.begin()
+                                           , double_str.size() ));
+}
+
+template <typename CharT>
+void test_locked_failing_to_recycle()
+{
+    auto half_str = test_utils::make_half_string<CharT>();
+    auto double_str = test_utils::make_double_string<CharT>();
+
+    auto path = test_utils::unique_tmp_file_name();
+    std::FILE* file = std::fopen(path.c_str(), "w");
+    strf::locked_cfile_writer<CharT> writer(file);
+
+    write(writer, half_str.begin(), half_str.size());
+    writer.recycle(); // first recycle shall work
+    test_utils::turn_into_bad(writer);
+    write(writer, double_str.begin(), double_str.size());
+
+    auto status = writer.finish();
+    std::fclose(file);
+    auto obtained_content = test_utils::read_file<CharT>(path.c_str());
+    std::remove(path.c_str());
+
+    TEST_TRUE(! status.success);
+    TEST_EQ(status.count, obtained_content.size());
+    TEST_EQ(status.count, half_str.size());
+    TEST_TRUE(0 == obtained_content.compare( 0, half_str.size()
+                                           , half_str.begin()
+                                           , half_str.size() ));
+}
+
 void test_wide_successfull_writing()
 {
     auto tiny_str = test_utils::make_tiny_string<wchar_t>();
@@ -65,6 +156,33 @@ void test_wide_successfull_writing()
                                            , double_str.size() ));
 }
 
+void test_wide_writing_null_chars()
+{
+    const wchar_t str[] = L"abc\0\0de\0f";
+    const std::size_t str_len = sizeof(str) / sizeof(str[0]) - 1;
+    auto double_str = test_utils::make_double_string<wchar_t>();
+
+    std::FILE* file = std::tmpfile();
+    strf::wide_cfile_writer writer(file);
+
+    write(writer, str, str_len);
+    write(writer, double_str.begin(), double_str.size());
+    write(writer, str, str_len);
+    auto status = writer.finish();
+    std::fflush(file);
+    std::rewind(file);
+    auto obtained_content = test_utils::read_wfile(file);
+    std::fclose(file);
+
+    std::wstring expected(str, str_len);
+    expected.append(double_str.begin(), double_str.size());
+    expected.append(str, str_len);
+
+    TEST_TRUE(status.success);
+    TEST_EQ(status.count, expected.size());
+    TEST_TRUE(obtained_content == expected);
+}
+
 template <typename CharT>
 void test_narrow_failing_to_recycle()
 {
@@ -204,6 +322,39 @@ void test_destination()
 
 }
 
+template <typename CharT>
+void test_locked_destination()
+{
+    auto half_str = test_utils::make_half_string<CharT>();
+    auto double_str = test_utils::make_double_string<CharT>();
+
+    auto path = test_utils::unique_tmp_file_name();
+    std::FILE* file = std::fopen(path.c_str(), "w");
+
+    auto status = strf::to_locked<CharT, 64>(file)(half_str, double_str);
+    auto status2 = strf::to_locked<CharT>(file)(half_str);
+    std::fclose(file);
+    auto obtained_content = test_utils::read_file<CharT>(path.c_str());
+    std::remove(path.c_str());
+
+    TEST_TRUE(status.success);
+    TEST_TRUE(status2.success);
+    TEST_EQ(status.count, half_str.size() + double_str.size());
+    TEST_EQ(status2.count, half_str.size());
+    TEST_EQ(obtained_content.size(), status.count + status2.count);
+    TEST_TRUE(0 == obtained_content.compare( 0, half_str.size()
+                                           , half_str.begin()
+                                           , half_str.size() ));
+    TEST_TRUE(0 == obtained_content.compare( half_str.size()
+                                           , double_str.size()
+                                           , double_str.begin()
+                                           , double_str.size() ));
+    TEST_TRUE(0 == obtained_content.compare( status.count
+                                           , half_str.size()
+                                           , half_str.begin()
+                                           , half_str.size() ));
+}
+
 void test_wdestination()
 {
     auto half_str = test_utils::make_half_string<wchar_t>();
@@ -241,11 +392,32 @@ int main()
 
     test_wdestination();
 
+    test_locked_destination<char>();
+    test_locked_destination<char16_t>();
+    test_locked_destination<char32_t>();
+    test_locked_destination<wchar_t>();
+
+    test_locked_successfull_writing<char>();
+    test_locked_successfull_writing<char16_t>();
+    test_locked_successfull_writing<char32_t>();
+    test_locked_successfull_writing<wchar_t>();
+
+    test_locked_failing_to_recycle<char>();
+    test_locked_failing_to_recycle<char16_t>();
+    test_locked_failing_to_recycle<char32_t>();
+    test_locked_failing_to_recycle<wchar_t>();
+
     test_narrow_successfull_writing<char>();
     test_narrow_successfull_writing<char16_t>();
     test_narrow_successfull_writing<char32_t>();
     test_narrow_successfull_writing<wchar_t>();
 
+    test_direct_writing<strf::narrow_cfile_writer<char>>();
+    test_direct_writing<strf::narrow_cfile_writer<char16_t>>();
+    test_direct_writing<strf::narrow_cfile_writer<char32_t>>();
+    test_direct_writing<strf::locked_cfile_writer<char, 256>>();
+    test_direct_writing<strf::locked_cfile_writer<char32_t, 256>>();
+
     test_narrow_failing_to_recycle<char>();
     test_narrow_failing_to_recycle<char16_t>();
     test_narrow_failing_to_recycle<char32_t>();
@@ -257,6 +429,7 @@ int main()
     test_narrow_failing_to_finish<wchar_t>();
 
     test_wide_successfull_writing();
+    test_wide_writing_null_chars();
     test_wide_failing_to_recycle();
     test_wide_failing_to_finish();
 
@@ -0,0 +1,173 @@
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include "test_utils.hpp"
+#include <strf/detail/output_types/chunk_generator.hpp>
+#include <stdexcept>
+#include <vector>
+
+template <typename CharT>
+bool operator==(strf::transient_string_view<CharT> str, const CharT* expected)
+{
+    return std::basic_string<CharT>(str.begin(), str.end()) == expected;
+}
+
+template <typename CharT>
+void test_chunks()
+{
+    auto tiny_str = test_utils::make_tiny_string<CharT>();
+    auto double_str = test_utils::make_double_string<CharT>();
+
+    std::basic_string<CharT> expected(tiny_str.begin(), tiny_str.end());
+    expected.append(double_str.begin(), double_str.end());
+    expected.append(tiny_str.begin(), tiny_str.end());
+
+    const std::size_t chunk_size = 100;
+    std::basic_string<CharT> obtained;
+    std::size_t chunks_count = 0;
+    for (auto chunk : strf::to_chunks<CharT>(chunk_size)(tiny_str, double_str, tiny_str)) {
+        ++chunks_count;
+        TEST_TRUE(chunk.size() != 0);
+        TEST_TRUE(chunk.size() <= chunk_size);
+        TEST_TRUE(chunk.size() == chunk_size || obtained.size() + chunk.size() == expected.size());
+        obtained.append(chunk.begin(), chunk.end());
+    }
+    TEST_TRUE(obtained == expected);
+    TEST_EQ(chunks_count, (expected.size() + chunk_size - 1) / chunk_size);
+}
+
+void test_suspension()
+{
+    // The print is suspended as soon as a chunk is available
+    auto gen = strf::to_chunks(4)(1000, strf::right(2000, 4), strf::right(3000, 4));
+    TEST_TRUE(gen.next());
+    TEST_TRUE(gen.chunk() == "1000");
+    TEST_TRUE(gen.next());
+    TEST_TRUE(gen.chunk() == "2000");
+    TEST_TRUE(gen.next());
+    TEST_TRUE(gen.chunk() == "3000");
+    TEST_TRUE(! gen.next());
+    TEST_TRUE(! gen.next());
+}
+
+void test_small_arguments_are_merged()
+{
+    auto gen = strf::to_chunks(10)('a', 'b', 'c', "de", 1234, "fghij", 'k');
+    std::vector<std::string> chunks;
+    while (gen.next()) {
+        chunks.emplace_back(gen.chunk().begin(), gen.chunk().end());
+    }
+    TEST_EQ(chunks.size(), 2);
+    TEST_TRUE(chunks[0] == "abcde1234f");
+    TEST_TRUE(chunks[1] == "ghijk");
+}
+
+void test_facets()
+{
+    std::string obtained;
+    auto dest = strf::to_chunks(3).with(strf::monotonic_grouping<10>{3});
+    for (auto chunk : dest(1000000)) {
+        obtained.append(chunk.begin(), chunk.end());
+    }
+    TEST_TRUE(obtained == "1,000,000");
+}
+
+void test_arguments_are_copied()
+{
+    // The temporaries die before the generator is resumed
+    auto gen = strf::to_chunks(64)(std::string(100, 'x'), std::string("abc"));
+    std::string obtained;
+    for (auto chunk : gen) {
+        obtained.append(chunk.begin(), chunk.end());
+    }
+    TEST_TRUE(obtained == std::string(100, 'x') + "abc");
+}
+
+// Arguments that refer to content they do not own are rejected
+template <typename T>
+constexpr bool is_view = strf::detail::chunk_arg_is_view<std::decay_t<T>>::value;
+
+static_assert( ! is_view<int>);
+static_assert( ! is_view<std::string>);
+static_assert( ! is_view<const char*>);
+static_assert( ! is_view<decltype(strf::right(10, 5))>);
+static_assert( ! is_view<decltype(strf::multi('x', 5))>);
+static_assert(is_view<decltype(strf::right(std::string("x"), 10))>);
+static_assert(is_view<decltype(strf::cv(std::string("x")))>);
+static_assert(is_view<decltype(strf::sani(std::string("x")))>);
+static_assert(is_view<decltype(strf::range(std::vector<int>{1, 2}))>);
+static_assert(is_view<decltype(strf::fmt_range(std::vector<int>{1, 2}))>);
+static_assert(is_view<decltype(strf::join(1, 2))>);
+static_assert(is_view<decltype(strf::join_right(10)(1, 2))>);
+
+void test_zero_chunk_size()
+{
+    std::string obtained;
+    auto dest = strf::to_chunks(0).with(strf::monotonic_grouping<10>{3});
+    for (auto chunk : dest(1000)) {
+        TEST_EQ(chunk.size(), 1);
+        obtained.append(chunk.begin(), chunk.end());
+    }
+    TEST_TRUE(obtained == "1,000");
+}
+
+void test_empty_content()
+{
+    auto gen = strf::to_chunks(16)("");
+    TEST_TRUE(! gen.next());
+    auto gen2 = strf::to_chunks(16)();
+    TEST_TRUE(gen2.begin() == gen2.end());
+}
+
+struct throwing_arg
+{
+};
+
+struct throwing_printer: strf::printer<char>
+{
+    void print_to(strf::basic_outbuf<char>&) const override
+    {
+        throw std::runtime_error("throwing_printer");
+    }
+};
+
+template <typename CharT, typename FPack, typename Preview>
+throwing_printer make_printer(strf::rank<1>, const FPack&, Preview&, throwing_arg)
+{
+    return {};
+}
+
+void test_exception()
+{
+    auto gen = strf::to_chunks(2)("abcd", throwing_arg{}, "efgh");
+    TEST_TRUE(gen.next());
+    TEST_TRUE(gen.chunk() == "ab");
+    TEST_TRUE(gen.next());
+    TEST_TRUE(gen.chunk() == "cd");
+    bool thrown = false;
+    try {
+        gen.next();
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    TEST_TRUE(thrown);
+    TEST_TRUE(! gen.next());
+}
+
+int main()
+{
+    test_chunks<char>();
+    test_chunks<char16_t>();
+    test_chunks<char32_t>();
+    test_chunks<wchar_t>();
+    test_suspension();
+    test_small_arguments_are_merged();
+    test_facets();
+    test_arguments_are_copied();
+    test_zero_chunk_size();
+    test_empty_content();
+    test_exception();
+
+    return test_finish();
+}
@@ -0,0 +1,162 @@
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include "test_utils.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+template <typename CharT>
+void test_vector_append()
+{
+    auto tiny_str = test_utils::make_tiny_string<CharT>();
+    auto double_str = test_utils::make_double_string<CharT>();
+
+    std::vector<CharT> vec(tiny_str.begin(), tiny_str.end());
+    strf::append(vec)(double_str, double_str);
+
+    std::basic_string<CharT> expected(tiny_str.begin(), tiny_str.size());
+    expected.append(double_str.begin(), double_str.size());
+    expected.append(double_str.begin(), double_str.size());
+    TEST_TRUE(std::basic_string<CharT>(vec.data(), vec.size()) == expected);
+
+    strf::assign(vec)(tiny_str);
+    TEST_TRUE(std::basic_string<CharT>(vec.data(), vec.size())
+           == std::basic_string<CharT>(tiny_str.begin(), tiny_str.size()));
+
+    strf::append(vec).reserve_calc()(double_str);
+    strf::append(vec).reserve(10)(double_str);
+    TEST_TRUE(std::basic_string<CharT>(vec.data(), vec.size()) == expected);
+}
+
+void test_byte_vector()
+{
+    std::vector<unsigned char> vec = {'a', 'b'};
+    strf::append(vec)("cd", 123, strf::multi('x', 200));
+    std::string expected = "abcd123" + std::string(200, 'x');
+    TEST_EQ(vec.size(), expected.size());
+    TEST_TRUE(0 == expected.compare(0, expected.size()
+                                   , reinterpret_cast<const char*>(vec.data())
+                                   , vec.size()));
+}
+
+void test_to_container()
+{
+    auto vec = strf::to_container<std::vector<char>>("Hello", ' ', 123);
+    TEST_TRUE(std::string(vec.data(), vec.size()) == "Hello 123");
+
+    auto vec2 = strf::to_container<std::vector<char16_t>>.reserve(5)
+        (u"abc", strf::multi(u'x', 1000));
+    TEST_TRUE(std::u16string(vec2.data(), vec2.size())
+           == u"abc" + std::u16string(1000, u'x'));
+
+    auto str = strf::to_container<std::string>(strf::right(1, 500, '.'));
+    TEST_TRUE(str == std::string(499, '.') + '1');
+
+    std::vector<char> vec3;
+    strf::append_to_container(vec3)("Hello");
+    TEST_TRUE(std::string(vec3.data(), vec3.size()) == "Hello");
+}
+
+void test_unfinished_appender()
+{
+    std::vector<char> vec = {'a'};
+    {
+        strf::container_appender<std::vector<char>> ob(vec);
+        strf::to(ob)(strf::multi('b', 100));
+    }
+    TEST_TRUE(std::string(vec.data(), vec.size()) == "a" + std::string(100, 'b'));
+}
+
+char* grow_with_realloc(char* ptr, std::size_t, std::size_t new_capacity)
+{
+    return static_cast<char*>(std::realloc(ptr, new_capacity));
+}
+
+void test_growable_buffer()
+{
+    char* ptr = nullptr;
+    std::size_t len = 0;
+    std::size_t cap = 0;
+
+    auto r1 = strf::to_growable_buffer(ptr, len, cap, grow_with_realloc)("Hello");
+    TEST_TRUE(r1.success);
+    TEST_EQ(r1.count, 5);
+    TEST_EQ(len, 5);
+    TEST_TRUE(cap >= len);
+    TEST_TRUE(std::string(ptr, len) == "Hello");
+
+    auto r2 = strf::to_growable_buffer(ptr, len, cap, grow_with_realloc)
+        (' ', strf::multi('x', 5000));
+    TEST_TRUE(r2.success);
+    TEST_EQ(r2.count, 5001);
+    TEST_EQ(len, 5006);
+    TEST_TRUE(cap >= len);
+    TEST_TRUE(std::string(ptr, len) == "Hello " + std::string(5000, 'x'));
+
+    std::free(ptr);
+}
+
+void test_growable_buffer_capacity()
+{
+    // The growth is proportional to the appended content only,
+    // not to the content that the buffer already had.
+    std::size_t len = 100000;
+    std::size_t cap = len;
+    char* ptr = static_cast<char*>(std::malloc(cap));
+    std::memset(ptr, 'a', len);
+
+    bool proportional = true;
+    auto grow = [&](char* p, std::size_t used, std::size_t new_cap) {
+        std::size_t appended = used - 100000;
+        proportional = proportional && new_cap - used <= appended + 1000;
+        return grow_with_realloc(p, used, new_cap);
+    };
+    auto r = strf::to_growable_buffer(ptr, len, cap, grow)
+        (strf::multi('x', 5000), strf::multi('y', 5000));
+    TEST_TRUE(r.success);
+    TEST_TRUE(proportional);
+    TEST_EQ(len, 110000);
+    TEST_TRUE(cap >= len);
+    TEST_TRUE(ptr[99999] == 'a' && ptr[100000] == 'x' && ptr[109999] == 'y');
+
+    std::free(ptr);
+}
+
+void test_growable_buffer_failure()
+{
+    char buff[100] = "abc";
+    char* ptr = buff;
+    std::size_t len = 3;
+    std::size_t cap = sizeof(buff);
+    auto no_grow = [](char*, std::size_t, std::size_t) -> char* { return nullptr; };
+
+    auto r1 = strf::to_growable_buffer(ptr, len, cap, no_grow)("def");
+    TEST_TRUE(r1.success);
+    TEST_EQ(len, 6);
+
+    auto r2 = strf::to_growable_buffer(ptr, len, cap, no_grow)(strf::multi('x', 500));
+    TEST_TRUE(! r2.success);
+    TEST_TRUE(ptr == buff);
+    TEST_EQ(cap, sizeof(buff));
+    TEST_TRUE(len <= cap);
+    TEST_EQ(r2.count, len - 6);
+    TEST_TRUE(std::string(buff, 6) == "abcdef");
+}
+
+int main()
+{
+    test_vector_append<char>();
+    test_vector_append<char16_t>();
+    test_vector_append<char32_t>();
+    test_vector_append<wchar_t>();
+    test_byte_vector();
+    test_to_container();
+    test_unfinished_appender();
+    test_growable_buffer();
+    test_growable_buffer_capacity();
+    test_growable_buffer_failure();
+
+    return test_finish();
+}
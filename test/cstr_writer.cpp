@@ -19,6 +19,20 @@ void test_cstr_writer_destination_too_small()
     TEST_CSTR_EQ(buff, "Hello W");
 }
 
+void test_reserve_contiguous()
+{
+    char buff[200];
+    strf::basic_cstr_writer<char> sw(buff);
+    TEST_TRUE(sw.reserve_contiguous(100));
+    write(sw, "Hello");
+    TEST_TRUE(! sw.reserve_contiguous(500)); // cannot grow
+    TEST_TRUE(sw.good());
+    strf::to(sw)(strf::multi('x', 300));
+    auto r = sw.finish();
+    TEST_TRUE(r.truncated);
+    TEST_EQ(r.ptr, &buff[199]);
+}
+
 void test_write_into_cstr_writer_after_finish()
 {
     const char s1a[] = "Hello";
@@ -119,6 +133,7 @@ int main()
 {
     test_cstr_writer_destination_too_small();
     test_write_into_cstr_writer_after_finish();
+    test_reserve_contiguous();
 
     test_destinations<char>();
     test_destinations<char16_t>();
@@ -0,0 +1,209 @@
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <ctime>
+#include <cstdlib>
+#include <fcntl.h>
+#include "test_utils.hpp"
+
+template <typename CharT>
+void test_successfull_writing()
+{
+    auto tiny_str = test_utils::make_tiny_string<CharT>();
+    auto double_str = test_utils::make_double_string<CharT>();
+
+    auto path = test_utils::unique_tmp_file_name();
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    TEST_TRUE(fd >= 0);
+
+    strf::basic_fd_writer<CharT, 100> writer(fd);
+    write(writer, tiny_str.begin(), tiny_str.size());
+    write(writer, double_str.begin(), double_str.size());
+    auto status = writer.finish();
+    ::close(fd);
+
+    auto obtained_content = test_utils::read_file<CharT>(path.c_str());
+    std::remove(path.c_str());
+
+    TEST_TRUE(status.success);
+    TEST_EQ(status.count, obtained_content.size());
+    TEST_EQ(status.count, tiny_str.size() + double_str.size());
+    TEST_TRUE(0 == obtained_content.compare( 0, tiny_str.size()
+                                           , tiny_str.begin()
+                                           , tiny_str.size() ));
+    TEST_TRUE(0 == obtained_content.compare( tiny_str.size()
+                                           , double_str.size()
+                                           , double_str.begin()
+                                           , double_str.size() ));
+}
+
+template <typename CharT>
+void test_direct_writing()
+{
+    // Strings that do not fit in the buffer are sent with writev
+    // along with what is pending in the buffer
+    auto tiny_str = test_utils::make_tiny_string<CharT>();
+    auto big_str = test_utils::make_string<CharT>(1000);
+
+    auto path = test_utils::unique_tmp_file_name();
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    TEST_TRUE(fd >= 0);
+
+    auto status = strf::to_fd<CharT, 256>(fd)
+        ( strf::detail::simple_string_view<CharT>{tiny_str.begin(), tiny_str.size()}
+        , big_str
+        , strf::detail::simple_string_view<CharT>{tiny_str.begin(), tiny_str.size()}
+        , big_str );
+    ::close(fd);
+
+    auto obtained_content = test_utils::read_file<CharT>(path.c_str());
+    std::remove(path.c_str());
+
+    std::basic_string<CharT> expected(tiny_str.begin(), tiny_str.size());
+    expected += big_str;
+    expected.append(tiny_str.begin(), tiny_str.size());
+    expected += big_str;
+
+    TEST_TRUE(status.success);
+    TEST_EQ(status.count, expected.size());
+    TEST_TRUE(obtained_content == expected);
+}
+
+template <typename CharT>
+void test_failing_to_recycle()
+{
+    auto half_str = test_utils::make_half_string<CharT>();
+    auto double_str = test_utils::make_double_string<CharT>();
+
+    auto path = test_utils::unique_tmp_file_name();
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    TEST_TRUE(fd >= 0);
+
+    strf::basic_fd_writer<CharT, 64> writer(fd);
+    write(writer, half_str.begin(), half_str.size());
+    writer.recycle(); // first recycle shall work
+    test_utils::turn_into_bad(writer);
+    write(writer, double_str.begin(), double_str.size());
+
+    auto status = writer.finish();
+    ::close(fd);
+    auto obtained_content = test_utils::read_file<CharT>(path.c_str());
+    std::remove(path.c_str());
+
+    TEST_TRUE(! status.success);
+    TEST_EQ(status.count, obtained_content.size());
+    TEST_EQ(status.count, half_str.size());
+}
+
+void test_invalid_fd()
+{
+    auto status = strf::to_fd(-1)("Hello");
+    TEST_TRUE(! status.success);
+    TEST_EQ(status.count, 0);
+}
+
+template <typename CharT>
+void test_atomic_writing()
+{
+    auto tiny_str = test_utils::make_tiny_string<CharT>();
+    auto big_str = test_utils::make_string<CharT>(5000);
+
+    auto path = test_utils::unique_tmp_file_name();
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    TEST_TRUE(fd >= 0);
+
+    auto tiny_view = strf::detail::simple_string_view<CharT>
+        {tiny_str.begin(), tiny_str.size()};
+    auto status1 = strf::to_fd_atomic<CharT>(fd) (tiny_view, big_str);
+    auto status2 = strf::to_fd_atomic<CharT>(fd) (big_str, tiny_view);
+    auto status3 = strf::to_fd_atomic<CharT>(fd).reserve(10) (tiny_view);
+    ::close(fd);
+
+    auto obtained_content = test_utils::read_file<CharT>(path.c_str());
+    std::remove(path.c_str());
+
+    std::basic_string<CharT> expected(tiny_str.begin(), tiny_str.size());
+    expected += big_str;
+    expected += big_str;
+    expected.append(tiny_str.begin(), tiny_str.size());
+    expected.append(tiny_str.begin(), tiny_str.size());
+
+    TEST_TRUE(status1.success);
+    TEST_TRUE(status2.success);
+    TEST_TRUE(status3.success);
+    TEST_EQ(status1.count, tiny_str.size() + big_str.size());
+    TEST_EQ(status2.count, tiny_str.size() + big_str.size());
+    TEST_EQ(status3.count, tiny_str.size());
+    TEST_TRUE(obtained_content == expected);
+}
+
+void test_atomic_nested_writers()
+{
+    // A writer created while another one of the same thread is alive
+    // does not use the thread-local buffer
+    auto path = test_utils::unique_tmp_file_name();
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    TEST_TRUE(fd >= 0);
+    {
+        strf::basic_fd_atomic_writer<char> outer(fd);
+        strf::to(outer)("outer");
+        {
+            strf::basic_fd_atomic_writer<char> inner(fd);
+            strf::to(inner)(strf::multi('x', 3000));
+            auto status = inner.finish();
+            TEST_TRUE(status.success);
+            TEST_EQ(status.count, 3000);
+        }
+        strf::to(outer)(strf::multi('y', 3000));
+        auto status = outer.finish();
+        TEST_TRUE(status.success);
+        TEST_EQ(status.count, 3005);
+    }
+    auto status = strf::to_fd_atomic(fd)("!");
+    TEST_TRUE(status.success);
+    ::close(fd);
+
+    auto obtained_content = test_utils::read_file<char>(path.c_str());
+    std::remove(path.c_str());
+
+    std::string expected(3000, 'x');
+    expected += "outer";
+    expected.append(3000, 'y');
+    expected += '!';
+    TEST_TRUE(obtained_content == expected);
+}
+
+void test_atomic_invalid_fd()
+{
+    auto status = strf::to_fd_atomic(-1)("Hello");
+    TEST_TRUE(! status.success);
+    TEST_EQ(status.count, 0);
+}
+
+int main()
+{
+    std::srand(static_cast<unsigned>(std::time(nullptr)));
+
+    test_successfull_writing<char>();
+    test_successfull_writing<char16_t>();
+    test_successfull_writing<char32_t>();
+    test_successfull_writing<wchar_t>();
+
+    test_direct_writing<char>();
+    test_direct_writing<char16_t>();
+    test_direct_writing<char32_t>();
+
+    test_failing_to_recycle<char>();
+    test_failing_to_recycle<char32_t>();
+
+    test_invalid_fd();
+
+    test_atomic_writing<char>();
+    test_atomic_writing<char16_t>();
+    test_atomic_writing<char32_t>();
+    test_atomic_nested_writers();
+    test_atomic_invalid_fd();
+
+    return test_finish();
+}
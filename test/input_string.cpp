@@ -115,6 +115,12 @@ int main()
         TEST("....--?--\x80--")
             .with(strf::windows_1252<char>())
             (strf::right("--\xC9\x90--\xE2\x82\xAC--", 12, U'.').cv(strf::utf8<char>()));
+
+        TEST(u"--é--€--")
+            (strf::cv("--\xE9--\x80--", strf::windows_1252<char>()));
+
+        TEST(u"....--é--€--")
+            (strf::right("--\xE9--\x80--", 12, U'.').cv(strf::windows_1252<char>()));
     }
 
     {   // convertion from utf32
@@ -0,0 +1,198 @@
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <ctime>
+#include <cstdlib>
+#include <fcntl.h>
+#include "test_utils.hpp"
+#include <strf/detail/output_types/io_uring.hpp>
+
+template <typename CharT>
+void test_successfull_writing()
+{
+    auto tiny_str = test_utils::make_tiny_string<CharT>();
+    auto double_str = test_utils::make_double_string<CharT>();
+
+    auto path = test_utils::unique_tmp_file_name();
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    TEST_TRUE(fd >= 0);
+    std::size_t bytes_written = 0;
+    {
+        strf::io_uring_sink sink(fd, 100 * sizeof(CharT), 3);
+        auto res = strf::to_io_uring<CharT>(sink)
+            (tiny_str, double_str, double_str, tiny_str);
+        TEST_TRUE(res.success);
+        TEST_EQ(res.count, 2 * (tiny_str.size() + double_str.size()));
+        TEST_TRUE(sink.flush());
+        bytes_written = sink.bytes_written();
+    }
+    ::close(fd);
+
+    auto obtained_content = test_utils::read_file<CharT>(path.c_str());
+    std::remove(path.c_str());
+
+    std::basic_string<CharT> expected(tiny_str.begin(), tiny_str.end());
+    expected.append(double_str.begin(), double_str.end());
+    expected.append(double_str.begin(), double_str.end());
+    expected.append(tiny_str.begin(), tiny_str.end());
+    TEST_EQ(bytes_written, expected.size() * sizeof(CharT));
+    TEST_TRUE(obtained_content == expected);
+}
+
+void test_large_content()
+{
+    // Many buffers in flight, and the file offset is updated
+    auto path = test_utils::unique_tmp_file_name();
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    TEST_TRUE(fd >= 0);
+    TEST_EQ(::write(fd, "begin\n", 6), 6);
+
+    constexpr int lines_count = 200000;
+    std::size_t count = 0;
+    {
+        strf::io_uring_sink sink(fd, 4096, 8);
+        strf::io_uring_writer writer(sink);
+        for (int i = 0; i < lines_count; ++i) {
+            strf::to(writer)(strf::right(i, 8, '0'), '\n');
+        }
+        auto res = writer.finish();
+        TEST_TRUE(res.success);
+        count = res.count;
+        TEST_TRUE(sink.flush());
+        TEST_EQ(sink.bytes_written(), count);
+    }
+    TEST_EQ(count, 9 * lines_count);
+    TEST_EQ(::write(fd, "end\n", 4), 4);
+    ::close(fd);
+
+    auto obtained_content = test_utils::read_file<char>(path.c_str());
+    std::remove(path.c_str());
+
+    std::string expected = "begin\n";
+    for (int i = 0; i < lines_count; ++i) {
+        expected += strf::to_string(strf::right(i, 8, '0'), '\n');
+    }
+    expected += "end\n";
+    TEST_TRUE(obtained_content == expected);
+}
+
+void test_many_calls()
+{
+    // The sink is shared by many printing calls, that do not wait
+    // for their writes to complete
+    auto path = test_utils::unique_tmp_file_name();
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    TEST_TRUE(fd >= 0);
+
+    constexpr int lines_count = 20000;
+    std::string expected;
+    {
+        strf::io_uring_sink sink(fd, 256, 4);
+        for (int i = 0; i < lines_count; ++i) {
+            auto res = strf::to_io_uring(sink)(strf::right(i, 8, '0'), '\n');
+            TEST_TRUE(res.success);
+            TEST_EQ(res.count, 9);
+            expected += strf::to_string(strf::right(i, 8, '0'), '\n');
+        }
+        strf::to_io_uring(sink)("end\n");
+        expected += "end\n";
+    }
+    ::close(fd);
+
+    auto obtained_content = test_utils::read_file<char>(path.c_str());
+    std::remove(path.c_str());
+    TEST_TRUE(obtained_content == expected);
+}
+
+void test_append_mode()
+{
+    auto path = test_utils::unique_tmp_file_name();
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0600);
+    TEST_TRUE(fd >= 0);
+    TEST_EQ(::write(fd, "abc", 3), 3);
+    {
+        strf::io_uring_sink sink(fd, 64, 2);
+        auto res = strf::to_io_uring(sink)(strf::multi('x', 1000), strf::multi('y', 1000));
+        TEST_TRUE(res.success);
+        TEST_EQ(res.count, 2000);
+        TEST_TRUE(sink.flush());
+        TEST_EQ(::write(fd, "def", 3), 3);
+    }
+    ::close(fd);
+
+    auto obtained_content = test_utils::read_file<char>(path.c_str());
+    std::remove(path.c_str());
+    TEST_TRUE(obtained_content == "abc" + std::string(1000, 'x') + std::string(1000, 'y') + "def");
+}
+
+void test_pipe()
+{
+    int fds[2];
+    TEST_EQ(::pipe(fds), 0);
+    {
+        strf::io_uring_sink sink(fds[1], 64, 4);
+        auto res = strf::to_io_uring(sink)("Hello ", strf::multi('x', 1000));
+        TEST_TRUE(res.success);
+        TEST_EQ(res.count, 1006);
+    }
+    ::close(fds[1]);
+
+    std::string obtained;
+    char buff[256];
+    ssize_t r;
+    while ((r = ::read(fds[0], buff, sizeof(buff))) > 0) {
+        obtained.append(buff, r);
+    }
+    ::close(fds[0]);
+    TEST_TRUE(obtained == "Hello " + std::string(1000, 'x'));
+}
+
+void test_invalid_fd()
+{
+    strf::io_uring_sink sink(-1, 64, 2);
+    (void) strf::to_io_uring(sink)(strf::multi('x', 1000));
+    TEST_TRUE(! sink.flush());
+    TEST_TRUE(! sink.good());
+    TEST_EQ(sink.bytes_written(), 0);
+    auto res = strf::to_io_uring(sink)("abc");
+    TEST_TRUE(! res.success);
+}
+
+void test_unfinished_writer()
+{
+    // The buffers that got full before the writer is destroyed are written
+    auto path = test_utils::unique_tmp_file_name();
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    TEST_TRUE(fd >= 0);
+    {
+        strf::io_uring_sink sink(fd, 256, 2);
+        {
+            strf::io_uring_writer writer(sink);
+            strf::to(writer)(strf::multi('x', 600));
+        }
+        strf::to_io_uring(sink)("abc");
+    }
+    ::close(fd);
+    auto obtained_content = test_utils::read_file<char>(path.c_str());
+    std::remove(path.c_str());
+    TEST_TRUE(obtained_content == std::string(512, 'x') + "abc");
+}
+
+int main()
+{
+    std::srand(static_cast<unsigned>(std::time(nullptr)));
+
+    test_successfull_writing<char>();
+    test_successfull_writing<char16_t>();
+    test_successfull_writing<char32_t>();
+    test_successfull_writing<wchar_t>();
+    test_large_content();
+    test_many_calls();
+    test_append_mode();
+    test_pipe();
+    test_invalid_fd();
+    test_unfinished_writer();
+
+    return test_finish();
+}
@@ -0,0 +1,127 @@
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <ctime>
+#include <cstdlib>
+#include <fcntl.h>
+#include "test_utils.hpp"
+
+template <typename CharT>
+void test_successfull_writing()
+{
+    auto tiny_str = test_utils::make_tiny_string<CharT>();
+    auto double_str = test_utils::make_double_string<CharT>();
+
+    auto path = test_utils::unique_tmp_file_name();
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+    TEST_TRUE(fd >= 0);
+
+    strf::basic_mapped_file_writer<CharT> writer(fd, 10);
+    write(writer, tiny_str.begin(), tiny_str.size());
+    for (int i = 0; i < 100; ++i) {
+        write(writer, double_str.begin(), double_str.size());
+    }
+    auto status = writer.finish();
+    ::close(fd);
+
+    auto obtained_content = test_utils::read_file<CharT>(path.c_str());
+    std::remove(path.c_str());
+
+    std::basic_string<CharT> expected(tiny_str.begin(), tiny_str.size());
+    for (int i = 0; i < 100; ++i) {
+        expected.append(double_str.begin(), double_str.size());
+    }
+
+    TEST_TRUE(status.success);
+    TEST_EQ(status.count, expected.size());
+    TEST_TRUE(obtained_content == expected);
+}
+
+template <typename CharT>
+void test_failing_to_recycle()
+{
+    auto half_str = test_utils::make_half_string<CharT>();
+    auto double_str = test_utils::make_double_string<CharT>();
+
+    auto path = test_utils::unique_tmp_file_name();
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+    TEST_TRUE(fd >= 0);
+
+    strf::basic_mapped_file_writer<CharT> writer(fd, 100);
+    write(writer, half_str.begin(), half_str.size());
+    writer.recycle(); // first recycle shall work
+    test_utils::turn_into_bad(writer);
+    write(writer, double_str.begin(), double_str.size());
+
+    auto status = writer.finish();
+    ::close(fd);
+    auto obtained_content = test_utils::read_file<CharT>(path.c_str());
+    std::remove(path.c_str());
+
+    TEST_TRUE(! status.success);
+    TEST_EQ(status.count, obtained_content.size());
+    TEST_EQ(status.count, half_str.size());
+}
+
+template <typename CharT>
+void test_destination()
+{
+    auto half_str = test_utils::make_half_string<CharT>();
+    auto full_str = test_utils::make_full_string<CharT>();
+
+    std::basic_string<CharT> expected(half_str.begin(), half_str.size());
+    expected.append(full_str.begin(), full_str.size());
+
+    auto path = test_utils::unique_tmp_file_name();
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+    TEST_TRUE(fd >= 0);
+    {
+        auto status = strf::to_mapped_file<CharT>(fd) (half_str, full_str);
+        TEST_TRUE(status.success);
+        TEST_EQ(status.count, expected.size());
+        TEST_TRUE(test_utils::read_file<CharT>(path.c_str()) == expected);
+    }
+    {
+        auto status = strf::to_mapped_file<CharT>(fd).reserve_calc() (half_str, full_str);
+        TEST_TRUE(status.success);
+        TEST_EQ(status.count, expected.size());
+        TEST_TRUE(test_utils::read_file<CharT>(path.c_str()) == expected);
+    }
+    {
+        auto status = strf::to_mapped_file<CharT>(fd).reserve(3) (half_str, full_str);
+        TEST_TRUE(status.success);
+        TEST_EQ(status.count, expected.size());
+        TEST_TRUE(test_utils::read_file<CharT>(path.c_str()) == expected);
+    }
+    ::close(fd);
+    std::remove(path.c_str());
+}
+
+void test_invalid_fd()
+{
+    auto status = strf::to_mapped_file(-1)("Hello");
+    TEST_TRUE(! status.success);
+    TEST_EQ(status.count, 0);
+}
+
+int main()
+{
+    std::srand(static_cast<unsigned>(std::time(nullptr)));
+
+    test_successfull_writing<char>();
+    test_successfull_writing<char16_t>();
+    test_successfull_writing<char32_t>();
+    test_successfull_writing<wchar_t>();
+
+    test_failing_to_recycle<char>();
+    test_failing_to_recycle<char16_t>();
+
+    test_destination<char>();
+    test_destination<char16_t>();
+    test_destination<char32_t>();
+
+    test_invalid_fd();
+
+    return test_finish();
+}
@@ -40,17 +40,25 @@ public:
 
     void recycle() override
     {
+        _count += this->pos() - _buff;
         this->set_pos(_buff);
     }
 
-    std::size_t finish()
+    struct result
     {
-        return _reserved_size;
+        std::size_t reserved_size;
+        std::size_t count;
+    };
+
+    result finish()
+    {
+        return {_reserved_size, _count + (this->pos() - _buff)};
     }
 
 private:
 
     std::size_t _reserved_size = 0;
+    std::size_t _count = 0;
 };
 
 
@@ -61,7 +69,7 @@ public:
     using char_type = char;
 
     template <typename ... Printers>
-    std::size_t write(const Printers& ... printers) const
+    reservation_tester::result write(const Printers& ... printers) const
     {
         reservation_tester ob;
         strf::detail::write_args(ob, printers...);;
@@ -69,7 +77,7 @@ public:
     }
 
     template <typename ... Printers>
-    std::size_t sized_write(std::size_t size, const Printers& ... printers) const
+    reservation_tester::result sized_write(std::size_t size, const Printers& ... printers) const
     {
         reservation_tester ob{size};
         strf::detail::write_args(ob, printers...);;
@@ -90,6 +98,15 @@ constexpr auto reservation_test()
     return strf::destination_no_reserve<reservation_tester_creator>();
 }
 
+// reserve_predicted is rejected when the value returned by finish()
+// does not inform the size of the content
+static_assert( strf::detail::has_finish_result_size<reservation_tester::result>::value
+             , "reserve_predicted shall accept a result with count" );
+static_assert( strf::detail::has_finish_result_size<std::string>::value
+             , "reserve_predicted shall accept a result with size()" );
+static_assert( ! strf::detail::has_finish_result_size<strf::basic_cstr_writer<char>::result>::value
+             , "reserve_predicted shall reject the result of basic_cstr_writer" );
+
 
 int main()
 {
@@ -97,15 +114,15 @@ int main()
     constexpr std::size_t not_reserved = 0;
 
     {
-        auto size = reservation_test()  ("abcd");
+        auto size = reservation_test()  ("abcd").reserved_size;
         TEST_EQ(size, not_reserved);
     }
     {
-        auto size = reservation_test() .reserve(5555) ("abcd");
+        auto size = reservation_test() .reserve(5555) ("abcd").reserved_size;
         TEST_EQ(size, 5555);
     }
     {
-        auto size = reservation_test() .reserve_calc() ("abcd");
+        auto size = reservation_test() .reserve_calc() ("abcd").reserved_size;
         TEST_EQ(size, 4);
     }
 
@@ -113,17 +130,17 @@ int main()
 
     {
         auto tester = reservation_test();
-        auto size = tester ("abcd");
+        auto size = tester ("abcd").reserved_size;
         TEST_EQ(size, not_reserved);
     }
     {
         auto tester = reservation_test();
-        auto size = tester.reserve(5555) ("abcd");
+        auto size = tester.reserve(5555) ("abcd").reserved_size;
         TEST_EQ(size, 5555);
     }
     {
         auto tester = reservation_test();
-        auto size = tester.reserve_calc() ("abcd");
+        auto size = tester.reserve_calc() ("abcd").reserved_size;
         TEST_EQ(size, 4);
     }
 
@@ -131,17 +148,17 @@ int main()
 
     {
         const auto tester = reservation_test();
-        auto size = tester ("abcd");
+        auto size = tester ("abcd").reserved_size;
         TEST_EQ(size, not_reserved);
     }
     {
         const auto tester = reservation_test();
-        auto size = tester.reserve(5555) ("abcd");
+        auto size = tester.reserve(5555) ("abcd").reserved_size;
         TEST_EQ(size, 5555);
     }
     {
         const auto tester = reservation_test() .reserve(5555);
-        auto size = tester.reserve_calc() ("abcd");
+        auto size = tester.reserve_calc() ("abcd").reserved_size;
         TEST_EQ(size, 4);
     }
 
@@ -149,19 +166,63 @@ int main()
 
     {
         const auto tester = reservation_test();
-        auto size = std::move(tester) ("abcd");
+        auto size = std::move(tester) ("abcd").reserved_size;
         TEST_EQ(size, not_reserved);
     }
     {
         const auto tester = reservation_test();
-        auto size = std::move(tester).reserve(5555) ("abcd");
+        auto size = std::move(tester).reserve(5555) ("abcd").reserved_size;
         TEST_EQ(size, 5555);
     }
     {
         const auto tester = reservation_test() .reserve(5555);
-        auto size = std::move(tester).reserve_calc() ("abcd");
+        auto size = std::move(tester).reserve_calc() ("abcd").reserved_size;
         TEST_EQ(size, 4);
     }
 
+    // reserve_predicted
+
+    {
+        strf::size_predictor predictor;
+        TEST_EQ(predictor.predict(), 0);
+
+        auto size = reservation_test().reserve_predicted(predictor) ("abcd").reserved_size;
+        TEST_EQ(size, 0);
+        TEST_EQ(predictor.predict(), 4);
+
+        // the content size is informed by the result of finish()
+        auto str = strf::to_string.reserve_predicted(predictor) (strf::multi('x', 800));
+        TEST_EQ(str.size(), 800);
+        TEST_EQ(predictor.predict(), 900);
+
+        // smaller sizes lower the prediction slowly
+        size = reservation_test().reserve_predicted(predictor) ("abcd").reserved_size;
+        TEST_EQ(size, 900);
+        TEST_EQ(predictor.predict(), 844);
+        const auto tester = reservation_test().reserve(10).reserve_predicted(predictor);
+        size = tester ("abcd").reserved_size;
+        TEST_EQ(size, 844);
+        TEST_EQ(predictor.predict(), 792);
+        size = tester.reserve_calc() ("abcd").reserved_size;
+        TEST_EQ(size, 4);
+        TEST_EQ(predictor.predict(), 792);
+
+        str = strf::to_string.reserve_predicted(predictor) (strf::multi('x', 100));
+        TEST_EQ(str.size(), 100);
+        TEST_EQ(predictor.predict(), 749);
+    }
+    {
+        strf::size_predictor predictor;
+        for (int i = 0; i < 4; ++i) {
+            auto str = strf::to_u16string.reserve_predicted(predictor)
+                .with(strf::monotonic_grouping<10>{3}) (u"abc", 1000000);
+            TEST_TRUE(str == u"abc1,000,000");
+        }
+        TEST_EQ(predictor.predict(), 13);
+
+        auto str = strf::to_u16string.reserve_predicted(predictor).tr(u"{}{}", 12, u"xyz");
+        TEST_TRUE(str == u"12xyz");
+    }
+
     return test_finish();
 }
@@ -0,0 +1,160 @@
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include "test_utils.hpp"
+#include <utility>
+
+template <typename CharT>
+void test_tls_view()
+{
+    auto tiny_str = test_utils::make_tiny_string<CharT>();
+    auto double_str = test_utils::make_double_string<CharT>();
+
+    {
+        auto v = strf::to_basic_tls_view<CharT>(tiny_str);
+        TEST_TRUE(std::basic_string<CharT>(v.begin(), v.end())
+               == std::basic_string<CharT>(tiny_str.begin(), tiny_str.end()));
+        TEST_TRUE(*(&*v.begin() + v.size()) == CharT());
+    }
+    {
+        auto v = strf::to_basic_tls_view<CharT>(double_str, double_str);
+        std::basic_string<CharT> expected(double_str.begin(), double_str.end());
+        expected.append(double_str.begin(), double_str.end());
+        TEST_TRUE(std::basic_string<CharT>(v.begin(), v.end()) == expected);
+    }
+    {
+        // The buffers are reused
+        auto v1 = strf::to_basic_tls_view<CharT>(double_str);
+        const CharT* p1 = &*v1.begin();
+        auto v2 = strf::to_basic_tls_view<CharT>(tiny_str);
+        TEST_TRUE(&*v2.begin() != p1);
+        auto v3 = strf::to_basic_tls_view<CharT>.reserve_calc()(double_str);
+        TEST_TRUE(&*v3.begin() == p1);
+        TEST_TRUE(std::basic_string<CharT>(v3.begin(), v3.end())
+               == std::basic_string<CharT>(double_str.begin(), double_str.end()));
+    }
+    {
+        // The view returned by the previous call can be an argument
+        auto k = strf::to_basic_tls_view<CharT>(tiny_str, double_str);
+        std::basic_string<CharT> expected(tiny_str.begin(), tiny_str.end());
+        expected.append(double_str.begin(), double_str.end());
+        TEST_TRUE(std::basic_string<CharT>(k.begin(), k.end()) == expected);
+
+        // even when the buffer needs to grow
+        auto full = strf::to_basic_tls_view<CharT>
+            (double_str, double_str, double_str, k, double_str);
+        std::basic_string<CharT> full_expected;
+        for (int i = 0; i < 3; ++i) {
+            full_expected.append(double_str.begin(), double_str.end());
+        }
+        full_expected.append(expected);
+        full_expected.append(double_str.begin(), double_str.end());
+        TEST_TRUE(std::basic_string<CharT>(full.begin(), full.end()) == full_expected);
+        TEST_TRUE(std::basic_string<CharT>(k.begin(), k.end()) == expected);
+    }
+}
+
+void test_tls_view_reserve()
+{
+    auto v = strf::to_tls_view.reserve(100000)("abc", 123);
+    TEST_TRUE(std::string(v.begin(), v.end()) == "abc123");
+
+    auto v2 = strf::to_tls_view(strf::multi('x', 100000));
+    TEST_TRUE(std::string(v2.begin(), v2.end()) == std::string(100000, 'x'));
+    TEST_TRUE(*(&*v2.begin() + v2.size()) == '\0');
+}
+
+template <typename Writer>
+std::size_t count_reallocations(Writer& writer, std::size_t output_size)
+{
+    std::size_t count = 0;
+    auto end = writer.end();
+    for (std::size_t i = 0; i < output_size; ++i) {
+        strf::put(writer, 'x');
+        if (writer.end() != end) {
+            end = writer.end();
+            ++count;
+        }
+    }
+    return count;
+}
+
+void test_reallocations_count()
+{
+    // The growth is geometric
+    constexpr std::size_t output_size = 1000000;
+    {
+        strf::basic_tls_view_writer<char> writer;
+        std::size_t count = count_reallocations(writer, output_size);
+        TEST_TRUE(count <= 20);
+        auto v = writer.finish();
+        TEST_EQ(v.size(), output_size);
+    }
+    {
+        strf::basic_pooled_string_writer<char> writer;
+        std::size_t count = count_reallocations(writer, output_size);
+        TEST_TRUE(count <= 20);
+        auto s = writer.finish();
+        TEST_EQ(s.size(), output_size);
+    }
+}
+
+template <typename CharT>
+void test_pooled_string()
+{
+    auto tiny_str = test_utils::make_tiny_string<CharT>();
+    auto double_str = test_utils::make_double_string<CharT>();
+
+    auto s1 = strf::to_basic_pooled_string<CharT>(tiny_str);
+    TEST_TRUE(std::basic_string<CharT>(s1.begin(), s1.end())
+           == std::basic_string<CharT>(tiny_str.begin(), tiny_str.end()));
+    TEST_TRUE(s1.c_str()[s1.size()] == CharT());
+
+    auto s2 = strf::to_basic_pooled_string<CharT>.reserve(10)(double_str, double_str);
+    std::basic_string<CharT> expected(double_str.begin(), double_str.end());
+    expected.append(double_str.begin(), double_str.end());
+    TEST_TRUE(std::basic_string<CharT>(s2.begin(), s2.end()) == expected);
+    TEST_TRUE(s2.c_str()[s2.size()] == CharT());
+
+    strf::basic_pooled_string<CharT> s3 = std::move(s2);
+    TEST_TRUE(std::basic_string<CharT>(s3.begin(), s3.end()) == expected);
+    TEST_TRUE(s2.empty());
+    TEST_TRUE(s2.c_str()[0] == CharT());
+}
+
+void test_pooled_buffer_reuse()
+{
+    const char* p = nullptr;
+    {
+        auto s = strf::to_pooled_string("Hello");
+        p = s.data();
+        TEST_TRUE(std::string(s.c_str()) == "Hello");
+    }
+    auto s2 = strf::to_pooled_string("World");
+    TEST_TRUE(s2.data() == p);
+    TEST_TRUE(std::string(s2.c_str()) == "World");
+
+    auto s3 = strf::to_pooled_string(1, 2, 3);
+    TEST_TRUE(s3.data() != p);
+    s2 = std::move(s3);
+    TEST_TRUE(std::string(s2.c_str()) == "123");
+    auto s4 = strf::to_pooled_string('x');
+    TEST_TRUE(s4.data() == p);
+}
+
+int main()
+{
+    test_tls_view<char>();
+    test_tls_view<char16_t>();
+    test_tls_view<char32_t>();
+    test_tls_view<wchar_t>();
+    test_tls_view_reserve();
+    test_reallocations_count();
+    test_pooled_string<char>();
+    test_pooled_string<char16_t>();
+    test_pooled_string<wchar_t>();
+    test_pooled_buffer_reuse();
+
+    return test_finish();
+}
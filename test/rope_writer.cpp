@@ -0,0 +1,101 @@
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include "test_utils.hpp"
+
+template <typename CharT>
+void test_successfull_writing()
+{
+    auto tiny_str = test_utils::make_tiny_string<CharT>();
+    auto double_str = test_utils::make_double_string<CharT>();
+
+    strf::basic_rope_writer<CharT, 100> writer;
+    write(writer, tiny_str.begin(), tiny_str.size());
+    write(writer, double_str.begin(), double_str.size());
+    auto rope = writer.finish();
+
+    std::basic_string<CharT> expected(tiny_str.begin(), tiny_str.size());
+    expected.append(double_str.begin(), double_str.size());
+
+    TEST_EQ(rope.size(), expected.size());
+    TEST_TRUE(rope.to_string() == expected);
+
+    std::size_t segments_count = 0;
+    std::size_t total = 0;
+    for (auto seg : rope) {
+        TEST_TRUE(seg.size != 0);
+        TEST_TRUE(seg.size <= 100);
+        total += seg.size;
+        ++segments_count;
+    }
+    TEST_EQ(total, expected.size());
+    TEST_EQ(segments_count, rope.segments_count());
+
+    std::basic_string<CharT> copy(rope.size(), CharT('?'));
+    auto end = rope.copy_to(&copy[0]);
+    TEST_TRUE(end == &copy[0] + copy.size());
+    TEST_TRUE(copy == expected);
+}
+
+void test_destination()
+{
+    auto big_str = test_utils::make_string<char>(10000);
+    auto rope = strf::to_rope("abc", big_str, 123);
+    TEST_EQ(rope.size(), 10006);
+    TEST_TRUE(rope.to_string() == "abc" + big_str + "123");
+    TEST_EQ(rope.segments_count(), 3);
+
+    auto rope16 = strf::to_basic_rope<char16_t, 64>(u"abc", strf::multi(u'x', 200));
+    TEST_TRUE(rope16.to_string() == u"abc" + std::u16string(200, u'x'));
+    TEST_EQ(rope16.segments_count(), 4);
+}
+
+void test_empty()
+{
+    auto rope = strf::to_rope("");
+    TEST_TRUE(rope.empty());
+    TEST_EQ(rope.segments_count(), 0);
+    TEST_TRUE(rope.begin() == rope.end());
+
+    // The last chunk is dropped when empty
+    auto rope2 = strf::to_basic_rope<char, 64>(strf::multi('x', 128));
+    TEST_EQ(rope2.segments_count(), 2);
+    TEST_TRUE(rope2.to_string() == std::string(128, 'x'));
+}
+
+void test_unfinished_and_moved()
+{
+    {
+        strf::basic_rope_writer<char, 64> writer;
+        strf::to(writer)(strf::multi('x', 1000));
+    }
+    strf::rope r1 = strf::to_rope("hello");
+    strf::rope r2 = std::move(r1);
+    TEST_TRUE(r1.empty());
+    TEST_TRUE(r1.begin() == r1.end());
+    TEST_TRUE(r2.to_string() == "hello");
+    r1 = std::move(r2);
+    TEST_TRUE(r1.to_string() == "hello");
+}
+
+void test_static_rope()
+{
+    // Destroyed at exit, after the thread_local chunk pool
+    static strf::rope rope = strf::to_rope(strf::multi('x', 1000));
+    TEST_EQ(rope.size(), 1000);
+}
+
+int main()
+{
+    test_successfull_writing<char>();
+    test_successfull_writing<char16_t>();
+    test_successfull_writing<char32_t>();
+    test_successfull_writing<wchar_t>();
+    test_destination();
+    test_empty();
+    test_unfinished_and_moved();
+    test_static_rope();
+
+    return test_finish();
+}
@@ -0,0 +1,339 @@
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <chrono>
+#include <ctime>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/wait.h>
+#include "test_utils.hpp"
+#include <strf/detail/output_types/shm_ring.hpp>
+
+std::string unique_shm_name()
+{
+    return strf::to_string("/strf_test_shm_", ::getpid(), '_', std::rand());
+}
+
+std::vector<std::string> consume_all(strf::shm_ring& ring)
+{
+    std::vector<std::string> records;
+    ring.consume([&](const char* data, std::size_t size) {
+        records.emplace_back(data, size);
+    });
+    return records;
+}
+
+void test_single_process()
+{
+    auto name = unique_shm_name();
+    auto ring = strf::shm_ring::create(name.c_str(), 1000);
+    TEST_TRUE(ring.valid());
+    TEST_EQ(ring.capacity(), 1024);
+
+    auto res = strf::to_shm_ring(ring)("Hello ", 123, '!');
+    TEST_TRUE(res.success);
+    TEST_EQ(res.count, 10);
+    TEST_TRUE(strf::to_shm_ring(ring)("").success);
+    TEST_TRUE(strf::to_shm_ring(ring)(strf::right("abc", 20, '.')).success);
+
+    auto records = consume_all(ring);
+    TEST_EQ(records.size(), 3);
+    TEST_TRUE(records[0] == "Hello 123!");
+    TEST_TRUE(records[1].empty());
+    TEST_TRUE(records[2] == ".................abc");
+    TEST_TRUE(consume_all(ring).empty());
+
+    // Another mapping of the same segment
+    auto ring2 = strf::shm_ring::open(name.c_str());
+    TEST_TRUE(ring2.valid());
+    TEST_EQ(ring2.capacity(), 1024);
+    TEST_TRUE(strf::to_shm_ring(ring2)("from ring2").success);
+    records = consume_all(ring);
+    TEST_EQ(records.size(), 1);
+    TEST_TRUE(records[0] == "from ring2");
+
+    TEST_TRUE(strf::shm_ring::unlink(name.c_str()));
+    TEST_TRUE(! strf::shm_ring::open(name.c_str()).valid());
+}
+
+void test_wide_chars()
+{
+    auto name = unique_shm_name();
+    auto ring = strf::shm_ring::create(name.c_str(), 256);
+    strf::shm_ring::unlink(name.c_str());
+
+    auto res = strf::to_shm_ring<char16_t>(ring)(u"abc", 12);
+    TEST_TRUE(res.success);
+    TEST_EQ(res.count, 5);
+    auto records = consume_all(ring);
+    TEST_EQ(records.size(), 1);
+    TEST_TRUE(records[0].size() == 5 * sizeof(char16_t));
+    TEST_TRUE(std::u16string(reinterpret_cast<const char16_t*>(records[0].data()), 5) == u"abc12");
+}
+
+void test_full_ring_and_wrap_around()
+{
+    auto name = unique_shm_name();
+    auto ring = strf::shm_ring::create(name.c_str(), 128);
+    strf::shm_ring::unlink(name.c_str());
+
+    // each record takes 8 + 40 bytes
+    TEST_TRUE(strf::to_shm_ring(ring)(strf::multi('a', 40)).success);
+    TEST_TRUE(strf::to_shm_ring(ring)(strf::multi('b', 40)).success);
+    TEST_TRUE(! strf::to_shm_ring(ring)(strf::multi('c', 40)).success);
+    TEST_EQ(ring.dropped_count(), 1);
+
+    auto records = consume_all(ring);
+    TEST_EQ(records.size(), 2);
+    TEST_TRUE(records[0] == std::string(40, 'a'));
+    TEST_TRUE(records[1] == std::string(40, 'b'));
+
+    // The next record does not fit in the end of the data area,
+    // hence it is preceded by a padding record
+    TEST_TRUE(strf::to_shm_ring(ring)(strf::multi('d', 40)).success);
+    TEST_TRUE(strf::to_shm_ring(ring)(strf::multi('e', 40)).success);
+    records = consume_all(ring);
+    TEST_EQ(records.size(), 2);
+    TEST_TRUE(records[0] == std::string(40, 'd'));
+    TEST_TRUE(records[1] == std::string(40, 'e'));
+
+    for (int i = 0; i < 100; ++i) {
+        TEST_TRUE(strf::to_shm_ring(ring)(strf::multi('x', i % 30), i).success);
+        records = consume_all(ring);
+        TEST_EQ(records.size(), 1);
+        TEST_TRUE(records[0] == strf::to_string(strf::multi('x', i % 30), i));
+    }
+}
+
+void test_record_too_large()
+{
+    auto name = unique_shm_name();
+    auto ring = strf::shm_ring::create(name.c_str(), 4096);
+    strf::shm_ring::unlink(name.c_str());
+
+    auto res = strf::to_shm_ring<char, 64>(ring)(strf::multi('x', 100));
+    TEST_TRUE(! res.success);
+    TEST_EQ(res.count, 0);
+    TEST_TRUE(consume_all(ring).empty());
+    auto res2 = strf::to_shm_ring<char, 64>(ring)(strf::multi('x', 64));
+    TEST_TRUE(res2.success);
+    TEST_EQ(consume_all(ring).size(), 1);
+}
+
+void test_invalid_ring()
+{
+    strf::shm_ring ring;
+    TEST_TRUE(! ring.valid());
+    TEST_TRUE(! strf::to_shm_ring(ring)("abc").success);
+}
+
+// Claims a record of the given size, as a producer that dies before
+// committing it would do
+void claim_and_die(const char* name, std::size_t size)
+{
+    int fd = ::shm_open(name, O_RDWR, 0);
+    TEST_TRUE(fd >= 0);
+    struct ::stat st;
+    TEST_EQ(::fstat(fd, &st), 0);
+    auto map_size = static_cast<std::size_t>(st.st_size);
+    void* p = ::mmap(nullptr, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    TEST_TRUE(p != MAP_FAILED);
+    auto* header = static_cast<strf::detail::shm_ring_header*>(p);
+    char* data = static_cast<char*>(p) + strf::detail::shm_ring_data_offset;
+    std::uint64_t need = (strf::shm_ring::record_header_size + size + 7) & ~std::uint64_t(7);
+    auto pos = header->reserve_pos.fetch_add(need);
+    auto offset = pos & (header->capacity - 1);
+    reinterpret_cast<std::atomic<std::uint64_t>*>(data + offset)->store(need << 32);
+    ::munmap(p, map_size);
+}
+
+void test_dead_producer()
+{
+    auto name = unique_shm_name();
+    auto ring = strf::shm_ring::create(name.c_str(), 4096);
+    TEST_TRUE(ring.valid());
+
+    TEST_TRUE(strf::to_shm_ring(ring)("abc").success);
+    claim_and_die(name.c_str(), 20);
+    TEST_TRUE(strf::to_shm_ring(ring)("def").success);
+    strf::shm_ring::unlink(name.c_str());
+
+    // Without a timeout, the consumer waits forever for the claimed record
+    auto records = consume_all(ring);
+    TEST_EQ(records.size(), 1);
+    TEST_TRUE(records.size() == 1 && records[0] == "abc");
+    TEST_TRUE(consume_all(ring).empty());
+
+    const auto timeout = std::chrono::milliseconds(50);
+    auto consume_with_timeout = [&]() {
+        records.clear();
+        ring.consume( [&](const char* data, std::size_t size) {
+                          records.emplace_back(data, size); }
+                    , timeout );
+    };
+    consume_with_timeout();
+    TEST_TRUE(records.empty());
+    TEST_EQ(ring.abandoned_count(), 0);
+
+    // With it, the record is skipped once the timeout expires
+    std::this_thread::sleep_for(timeout + std::chrono::milliseconds(10));
+    consume_with_timeout();
+    TEST_EQ(records.size(), 1);
+    TEST_TRUE(records.size() == 1 && records[0] == "def");
+    TEST_EQ(ring.abandoned_count(), 1);
+
+    // The space is reused normally
+    for (int i = 0; i < 200; ++i) {
+        TEST_TRUE(strf::to_shm_ring(ring)(strf::multi('x', i % 50)).success);
+        consume_with_timeout();
+        TEST_EQ(records.size(), 1);
+    }
+    TEST_EQ(ring.abandoned_count(), 1);
+    TEST_EQ(ring.dropped_count(), 0);
+}
+
+// Checks that the records of each producer arrive complete and in order
+class records_checker
+{
+public:
+
+    explicit records_checker(int producers_count)
+        : _next(producers_count, 0)
+    {
+    }
+
+    void operator()(const char* data, std::size_t size)
+    {
+        int producer = -1, index = -1;
+        std::string str(data, size);
+        if (2 != std::sscanf(str.c_str(), "producer %d record %d", &producer, &index)
+          || producer < 0 || producer >= (int)_next.size()
+          || str != strf::to_string("producer ", producer, " record ", index, strf::multi('.', index % 50))
+          || index != _next[producer] ) {
+            ++_errors;
+            return;
+        }
+        ++_next[producer];
+        ++_count;
+    }
+
+    int count() const
+    {
+        return _count;
+    }
+    int errors() const
+    {
+        return _errors;
+    }
+
+private:
+
+    std::vector<int> _next;
+    int _count = 0;
+    int _errors = 0;
+};
+
+void produce(strf::shm_ring& ring, int producer, int records_count)
+{
+    for (int i = 0; i < records_count; ) {
+        auto res = strf::to_shm_ring(ring)
+            ("producer ", producer, " record ", i, strf::multi('.', i % 50));
+        if (res.success) {
+            ++i;
+        } else {
+            std::this_thread::yield(); // ring is full
+        }
+    }
+}
+
+void test_multiple_threads()
+{
+    auto name = unique_shm_name();
+    auto ring = strf::shm_ring::create(name.c_str(), 4096);
+    strf::shm_ring::unlink(name.c_str());
+
+    constexpr int producers_count = 4;
+    constexpr int records_count = 20000;
+    std::vector<std::thread> producers;
+    for (int p = 0; p < producers_count; ++p) {
+        producers.emplace_back([&ring, p]{ produce(ring, p, records_count); });
+    }
+    records_checker checker(producers_count);
+    while (checker.count() + checker.errors() < producers_count * records_count) {
+        if (0 == ring.consume(std::ref(checker))) {
+            std::this_thread::yield();
+        }
+    }
+    for (auto& t : producers) {
+        t.join();
+    }
+    TEST_EQ(checker.errors(), 0);
+    TEST_EQ(checker.count(), producers_count * records_count);
+}
+
+void test_multiple_processes()
+{
+    auto name = unique_shm_name();
+    auto ring = strf::shm_ring::create(name.c_str(), 4096);
+    TEST_TRUE(ring.valid());
+
+    constexpr int producers_count = 3;
+    constexpr int records_count = 5000;
+    std::vector<pid_t> children;
+    for (int p = 0; p < producers_count; ++p) {
+        pid_t pid = ::fork();
+        if (pid == 0) {
+            auto child_ring = strf::shm_ring::open(name.c_str());
+            if ( ! child_ring.valid()) {
+                ::_exit(1);
+            }
+            produce(child_ring, p, records_count);
+            ::_exit(0);
+        }
+        TEST_TRUE(pid > 0);
+        children.push_back(pid);
+    }
+    records_checker checker(producers_count);
+    int exited = 0;
+    while (checker.count() + checker.errors() < producers_count * records_count) {
+        if (0 == ring.consume(std::ref(checker))) {
+            int status = 0;
+            pid_t pid = ::waitpid(-1, &status, WNOHANG);
+            if (pid > 0) {
+                ++exited;
+                TEST_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+                if (! WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+                    break;
+                }
+            }
+            std::this_thread::yield();
+        }
+    }
+    for (; exited < producers_count; ++exited) {
+        int status = 0;
+        ::waitpid(-1, &status, 0);
+    }
+    strf::shm_ring::unlink(name.c_str());
+    TEST_EQ(checker.errors(), 0);
+    TEST_EQ(checker.count(), producers_count * records_count);
+}
+
+int main()
+{
+    std::srand(static_cast<unsigned>(std::time(nullptr)));
+
+    test_single_process();
+    test_wide_chars();
+    test_full_ring_and_wrap_around();
+    test_record_too_large();
+    test_invalid_ring();
+    test_dead_producer();
+    test_multiple_threads();
+    test_multiple_processes();
+
+    return test_finish();
+}
@@ -117,6 +117,26 @@ void test( const strf::encoding<char>& enc
         .with(enc, strf::encoding_error::replace)
         (strf::sani(u"---\U0010FFFF+++"));
 
+    // code points that are not mapped, but are near the ones that are
+    TEST("-?-?-?-?-?-?-?-")
+        .with(enc, strf::encoding_error::replace)
+        (strf::sani(U"-Ā-Ź-˗- -₫-￿-\U00010000-"));
+    {
+        // from UTF-32, each character between runs of ASCII characters
+        std::u32string input;
+        std::string expected;
+        for (auto ch : valid_u32input) {
+            input.append(U"lorem ipsum dolor ");
+            input.push_back(ch);
+        }
+        auto r = strf::to(char_buf).with(enc) (strf::sani(valid_u32input));
+        for (auto it = char_buf; it != r.ptr; ++it) {
+            expected.append("lorem ipsum dolor ");
+            expected.push_back(*it);
+        }
+        TEST_TRUE(strf::to_string.with(enc)(strf::sani(input)) == expected);
+    }
+
 #if defined(__cpp_exceptions)
 
     {
@@ -124,11 +144,124 @@ void test( const strf::encoding<char>& enc
         TEST_THROWS(
             ( (strf::to_string.with(facets)(strf::sani(u"---\U0010FFFF++"))))
             , strf::encoding_failure );
+        TEST_THROWS(
+            ( (strf::to_string.with(facets)(strf::sani(U"--------------₫"))))
+            , strf::encoding_failure );
     }
 
 #endif // defined(__cpp_exceptions)
 }
 
+void test_utf_transcoders
+    ( const strf::encoding<char>& enc
+    , strf::detail::simple_string_view<char32_t> decoded_0_to_0xff )
+{
+    TEST_SCOPE_DESCRIPTION(enc.name());
+
+    // The expected results are obtained by encoding from UTF-32
+    const std::string u8expected = strf::to_string(strf::sani(decoded_0_to_0xff));
+    const std::u16string u16expected = strf::to_u16string(strf::sani(decoded_0_to_0xff));
+    {
+        // to UTF-8
+        strf::detail::simple_string_view<char> expected_view
+            { u8expected.data(), u8expected.size() };
+        TEST(expected_view) (strf::sani(str_0_to_xff, enc));
+    }
+    {
+        // to UTF-16
+        strf::detail::simple_string_view<char16_t> expected_view
+            { u16expected.data(), u16expected.size() };
+        TEST(expected_view) (strf::sani(str_0_to_xff, enc));
+    }
+    {
+        // each character between runs of ASCII characters
+        std::string input;
+        std::string expected;
+        for (unsigned i = 0; i < 0x100; ++i) {
+            input.append("lorem ipsum dolor ");
+            input.push_back(str_0_to_xff.begin()[i]);
+            expected.append("lorem ipsum dolor ");
+            expected.append(strf::to_string(strf::sani(make_view(decoded_0_to_0xff.begin() + i, std::size_t{1}))));
+        }
+        TEST_TRUE(strf::to_string(strf::sani(input, enc)) == expected);
+        TEST_TRUE(strf::to_string.reserve_calc()(strf::sani(input, enc)) == expected);
+
+        auto sanitized = char_0_to_0xff_sanitized(enc);
+        std::string expected_sb;
+        for (unsigned i = 0; i < 0x100; ++i) {
+            expected_sb.append("lorem ipsum dolor ");
+            expected_sb.push_back(sanitized.begin()[i]);
+        }
+        auto from_u8 = strf::to_string.with(enc) (strf::sani(expected, strf::utf8<char>()));
+        TEST_TRUE(from_u8 == expected_sb);
+    }
+    TEST("---?+++")
+        .with(enc, strf::encoding_error::replace)
+        (strf::sani("---\xF0\x90\xBF+++", strf::utf8<char>()));
+
+#if defined(__cpp_exceptions)
+
+    if ( ! (char_0_to_0xff_sanitized(enc) == str_0_to_xff)) {
+        // there is an invalid byte
+        TEST_THROWS(
+            ( (strf::to_string.with(strf::encoding_error::stop)
+                (strf::sani(str_0_to_xff, enc))))
+            , strf::encoding_failure );
+        TEST_THROWS(
+            ( (strf::to_u16string.with(strf::encoding_error::stop)
+                (strf::sani(str_0_to_xff, enc))))
+            , strf::encoding_failure );
+    }
+    {
+        auto facets = strf::pack(enc, strf::encoding_error::stop);
+        TEST_THROWS(
+            ( (strf::to_string.with(facets)
+                (strf::sani("---\xF0\x90\xBF+++", strf::utf8<char>()))))
+            , strf::encoding_failure );
+    }
+
+#endif // defined(__cpp_exceptions)
+}
+
+void test_single_byte_to_single_byte
+    ( const strf::encoding<char>& enc_in
+    , strf::detail::simple_string_view<char32_t> decoded_0_to_0xff
+    , const strf::encoding<char>& enc_out )
+{
+    TEST_SCOPE_DESCRIPTION("from ", enc_in.name(), " to ", enc_out.name());
+
+    char expected[0x101];
+    auto r = strf::to(expected, sizeof(expected))
+        .with(enc_out) (strf::sani(decoded_0_to_0xff));
+    TEST(make_view(expected, r.ptr)).with(enc_out) (strf::sani(str_0_to_xff, enc_in));
+}
+
+void test_decode_encode()
+{
+    // A pair of encodings without a direct transcoder
+    std::string input;
+    for (int i = 0; i < 100; ++i) {
+        input.append((const char*)u8"abcé中\U0001F600");
+    }
+    const std::u16string expected = strf::to_u16string(strf::cv(input));
+
+    char16_t buff[1000];
+    strf::basic_cstr_writer<char16_t> ob(buff);
+    strf::decode_encode( ob, input.data(), input.data() + input.size()
+                       , strf::utf8<char>(), strf::utf16<char16_t>()
+                       , strf::encoding_error::replace
+                       , strf::surrogate_policy::strict );
+    auto res = ob.finish();
+    TEST_TRUE(! res.truncated);
+    TEST_TRUE(expected.compare(0, expected.size(), buff, res.ptr - buff) == 0);
+
+    auto size = strf::decode_encode_size
+        ( input.data(), input.data() + input.size()
+        , strf::utf8<char>(), strf::utf16<char16_t>()
+        , strf::surrogate_policy::strict );
+    TEST_EQ(size, expected.size());
+}
+
 strf::detail::simple_string_view<char32_t> decoded_0_to_xff_iso_8859_1()
 {
     static const char32_t table[0x100] =
@@ -291,5 +424,26 @@ int main()
     test(strf::iso_8859_3<char>(), decoded_0_to_xff_iso_8859_3());
     test(strf::iso_8859_15<char>(), decoded_0_to_xff_iso_8859_15());
     test(strf::windows_1252<char>(), decoded_0_to_xff_windows_1252() );
+
+    test_utf_transcoders(strf::iso_8859_1<char>(), decoded_0_to_xff_iso_8859_1());
+    test_utf_transcoders(strf::iso_8859_3<char>(), decoded_0_to_xff_iso_8859_3());
+    test_utf_transcoders(strf::iso_8859_15<char>(), decoded_0_to_xff_iso_8859_15());
+    test_utf_transcoders(strf::windows_1252<char>(), decoded_0_to_xff_windows_1252());
+
+    const strf::encoding<char> single_byte_encodings[] =
+        { strf::iso_8859_1<char>(), strf::iso_8859_3<char>()
+        , strf::iso_8859_15<char>(), strf::windows_1252<char>() };
+    const strf::detail::simple_string_view<char32_t> decoded[] =
+        { decoded_0_to_xff_iso_8859_1(), decoded_0_to_xff_iso_8859_3()
+        , decoded_0_to_xff_iso_8859_15(), decoded_0_to_xff_windows_1252() };
+    for (std::size_t i = 0; i < 4; ++i) {
+        for (const auto& enc_out : single_byte_encodings) {
+            test_single_byte_to_single_byte
+                ( single_byte_encodings[i], decoded[i], enc_out );
+        }
+    }
+
+    test_decode_encode();
+
     return test_finish();
 }
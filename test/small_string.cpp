@@ -0,0 +1,96 @@
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include "test_utils.hpp"
+#include <utility>
+
+template <typename CharT>
+void test_small_string_maker()
+{
+    auto tiny_str = test_utils::make_tiny_string<CharT>();
+    auto double_str = test_utils::make_double_string<CharT>();
+    std::basic_string<CharT> tiny_expected(tiny_str.begin(), tiny_str.end());
+    std::basic_string<CharT> double_expected(double_str.begin(), double_str.end());
+
+    {
+        auto s = strf::to_basic_small_string<CharT, 128>(tiny_str);
+        TEST_TRUE(s.is_inline());
+        TEST_TRUE(std::basic_string<CharT>(s.begin(), s.end()) == tiny_expected);
+        TEST_TRUE(s.c_str()[s.size()] == CharT());
+    }
+    {
+        auto s = strf::to_basic_small_string<CharT, 16>(double_str);
+        TEST_TRUE(! s.is_inline());
+        TEST_TRUE(std::basic_string<CharT>(s.begin(), s.end()) == double_expected);
+        TEST_TRUE(s.c_str()[s.size()] == CharT());
+    }
+    {
+        auto s = strf::to_basic_small_string<CharT, 16>.reserve_calc()(double_str);
+        TEST_TRUE(! s.is_inline());
+        TEST_TRUE(std::basic_string<CharT>(s.begin(), s.end()) == double_expected);
+        TEST_TRUE(s.c_str()[s.size()] == CharT());
+    }
+    {
+        auto s = strf::to_basic_small_string<CharT, 16>.reserve(5)(tiny_str);
+        TEST_TRUE(s.is_inline() == (tiny_str.size() <= 16));
+        TEST_TRUE(std::basic_string<CharT>(s.begin(), s.end()) == tiny_expected);
+    }
+}
+
+void test_exact_inline_capacity()
+{
+    auto s1 = strf::to_small_string<10>(strf::multi('x', 10));
+    TEST_TRUE(s1.is_inline());
+    TEST_EQ(s1.capacity(), 10);
+    TEST_TRUE(std::string(s1.c_str()) == "xxxxxxxxxx");
+
+    auto s2 = strf::to_small_string<10>(strf::multi('x', 11));
+    TEST_TRUE(! s2.is_inline());
+    TEST_TRUE(std::string(s2.c_str()) == "xxxxxxxxxxx");
+
+    auto s3 = strf::to_small_string<64>();
+    TEST_TRUE(s3.empty());
+    TEST_TRUE(s3.c_str()[0] == '\0');
+}
+
+void test_copy_and_move()
+{
+    auto small = strf::to_small_string<32>("Hello World");
+    auto big = strf::to_small_string<32>(strf::multi('x', 100));
+
+    auto small_copy = small;
+    auto big_copy = big;
+    TEST_TRUE(small_copy == small);
+    TEST_TRUE(big_copy == big);
+    TEST_TRUE(big_copy.data() != big.data());
+
+    const char* big_data = big.data();
+    auto big_moved = std::move(big);
+    TEST_TRUE(big_moved.data() == big_data);
+    TEST_TRUE(big.empty());
+    TEST_TRUE(big.is_inline());
+    TEST_TRUE(big_moved == big_copy);
+
+    auto small_moved = std::move(small);
+    TEST_TRUE(small_moved == small_copy);
+    TEST_TRUE(small_moved.is_inline());
+
+    small_moved = big_copy;
+    TEST_TRUE(small_moved == big_copy);
+    big_copy = std::move(small_copy);
+    TEST_TRUE(std::string(big_copy.c_str()) == "Hello World");
+    TEST_TRUE(big_copy != small_moved);
+}
+
+int main()
+{
+    test_small_string_maker<char>();
+    test_small_string_maker<char16_t>();
+    test_small_string_maker<char32_t>();
+    test_small_string_maker<wchar_t>();
+    test_exact_inline_capacity();
+    test_copy_and_move();
+
+    return test_finish();
+}
@@ -32,6 +32,114 @@ void test_successfull_writing()
                                            , double_str.size() ));
 }
 
+template <typename CharT>
+void test_direct_writing()
+{
+    // Strings that do not fit in the buffer are passed directly to sputn
+    auto tiny_str = test_utils::make_tiny_string<CharT>();
+    auto big_str = test_utils::make_string<CharT>(1000);
+
+    std::basic_ostringstream<CharT> dest;
+    strf::basic_streambuf_writer<CharT> writer(*dest.rdbuf());
+
+    write(writer, tiny_str.begin(), tiny_str.size());
+    write(writer, big_str.data(), big_str.size());
+    write(writer, tiny_str.begin(), tiny_str.size());
+    strf::to(writer)(big_str);
+    auto status = writer.finish();
+    dest.rdbuf()->pubsync();
+
+    std::basic_string<CharT> expected(tiny_str.begin(), tiny_str.size());
+    expected += big_str;
+    expected.append(tiny_str.begin(), tiny_str.size());
+    expected += big_str;
+
+    TEST_TRUE(status.success);
+    TEST_EQ(status.count, (std::streamsize)expected.size());
+    TEST_TRUE(dest.str() == expected);
+}
+
+// A streambuf whose put area is a fixed array, which
+// is moved into a string on each call to overflow
+template <typename CharT>
+class test_streambuf: public std::basic_streambuf<CharT>
+{
+    using _traits = std::char_traits<CharT>;
+
+public:
+
+    explicit test_streambuf(bool has_put_area)
+        : _has_put_area(has_put_area)
+    {
+        if (has_put_area) {
+            this->setp(_area, _area + sizeof(_area) / sizeof(_area[0]));
+        }
+    }
+
+    const std::basic_string<CharT>& str()
+    {
+        _flush();
+        return _str;
+    }
+
+    int xsputn_calls = 0;
+
+protected:
+
+    typename _traits::int_type overflow(typename _traits::int_type ch) override
+    {
+        _flush();
+        if ( ! _traits::eq_int_type(ch, _traits::eof())) {
+            _str.push_back(_traits::to_char_type(ch));
+        }
+        return _traits::not_eof(ch);
+    }
+
+    std::streamsize xsputn(const CharT* s, std::streamsize n) override
+    {
+        ++xsputn_calls;
+        return std::basic_streambuf<CharT>::xsputn(s, n);
+    }
+
+private:
+
+    void _flush()
+    {
+        if (_has_put_area) {
+            _str.append(this->pbase(), this->pptr());
+            this->setp(_area, _area + sizeof(_area) / sizeof(_area[0]));
+        }
+    }
+
+    bool _has_put_area;
+    CharT _area[500];
+    std::basic_string<CharT> _str;
+};
+
+template <typename CharT>
+void test_put_area()
+{
+    auto big_str = test_utils::make_string<CharT>(2000);
+    {
+        // Content is written directly into the put area
+        test_streambuf<CharT> sb(true);
+        auto status = strf::to(sb)(strf::multi(CharT('a'), 100), big_str);
+        TEST_TRUE(status.success);
+        TEST_EQ(status.count, 2100);
+        TEST_EQ(sb.xsputn_calls, 1); // only for big_str
+        TEST_TRUE(sb.str() == std::basic_string<CharT>(100, CharT('a')) + big_str);
+    }
+    {
+        // Without a put area, the content goes through sputn
+        test_streambuf<CharT> sb(false);
+        auto status = strf::to(sb)(strf::multi(CharT('a'), 100), big_str);
+        TEST_TRUE(status.success);
+        TEST_EQ(status.count, 2100);
+        TEST_TRUE(sb.xsputn_calls > 1);
+        TEST_TRUE(sb.str() == std::basic_string<CharT>(100, CharT('a')) + big_str);
+    }
+}
+
 template <typename CharT>
 void test_failing_to_recycle()
 {
@@ -131,6 +239,15 @@ int main()
     test_successfull_writing<char32_t>();
     test_successfull_writing<wchar_t>();
 
+    test_direct_writing<char>();
+    test_direct_writing<char16_t>();
+    test_direct_writing<char32_t>();
+    test_direct_writing<wchar_t>();
+
+    test_put_area<char>();
+    test_put_area<char16_t>();
+    test_put_area<wchar_t>();
+
     test_failing_to_recycle<char>();
     test_failing_to_recycle<char16_t>();
     test_failing_to_recycle<char32_t>();
@@ -47,6 +47,106 @@ void test_successfull_make()
                                  , double_str.size() ));
 }
 
+template <typename CharT>
+void test_long_output()
+{
+    auto double_str = test_utils::make_double_string<CharT>();
+    std::basic_string<CharT> expected;
+    for (int i = 0; i < 50; ++i) {
+        expected.append(double_str.begin(), double_str.size());
+    }
+    {
+        strf::basic_string_maker<CharT> ob;
+        for (int i = 0; i < 50; ++i) {
+            write(ob, double_str.begin(), double_str.size());
+        }
+        TEST_TRUE(ob.finish() == expected);
+    }
+    {
+        strf::basic_pre_sized_string_maker<CharT> ob(10);
+        for (int i = 0; i < 50; ++i) {
+            write(ob, double_str.begin(), double_str.size());
+        }
+        TEST_TRUE(ob.finish() == expected);
+    }
+    {
+        std::basic_string<CharT> str(double_str.begin(), double_str.size());
+        strf::basic_string_appender<CharT> ob(str);
+        for (int i = 1; i < 50; ++i) {
+            write(ob, double_str.begin(), double_str.size());
+        }
+        ob.finish();
+        TEST_TRUE(str == expected);
+    }
+}
+
+template <typename CharT>
+void test_appender_not_finished()
+{
+    // When finish() is not called ( because an exception has been thrown,
+    // for instance ), the string shall only contain what has been written.
+    auto tiny_str = test_utils::make_tiny_string<CharT>();
+    auto double_str = test_utils::make_double_string<CharT>();
+
+    std::basic_string<CharT> str(tiny_str.begin(), tiny_str.size());
+    {
+        strf::basic_string_appender<CharT> ob(str);
+        write(ob, double_str.begin(), double_str.size());
+    }
+    TEST_EQ(str.size(), tiny_str.size() + double_str.size());
+    TEST_TRUE(0 == str.compare( tiny_str.size()
+                              , double_str.size()
+                              , double_str.begin()
+                              , double_str.size() ));
+}
+
+template <typename CharT>
+void test_reserve_contiguous()
+{
+    auto tiny_str = test_utils::make_tiny_string<CharT>();
+    {
+        strf::basic_string_maker<CharT> ob;
+        write(ob, tiny_str.begin(), tiny_str.size());
+        TEST_TRUE(ob.reserve_contiguous(5000));
+        TEST_TRUE(ob.size() >= 5000);
+        strf::detail::char_assign<CharT>(ob.pos(), 5000, CharT('x'));
+        ob.advance(5000);
+        auto str = ob.finish();
+
+        std::basic_string<CharT> expected(tiny_str.begin(), tiny_str.size());
+        expected.append(5000, CharT('x'));
+        TEST_TRUE(str == expected);
+    }
+    {
+        std::basic_string<CharT> str(tiny_str.begin(), tiny_str.size());
+        strf::basic_string_appender<CharT> ob(str);
+        TEST_TRUE(ob.reserve_contiguous(3000));
+        TEST_TRUE(ob.size() >= 3000);
+        strf::detail::char_assign<CharT>(ob.pos(), 3000, CharT('y'));
+        ob.advance(3000);
+        ob.finish();
+
+        std::basic_string<CharT> expected(tiny_str.begin(), tiny_str.size());
+        expected.append(3000, CharT('y'));
+        TEST_TRUE(str == expected);
+    }
+    {
+        // Long fills are written at once
+        auto str = strf::to_basic_string<CharT>
+            ( strf::multi(static_cast<CharT>('a'), 10000)
+            , strf::right(CharT('b'), 10000, U'\u00E9') );
+        std::basic_string<CharT> expected(10000, CharT('a'));
+        auto e_acute = strf::to_basic_string<CharT>
+            (strf::right(CharT('b'), 2, U'\u00E9'));
+        e_acute.pop_back();
+        for (int i = 0; i < 9999; ++i) {
+            expected += e_acute;
+        }
+        expected += CharT('b');
+        TEST_TRUE(str == expected);
+    }
+}
+
 template <typename CharT>
 void test_destinations()
 {
@@ -124,5 +224,16 @@ int main()
     test_successfull_make<char>();
     test_successfull_make<char16_t>();
 
+    test_long_output<char>();
+    test_long_output<char16_t>();
+    test_long_output<char32_t>();
+
+    test_reserve_contiguous<char>();
+    test_reserve_contiguous<char16_t>();
+    test_reserve_contiguous<char32_t>();
+
+    test_appender_not_finished<char>();
+    test_appender_not_finished<char16_t>();
+
     return test_finish();
 }
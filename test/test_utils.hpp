@@ -11,6 +11,8 @@
 
 #if defined(_WIN32)
 #include <windows.h>
+#else
+#include <unistd.h>
 #endif  // defined(_WIN32)
 
 #include "boost/current_function.hpp"
@@ -25,13 +27,16 @@ std::string unique_tmp_file_name()
     char dirname[MAX_PATH];
     GetTempPathA(MAX_PATH, dirname);
     char fullname[MAX_PATH];
-    sprintf_s(fullname, MAX_PATH, "%s\\test_boost_outbuf_%x.txt", dirname, std::rand());
+    sprintf_s( fullname, MAX_PATH, "%s\\test_boost_outbuf_%lx_%x.txt", dirname
+             , (unsigned long)GetCurrentProcessId(), std::rand() );
     return fullname;
 
 #else // defined(_WIN32)
 
    char fullname[200];
-   sprintf(fullname, "/tmp/test_boost_outbuf_%x.txt", std::rand());
+   // The process id prevents collisions between test programs run in parallel
+   sprintf( fullname, "/tmp/test_boost_outbuf_%lx_%x.txt"
+          , (unsigned long)getpid(), std::rand() );
    return fullname;
 
 #endif  // defined(_WIN32)
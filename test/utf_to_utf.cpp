@@ -5,6 +5,7 @@
 #include "test_utils.hpp"
 
 #include <array>
+#include <string>
 #include <tuple>
 
 template <typename T>
@@ -48,6 +49,51 @@ void test_valid_input
     TEST(expected).with(eout) (strf::sani(input, ein));
 }
 
+template <typename CharT>
+std::basic_string<CharT> ascii_runs_sample
+    ( const strf::encoding<CharT>& enc
+    , std::size_t run_length )
+{
+    auto sample = valid_input_sample(enc);
+    std::basic_string<CharT> str;
+    for (int i = 0; i < 3; ++i) {
+        for (std::size_t j = 0; j < run_length; ++j) {
+            str.push_back(static_cast<CharT>('0' + (i + j) % 64));
+        }
+        str.append(sample.begin(), sample.size());
+    }
+    return str;
+}
+
+template <typename CharIn, typename CharOut>
+void test_ascii_runs
+    ( const strf::encoding<CharIn>& ein
+    , const strf::encoding<CharOut>& eout )
+{
+    TEST_SCOPE_DESCRIPTION("from ", ein.name(), " to ", eout.name());
+
+    const std::size_t run_lengths[] = {7, 8, 9, 15, 16, 17, 24, 31, 32, 33, 40, 100};
+    for (auto run_length : run_lengths) {
+        TEST_SCOPE_DESCRIPTION("ASCII run length: ", run_length);
+
+        auto input = ascii_runs_sample(ein, run_length);
+        auto expected = ascii_runs_sample(eout, run_length);
+        strf::detail::simple_string_view<CharOut> expected_view
+            { expected.data(), expected.size() };
+        TEST(expected_view).with(eout) (strf::sani(input, ein));
+
+        // destination ending inside the runs
+        for (std::size_t size = 2; size < 2 * run_length + 20; size += 5) {
+            CharOut buff[300];
+            auto res = strf::to(buff, size).with(eout) (strf::sani(input, ein));
+            std::size_t len = res.ptr - buff;
+            TEST_TRUE(res.truncated);
+            TEST_TRUE(len + 4 >= size && len < size);
+            TEST_TRUE(expected.compare(0, len, buff, len) == 0);
+        }
+    }
+}
+
 strf::detail::simple_string_view<char>
 sample_with_surrogates(const strf::encoding<char>&)
 {
@@ -72,6 +118,44 @@ sample_with_surrogates(const strf::encoding<wchar_t>&)
     return {arr, 8};
 }
 
+#define MULTILINGUAL_TEXT(PREFIX)                                             \
+    PREFIX ## "Съешь же ещё " \
+    PREFIX ## "этих мягких, " \
+    PREFIX ## "文字化け、字符集 123. "        \
+    PREFIX ## "\U0001F600 café αβγ \U00010000"
+
+strf::detail::simple_string_view<char>
+multilingual_text(const strf::encoding<char>&)
+{
+    return (const char*)MULTILINGUAL_TEXT(u8);
+}
+strf::detail::simple_string_view<char16_t>
+multilingual_text(const strf::encoding<char16_t>&)
+{
+    return MULTILINGUAL_TEXT(u);
+}
+strf::detail::simple_string_view<char32_t>
+multilingual_text(const strf::encoding<char32_t>&)
+{
+    return MULTILINGUAL_TEXT(U);
+}
+strf::detail::simple_string_view<wchar_t>
+multilingual_text(const strf::encoding<wchar_t>&)
+{
+    return MULTILINGUAL_TEXT(L);
+}
+
+template <typename CharT>
+void append
+    ( std::basic_string<CharT>& str
+    , strf::detail::simple_string_view<CharT> x
+    , std::size_t count = 1 )
+{
+    for (std::size_t i = 0; i < count; ++i) {
+        str.append(x.begin(), x.size());
+    }
+}
+
 template <typename CharIn, typename CharOut>
 void test_allowed_surrogates
     ( const strf::encoding<CharIn>& ein
@@ -87,6 +171,24 @@ void test_allowed_surrogates
                , strf::encoding_error::stop
                , strf::surrogate_policy::lax )
         (strf::sani(input, ein));
+
+    // surrogates inside long text
+    std::basic_string<CharIn> long_input;
+    std::basic_string<CharOut> long_expected;
+    append(long_input, multilingual_text(ein));
+    append(long_input, input, 4);
+    append(long_input, multilingual_text(ein));
+    append(long_expected, multilingual_text(eout));
+    append(long_expected, expected, 4);
+    append(long_expected, multilingual_text(eout));
+
+    strf::detail::simple_string_view<CharOut> long_expected_view
+        { long_expected.data(), long_expected.size() };
+    TEST(long_expected_view)
+        .with( eout
+               , strf::encoding_error::stop
+               , strf::surrogate_policy::lax )
+        (strf::sani(long_input, ein));
 }
 
 const auto& invalid_sequences(const strf::encoding<char>&)
@@ -250,6 +352,69 @@ void test_invalid_input
 }
 
 
+template <typename CharIn, typename CharOut>
+void test_long_text
+    ( const strf::encoding<CharIn>& ein
+    , const strf::encoding<CharOut>& eout )
+{
+    TEST_SCOPE_DESCRIPTION("from ", ein.name(), " to ", eout.name());
+
+    for (std::size_t offset = 0; offset < 20; ++offset) {
+        TEST_SCOPE_DESCRIPTION("offset: ", offset);
+
+        std::basic_string<CharIn> input(offset, static_cast<CharIn>('x'));
+        std::basic_string<CharOut> expected(offset, static_cast<CharOut>('x'));
+        append(input, multilingual_text(ein), 3);
+        append(expected, multilingual_text(eout), 3);
+
+        strf::detail::simple_string_view<CharOut> expected_view
+            { expected.data(), expected.size() };
+        TEST(expected_view).with(eout) (strf::sani(input, ein));
+
+        // destination ending inside the text
+        CharOut buff[600];
+        std::size_t size = 10 + offset * 7;
+        auto res = strf::to(buff, size).with(eout) (strf::sani(input, ein));
+        std::size_t len = res.ptr - buff;
+        TEST_TRUE(res.truncated);
+        TEST_TRUE(len + 4 >= size && len < size);
+        TEST_TRUE(expected.compare(0, len, buff, len) == 0);
+    }
+
+    // invalid sequences inside long text, at each position within a block
+    for(const auto& s : invalid_sequences(ein))
+    for (std::size_t offset = 0; offset < 17; ++offset) {
+        const int err_count = s.first;
+        std::basic_string<CharIn> input(offset, static_cast<CharIn>('x'));
+        std::basic_string<CharOut> expected(offset, static_cast<CharOut>('x'));
+        append(input, multilingual_text(ein));
+        append(input, s.second);
+        append(input, multilingual_text(ein));
+        append(expected, multilingual_text(eout));
+        append(expected, replacement_char(eout), err_count);
+        append(expected, multilingual_text(eout));
+
+        strf::detail::simple_string_view<CharOut> expected_view
+            { expected.data(), expected.size() };
+        TEST(expected_view)
+            .with(eout)
+            .with(strf::encoding_error::replace)
+            (strf::sani(input, ein));
+
+#if defined(__cpp_exceptions)
+
+        CharOut buff[600];
+        TEST_THROWS( (strf::to(buff)
+                          .with(eout, strf::encoding_error::stop)
+                          (strf::sani(input, ein)))
+                   , strf::encoding_failure );
+
+#endif // defined(__cpp_exceptions)
+
+    }
+}
+
+
 template < typename Func
          , typename EncIn >
 void combine_3(Func, EncIn)
@@ -328,6 +493,10 @@ int main()
         ( encodings
         , [](auto ein, auto eout){ test_valid_input(ein, eout); } );
 
+    for_all_combinations
+        ( encodings
+        , [](auto ein, auto eout){ test_ascii_runs(ein, eout); } );
+
     for_all_combinations
         ( encodings
         , [](auto ein, auto eout){ test_allowed_surrogates(ein, eout); } );
@@ -336,5 +505,9 @@ int main()
         ( encodings
         , [](auto ein, auto eout){ test_invalid_input(ein, eout); } );
 
+    for_all_combinations
+        ( encodings
+        , [](auto ein, auto eout){ test_long_text(ein, eout); } );
+
     return test_finish();
 }
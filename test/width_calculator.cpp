@@ -4,6 +4,7 @@
 
 #include <strf.hpp>
 #include "test_utils.hpp"
+#include <string>
 
 int custom_width_calculator_function( int limit
                                     , const char32_t* it
@@ -95,5 +96,30 @@ int main()
     TEST( u"         \u2E3A\u2E3A\u2014")
         (strf::cv( U"\u2E3A\u2E3A\u2014") > 12);
 
+    {   // long strings
+        std::string str(37, 'x');
+        for (int i = 0; i < 10; ++i) {
+            str.append((const char*)u8"\u03B1\u03B2\u03B3 \u0434\u043E\u043C \u4E2D\u6587 \U0001F600 ");
+        }
+        // 37 + 10 * 13 = 167 code points
+        std::string expected = std::string(3, ' ') + str;
+        strf::detail::simple_string_view<char> expected_view
+            { expected.data(), expected.size() };
+        strf::detail::simple_string_view<char> str_view
+            { str.data(), str.size() };
+
+        TEST(expected_view)
+            .with(strf::width_as_u32len<char>{})
+            (strf::right(str, 170));
+
+        TEST(str_view)
+            .with(strf::width_as_u32len<char>{})
+            (strf::right(str, 167));
+
+        TEST(str_view)
+            .with(strf::width_as_u32len<char>{})
+            (strf::right(str, 20));
+    }
+
     return test_finish();
 }
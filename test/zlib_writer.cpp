@@ -0,0 +1,213 @@
+//  Distributed under the Boost Software License, Version 1.0.
+//  (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <ctime>
+#include <cstdlib>
+#include <fcntl.h>
+#include "test_utils.hpp"
+#include <strf/detail/output_types/zlib.hpp>
+
+// Decompresses gzip, zlib or, when raw is true, raw deflate data
+std::string inflate_all(const std::string& compressed, bool raw = false)
+{
+    ::z_stream s{};
+    if (::inflateInit2(&s, raw ? -MAX_WBITS : MAX_WBITS + 32) != Z_OK) {
+        return "<inflateInit2 failed>";
+    }
+    s.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(compressed.data()));
+    s.avail_in = static_cast<uInt>(compressed.size());
+    std::string result;
+    char buff[4096];
+    int r;
+    do {
+        s.next_out = reinterpret_cast<Bytef*>(buff);
+        s.avail_out = sizeof(buff);
+        r = ::inflate(&s, Z_NO_FLUSH);
+        if (r != Z_OK && r != Z_STREAM_END) {
+            ::inflateEnd(&s);
+            return "<inflate failed>";
+        }
+        result.append(buff, sizeof(buff) - s.avail_out);
+    } while (r != Z_STREAM_END);
+    ::inflateEnd(&s);
+    return result;
+}
+
+template <typename CharT>
+std::string as_bytes(const std::basic_string<CharT>& str)
+{
+    return {reinterpret_cast<const char*>(str.data()), str.size() * sizeof(CharT)};
+}
+
+template <typename CharT>
+void test_successfull_writing()
+{
+    auto tiny_str = test_utils::make_tiny_string<CharT>();
+    auto double_str = test_utils::make_double_string<CharT>();
+
+    std::FILE* file = std::tmpfile();
+    TEST_TRUE(file != nullptr);
+    auto res = strf::to_gzip<CharT>(file) (tiny_str, double_str, double_str, tiny_str);
+    std::rewind(file);
+    auto compressed = test_utils::read_file<char>(file);
+    std::fclose(file);
+
+    std::basic_string<CharT> expected(tiny_str.begin(), tiny_str.end());
+    expected.append(double_str.begin(), double_str.end());
+    expected.append(double_str.begin(), double_str.end());
+    expected.append(tiny_str.begin(), tiny_str.end());
+
+    TEST_TRUE(res.success);
+    TEST_EQ(res.count, expected.size());
+    TEST_EQ(res.compressed_size, compressed.size());
+    TEST_TRUE(compressed.size() > 2);
+    TEST_EQ((unsigned char)compressed[0], 0x1f); // gzip magic number
+    TEST_EQ((unsigned char)compressed[1], 0x8b);
+    TEST_TRUE(inflate_all(compressed) == as_bytes(expected));
+}
+
+void test_large_content()
+{
+    // Many recycles, and large strings passed directly to deflate
+    auto path = test_utils::unique_tmp_file_name();
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    TEST_TRUE(fd >= 0);
+
+    constexpr int lines_count = 100000;
+    std::string expected;
+    std::size_t count = 0;
+    {
+        strf::zlib_writer writer(fd, strf::zlib_format::gzip, Z_BEST_SPEED, 1000);
+        const std::string long_str(3000, 'z');
+        for (int i = 0; i < lines_count; ++i) {
+            strf::to(writer)(strf::right(i, 8, '0'), '\n');
+            expected += strf::to_string(strf::right(i, 8, '0'), '\n');
+            if (i % 10000 == 0) {
+                strf::to(writer)(long_str);
+                expected += long_str;
+            }
+        }
+        auto res = writer.finish();
+        TEST_TRUE(res.success);
+        count = res.count;
+    }
+    ::close(fd);
+    TEST_EQ(count, expected.size());
+
+    auto compressed = test_utils::read_file<char>(path.c_str());
+    std::remove(path.c_str());
+    TEST_TRUE(compressed.size() < expected.size());
+    TEST_TRUE(inflate_all(compressed) == expected);
+}
+
+void test_formats()
+{
+    // Several printing calls into a single stream
+    const std::string expected = strf::to_string(strf::multi('a', 3000), 12345, "abc");
+    {
+        std::FILE* file = std::tmpfile();
+        strf::zlib_writer writer(file, strf::zlib_format::zlib);
+        strf::to(writer)(strf::multi('a', 3000));
+        strf::to(writer)(12345);
+        strf::to(writer)("abc");
+        auto res = writer.finish();
+        std::rewind(file);
+        auto compressed = test_utils::read_file<char>(file);
+        std::fclose(file);
+        TEST_TRUE(res.success);
+        TEST_EQ(res.count, expected.size());
+        TEST_EQ((unsigned char)compressed[0], 0x78); // zlib header
+        TEST_TRUE(inflate_all(compressed) == expected);
+    }
+    {
+        std::FILE* file = std::tmpfile();
+        strf::zlib_writer writer(file, strf::zlib_format::deflate, 9);
+        strf::to(writer)(strf::multi('a', 3000), 12345);
+        strf::to(writer)("abc");
+        auto res = writer.finish();
+        std::rewind(file);
+        auto compressed = test_utils::read_file<char>(file);
+        std::fclose(file);
+        TEST_TRUE(res.success);
+        TEST_EQ(res.count, expected.size());
+        TEST_TRUE(inflate_all(compressed, true) == expected);
+    }
+}
+
+void test_gzip_members()
+{
+    // Each call of to_gzip writes an independent gzip member
+    std::FILE* file = std::tmpfile();
+    auto res1 = strf::to_gzip(file)("abc");
+    auto res2 = strf::to_gzip(file)("def");
+    std::rewind(file);
+    auto compressed = test_utils::read_file<char>(file);
+    std::fclose(file);
+    TEST_TRUE(res1.success);
+    TEST_TRUE(res2.success);
+    TEST_EQ(compressed.size(), res1.compressed_size + res2.compressed_size);
+    TEST_TRUE(inflate_all(compressed.substr(0, res1.compressed_size)) == "abc");
+    TEST_TRUE(inflate_all(compressed.substr(res1.compressed_size)) == "def");
+}
+
+void test_reserve()
+{
+    // The reserved size is capped
+    const std::string expected = strf::to_string(strf::multi('x', 300000), 12345);
+    std::FILE* file = std::tmpfile();
+    auto res = strf::to_gzip(file).reserve_calc()(strf::multi('x', 300000), 12345);
+    std::rewind(file);
+    auto compressed = test_utils::read_file<char>(file);
+    std::fclose(file);
+    TEST_TRUE(res.success);
+    TEST_EQ(res.count, expected.size());
+    TEST_TRUE(inflate_all(compressed) == expected);
+}
+
+void test_empty_content()
+{
+    std::FILE* file = std::tmpfile();
+    auto res = strf::to_gzip(file) ("");
+    std::rewind(file);
+    auto compressed = test_utils::read_file<char>(file);
+    std::fclose(file);
+    TEST_TRUE(res.success);
+    TEST_EQ(res.count, 0);
+    TEST_TRUE(res.compressed_size != 0); // header and trailer
+    TEST_TRUE(inflate_all(compressed).empty());
+}
+
+void test_invalid_fd()
+{
+    auto res = strf::to_gzip(-1)(strf::multi('x', 1000));
+    TEST_TRUE(! res.success);
+    TEST_EQ(res.compressed_size, 0);
+}
+
+void test_invalid_level()
+{
+    std::FILE* file = std::tmpfile();
+    auto res = strf::to_gzip(file, 100)("abc");
+    std::fclose(file);
+    TEST_TRUE(! res.success);
+}
+
+int main()
+{
+    std::srand(static_cast<unsigned>(std::time(nullptr)));
+
+    test_successfull_writing<char>();
+    test_successfull_writing<char16_t>();
+    test_successfull_writing<char32_t>();
+    test_successfull_writing<wchar_t>();
+    test_large_content();
+    test_formats();
+    test_gzip_members();
+    test_reserve();
+    test_empty_content();
+    test_invalid_fd();
+    test_invalid_level();
+
+    return test_finish();
+}